@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "WString.h"
+
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+class EspClass {
+ public:
+  uint32_t getCycleCount();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getHeapSize();
+  void restart() {}
+};
+extern EspClass ESP;
+uint32_t getCpuFrequencyMhz();
+bool setCpuFrequencyMhz(uint32_t mhz);
+
+class HWSerial {
+ public:
+  void begin(unsigned long) {}
+  size_t print(const char* s);
+  size_t print(const String& s) { return print(s.c_str()); }
+  size_t print(char c);
+  size_t print(int v);
+  size_t print(unsigned v);
+  size_t print(long v);
+  size_t print(unsigned long v);
+  size_t println(const char* s = "");
+  size_t println(const String& s) { return println(s.c_str()); }
+  size_t println(int v);
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  operator bool() const { return true; }
+};
+extern HWSerial Serial;
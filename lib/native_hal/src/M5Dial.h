@@ -0,0 +1,228 @@
+#pragma once
+// Host-Shim: minimaler Ausschnitt von M5Dial/M5Unified/M5GFX (LovyanGFX) für die native Umgebung
+#include <Arduino.h>
+#include <vector>
+
+#define M5UNIFIED_H 1
+
+#define TFT_BLACK   0x0000
+#define TFT_WHITE   0xFFFF
+#define TFT_SILVER  0xC618
+#define TFT_GREEN   0x07E0
+#define TFT_RED     0xF800
+#define TFT_YELLOW  0xFFE0
+#define TFT_DARKGREY 0x7BEF
+
+namespace lgfx {
+inline namespace v1 {
+
+struct IFont { int height; int advance; };
+namespace fonts {
+extern const IFont Font0, Font2, Font4;
+}
+
+enum textdatum_t : uint8_t {
+  top_left = 0, top_center = 1, top_right = 2,
+  middle_left = 4, middle_center = 5, middle_right = 6,
+  bottom_left = 8, bottom_center = 9, bottom_right = 10,
+};
+
+enum color_depth_t : uint8_t {
+  palette_1bit = 1, palette_2bit = 2, palette_4bit = 4, palette_8bit = 8,
+  rgb332_1Byte = 8 | 0x20, rgb565_2Byte = 16,
+};
+
+// Farb-Konvertierung wie in LovyanGFX: uint32_t = RGB888, sonst RGB565
+inline uint16_t toRGB565(uint32_t c888) {
+  return (uint16_t)(((c888 >> 8) & 0xF800) | ((c888 >> 5) & 0x07E0) | ((c888 >> 3) & 0x001F));
+}
+inline uint16_t convColor(uint32_t c) { return toRGB565(c); }
+inline uint16_t convColor(uint16_t c) { return c; }
+inline uint16_t convColor(int c)      { return (uint16_t)c; }
+inline uint16_t convColor(uint8_t c)  { return (uint16_t)(((c & 0xE0) << 8) | ((c & 0x1C) << 6) | ((c & 0x03) << 3)); }
+
+class LGFXBase {
+ public:
+  virtual ~LGFXBase() {}
+  int32_t width()  const { return _w; }
+  int32_t height() const { return _h; }
+
+  static constexpr uint32_t color888(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+  static constexpr uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)); }
+
+  void setClipRect(int32_t x, int32_t y, int32_t w, int32_t h);
+  void getClipRect(int32_t* x, int32_t* y, int32_t* w, int32_t* h) const { *x = _cx; *y = _cy; *w = _cw; *h = _ch; }
+  void clearClipRect() { _cx = 0; _cy = 0; _cw = _w; _ch = _h; }
+
+  void setTextDatum(textdatum_t d) { _datum = d; }
+  void setTextWrap(bool) {}
+  void setFont(const IFont* f) { _font = f; }
+  template <typename T> void setTextColor(T c) { _textCol = conv(c); }
+  int32_t fontHeight() const { return _font ? _font->height : 8; }
+  int32_t textWidth(const char* s) const { return (int32_t)strlen(s) * (_font ? _font->advance : 6); }
+  size_t drawString(const char* s, int32_t x, int32_t y);
+  size_t drawString(const String& s, int32_t x, int32_t y) { return drawString(s.c_str(), x, y); }
+
+  template <typename T> void fillScreen(T c) { rawFill(0, 0, _w, _h, conv(c)); }
+  template <typename T> void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, T c) { rawFill(x, y, w, h, conv(c)); }
+  template <typename T> void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, T c) { uint16_t k = conv(c); rawFill(x, y, w, 1, k); rawFill(x, y + h - 1, w, 1, k); rawFill(x, y, 1, h, k); rawFill(x + w - 1, y, 1, h, k); }
+  template <typename T> void drawFastHLine(int32_t x, int32_t y, int32_t w, T c) { rawFill(x, y, w, 1, conv(c)); }
+  template <typename T> void drawPixel(int32_t x, int32_t y, T c) { rawFill(x, y, 1, 1, conv(c)); }
+  template <typename T> void fillCircle(int32_t x, int32_t y, int32_t r, T c) { rawCircle(x, y, r, conv(c), true); }
+  template <typename T> void drawCircle(int32_t x, int32_t y, int32_t r, T c) { rawCircle(x, y, r, conv(c), false); }
+  template <typename T> void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, T c) { rawRoundRect(x, y, w, h, r, conv(c), true); }
+  template <typename T> void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, T c) { rawRoundRect(x, y, w, h, r, conv(c), false); }
+  template <typename T> void fillTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, T c) { rawTriangle(x0, y0, x1, y1, x2, y2, conv(c)); }
+  template <typename T> void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, T c) { rawLine(x0, y0, x1, y1, conv(c)); }
+  template <typename T> void drawBitmap(int32_t x, int32_t y, const uint8_t* bmp, int32_t w, int32_t h, T c) { rawBitmap(x, y, bmp, w, h, conv(c)); }
+  void setBrightness(uint8_t b) { _brightness = b; }
+  uint8_t getBrightness() const { return _brightness; }
+
+ protected:
+  // Palette-Sprites: wie LovyanGFX das untere Byte der Farbe als Index
+  template <typename T> uint16_t conv(T c) const { return _indexed ? (uint16_t)((uint32_t)c & 0xFF) : convColor(c); }
+  virtual void plot(int32_t x, int32_t y, uint16_t c565) = 0;
+  void rawFill(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t c);
+  void rawCircle(int32_t x, int32_t y, int32_t r, uint16_t c, bool fill);
+  void rawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint16_t c, bool fill);
+  void rawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint16_t c);
+  void rawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t c);
+  void rawBitmap(int32_t x, int32_t y, const uint8_t* bmp, int32_t w, int32_t h, uint16_t c);
+
+  int32_t _w = 0, _h = 0;
+  int32_t _cx = 0, _cy = 0, _cw = 0, _ch = 0;
+  const IFont* _font = nullptr;
+  textdatum_t _datum = top_left;
+  uint16_t _textCol = 0xFFFF;
+  uint8_t _brightness = 255;
+  bool _indexed = false;
+};
+
+class LGFX_Sprite;
+
+// Panel: hält einen eigenen Framebuffer, zählt übertragene Bytes
+class LGFX_Device : public LGFXBase {
+ public:
+  LGFX_Device() { _w = 240; _h = 240; clearClipRect(); fb.assign(240 * 240, 0); }
+  void startWrite() { ++_writeNest; }
+  void endWrite()   { if (_writeNest) --_writeNest; }
+  void waitDMA() {}
+  bool dmaBusy() const { return false; }
+  void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+  void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) { pushImage(x, y, w, h, data); }
+  void sleep() {}
+  void wakeup() {}
+
+  std::vector<uint16_t> fb;        // RGB565 (Host-Byteorder)
+  uint64_t bytesPushed = 0;
+  uint32_t pushes = 0;
+ protected:
+  void plot(int32_t x, int32_t y, uint16_t c) override { fb[y * _w + x] = c; }
+  int _writeNest = 0;
+  friend class LGFX_Sprite;
+};
+
+class LGFX_Sprite : public LGFXBase {
+ public:
+  LGFX_Sprite() {}
+  explicit LGFX_Sprite(LGFX_Device* parent) : _parent(parent) {}
+  ~LGFX_Sprite() { deleteSprite(); }
+  void setColorDepth(int bits) { _bpp = bits & 0x1F ? (bits & 0x1F) : 16; if (_bpp != 8 && _bpp != 16 && _bpp != 4 && _bpp != 1) _bpp = 16; _indexed = false; }
+  void setColorDepth(color_depth_t d) { setColorDepth((int)d); _indexed = _bpp > 1 && _bpp <= 8 && d != rgb332_1Byte; }
+  uint8_t getColorDepth() const { return _bpp; }
+  void* createSprite(int32_t w, int32_t h);
+  void deleteSprite();
+  void setBuffer(void* buf, int32_t w, int32_t h, color_depth_t bpp = rgb565_2Byte);
+  void* getBuffer() const { return _buf; }
+  bool createPalette();
+  void setPaletteColor(size_t idx, uint32_t c888);
+  template <typename T> void fillSprite(T c) { rawFill(0, 0, _w, _h, convColor(c)); }
+  void pushSprite(int32_t x, int32_t y) { if (_parent) pushSprite(_parent, x, y); }
+  void pushSprite(LGFX_Device* dst, int32_t x, int32_t y);
+  uint16_t readPixel565(int32_t x, int32_t y) const;
+
+ protected:
+  void plot(int32_t x, int32_t y, uint16_t c) override;
+  LGFX_Device* _parent = nullptr;
+  void* _buf = nullptr;
+  bool _owned = false;
+  uint8_t _bpp = 16;
+  uint16_t _palette[256] = {};
+  bool _hasPalette = false;
+};
+
+}  // namespace v1
+}  // namespace lgfx
+
+using namespace lgfx;
+using M5GFX = lgfx::LGFX_Device;
+
+namespace m5 {
+struct touch_detail_t {
+  int16_t x = -1, y = -1;
+  uint8_t state = 0;   // bit0: pressed, bit1: edge
+  bool isPressed()   const { return state & 1; }
+  bool wasPressed()  const { return (state & 3) == 3; }
+  bool wasReleased() const { return (state & 3) == 2; }
+};
+
+class Button_Class {
+ public:
+  bool isPressed()   const { return _now; }
+  bool wasPressed()  const { return _now && !_prev; }
+  bool wasReleased() const { return !_now && _prev && !_holdFired; }
+  bool wasHold()     const { return _holdEdge; }
+  bool wasClicked()  const { return !_now && _prev && !_holdFired; }
+  void setRaw(bool pressed) { _raw = pressed; }
+  void tick(uint32_t ms);
+ private:
+  bool _raw = false, _now = false, _prev = false, _holdEdge = false, _holdFired = false;
+  uint32_t _downMs = 0;
+};
+
+class Encoder_Class {
+ public:
+  int32_t read() const { return _val; }
+  void write(int32_t v) { _val = v; }
+  volatile int32_t _val = 0;
+};
+
+class Touch_Class {
+ public:
+  touch_detail_t getDetail() const { return _detail; }
+  void setRaw(bool pressed, int16_t x, int16_t y) { _rawPressed = pressed; _rawX = x; _rawY = y; }
+  void tick();
+ private:
+  touch_detail_t _detail;
+  bool _rawPressed = false;
+  int16_t _rawX = -1, _rawY = -1;
+};
+
+struct config_t {};
+
+class Power_Class {
+ public:
+  int32_t getBatteryLevel() const { return 72; }
+};
+
+class M5Unified {
+ public:
+  config_t config() const { return config_t{}; }
+  Power_Class Power;
+};
+
+class M5Dial_Class {
+ public:
+  void begin(const config_t&, bool enableEncoder = false, bool enableRFID = false);
+  void update();
+  M5GFX& Display = _display;
+  Encoder_Class Encoder;
+  Button_Class BtnA;
+  Touch_Class Touch;
+ private:
+  M5GFX _display;
+};
+}  // namespace m5
+
+extern m5::M5Unified M5;
+extern m5::M5Dial_Class M5Dial;
@@ -0,0 +1,209 @@
+#pragma once
+// Host-Shim: NimBLE-Arduino 2.x Ausschnitt mit simuliertem OSSM-Peer (zeichnet Writes auf)
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define BLE_ADDR_PUBLIC  0
+#define BLE_ADDR_RANDOM  1
+#define BLE_OWN_ADDR_PUBLIC 0
+#define ESP_PWR_LVL_P9 7
+
+// ---------- NimBLE-Host (C-API, Ausschnitt) ----------
+// Rohe Handle-Writes und GAP-Events wie host/ble_gatt.h / host/ble_gap.h
+struct os_mbuf { const uint8_t* data; uint16_t len; };
+#define OS_MBUF_PKTLEN(om) ((om)->len)
+int os_mbuf_copydata(const os_mbuf* om, int off, int len, void* dst);
+
+#define BLE_GAP_EVENT_NOTIFY_RX 12
+#define BLE_HS_ENOTCONN   7
+#define BLE_HS_ENOMEM     6
+#define BLE_HS_EMSGSIZE   4
+#define BLE_HS_ATT_ERR(x) (0x100 + (x))
+#define BLE_ATT_ERR_INVALID_HANDLE 0x01
+
+struct ble_gap_event {
+  uint8_t type;
+  union {
+    struct {
+      os_mbuf* om;
+      uint16_t conn_handle;
+      uint16_t attr_handle;
+      uint8_t  indication : 1;
+    } notify_rx;
+  };
+};
+typedef int (*gap_event_handler)(ble_gap_event* event, void* arg);
+
+struct ble_gatt_error { uint16_t status; uint16_t att_handle; };
+struct ble_gatt_attr;
+typedef int ble_gatt_attr_fn(uint16_t conn_handle, const ble_gatt_error* error, ble_gatt_attr* attr, void* arg);
+int ble_gattc_write_no_rsp_flat(uint16_t conn_handle, uint16_t attr_handle, const void* data, uint16_t data_len);
+int ble_gattc_write_flat(uint16_t conn_handle, uint16_t attr_handle, const void* data, uint16_t data_len,
+                         ble_gatt_attr_fn* cb, void* cb_arg);
+
+class NimBLEUUID {
+ public:
+  NimBLEUUID() {}
+  NimBLEUUID(const char* s) : _s(s) {}
+  NimBLEUUID(const std::string& s) : _s(s) {}
+  NimBLEUUID(uint16_t u16) { char t[5]; snprintf(t, sizeof t, "%04x", u16); _s = t; }
+  bool equals(const NimBLEUUID& o) const { return _s == o._s; }
+  bool operator==(const NimBLEUUID& o) const { return equals(o); }
+  std::string toString() const { return _s; }
+ private:
+  std::string _s;
+};
+
+class NimBLEAddress {
+ public:
+  NimBLEAddress() {}
+  NimBLEAddress(const std::string& s, uint8_t type);
+  NimBLEAddress(const uint8_t addr[6], uint8_t type) : _type(type) { memcpy(_val, addr, 6); }
+  std::string toString() const;
+  uint8_t getType() const { return _type; }
+  const uint8_t* getVal() const { return _val; }
+  bool isNull() const { static const uint8_t z[6] = {}; return memcmp(_val, z, 6) == 0; }
+  bool operator==(const NimBLEAddress& o) const { return _type == o._type && memcmp(_val, o._val, 6) == 0; }
+ private:
+  uint8_t _val[6] = {};   // little endian wie NimBLE
+  uint8_t _type = BLE_ADDR_PUBLIC;
+};
+
+class NimBLEAdvertisedDevice {
+ public:
+  const std::string& getName() const { return name; }
+  int getRSSI() const { return rssi; }
+  const NimBLEAddress& getAddress() const { return addr; }
+  bool haveServiceUUID() const { return !uuids.empty(); }
+  int getServiceUUIDCount() const { return (int)uuids.size(); }
+  NimBLEUUID getServiceUUID(int i) const { return uuids[i]; }
+  const std::vector<uint8_t>& getPayload() const { return payload; }
+
+  std::string name;
+  int rssi = -60;
+  NimBLEAddress addr;
+  std::vector<NimBLEUUID> uuids;
+  std::vector<uint8_t> payload;
+};
+
+class NimBLEScanCallbacks {
+ public:
+  virtual ~NimBLEScanCallbacks() {}
+  virtual void onResult(const NimBLEAdvertisedDevice*) {}
+  virtual void onScanEnd(const std::vector<NimBLEAdvertisedDevice*>&, int) {}
+};
+
+class NimBLEScan {
+ public:
+  bool isScanning() const { return _running; }
+  bool stop() { _running = false; return true; }
+  void clearResults() {}
+  void setScanCallbacks(NimBLEScanCallbacks* cb, bool = false) { _cb = cb; }
+  void setActiveScan(bool) {}
+  void setDuplicateFilter(uint8_t) {}
+  void setMaxResults(uint8_t) {}
+  void setInterval(uint16_t) {}
+  void setWindow(uint16_t) {}
+  bool start(uint32_t durationMs, bool isContinue = false, bool restart = true);
+  // Sim: liefert ausstehende Advertisements an den Callback (vom Host-"Task")
+  void simDeliver();
+ private:
+  NimBLEScanCallbacks* _cb = nullptr;
+  std::atomic<bool> _running{false};
+};
+
+class NimBLERemoteDescriptor {
+ public:
+  NimBLERemoteDescriptor(const NimBLEUUID& u, uint16_t h) : _uuid(u), _handle(h) {}
+  const NimBLEUUID& getUUID() const { return _uuid; }
+  uint16_t getHandle() const { return _handle; }
+ private:
+  NimBLEUUID _uuid;
+  uint16_t _handle;
+};
+
+class NimBLERemoteCharacteristic;
+using notify_callback = std::function<void(NimBLERemoteCharacteristic*, uint8_t*, size_t, bool)>;
+
+class NimBLERemoteCharacteristic {
+ public:
+  NimBLERemoteCharacteristic(const NimBLEUUID& u, uint16_t h, uint8_t props) : _uuid(u), _handle(h), _props(props),
+                                                                                 _cccd(NimBLEUUID((uint16_t)0x2902), (uint16_t)(h + 1)) {}
+  bool canRead() const { return _props & 0x02; }
+  bool canWriteNoResponse() const { return _props & 0x04; }
+  bool canWrite() const { return _props & 0x08; }
+  bool canNotify() const { return _props & 0x10; }
+  bool canIndicate() const { return _props & 0x20; }
+  bool subscribe(bool notifications = true, notify_callback cb = nullptr, bool response = true);
+  bool unsubscribe(bool = true) { _cb = nullptr; return true; }
+  bool writeValue(const uint8_t* data, size_t len, bool response = false);
+  std::string readValue();
+  const NimBLEUUID& getUUID() const { return _uuid; }
+  uint16_t getHandle() const { return _handle; }
+  NimBLERemoteDescriptor* getDescriptor(const NimBLEUUID& u) { return u == _cccd.getUUID() && canNotify() ? &_cccd : nullptr; }
+  notify_callback _cb;
+ private:
+  NimBLEUUID _uuid;
+  uint16_t _handle;
+  uint8_t _props;
+  NimBLERemoteDescriptor _cccd;   // Client Characteristic Configuration direkt hinter dem Wert
+};
+
+class NimBLERemoteService {
+ public:
+  explicit NimBLERemoteService(const NimBLEUUID& u) : _uuid(u) {}
+  ~NimBLERemoteService() { for (auto* c : _chars) delete c; }
+  NimBLERemoteCharacteristic* getCharacteristic(const NimBLEUUID& u);
+  const std::vector<NimBLERemoteCharacteristic*>& getCharacteristics(bool = false) { return _chars; }
+  const NimBLEUUID& getUUID() const { return _uuid; }
+  std::vector<NimBLERemoteCharacteristic*> _chars;
+ private:
+  NimBLEUUID _uuid;
+};
+
+class NimBLEClient;
+class NimBLEClientCallbacks {
+ public:
+  virtual ~NimBLEClientCallbacks() {}
+  virtual void onConnect(NimBLEClient*) {}
+  virtual void onConnectFail(NimBLEClient*, int) {}
+  virtual void onDisconnect(NimBLEClient*, int) {}
+  virtual void onMTUChange(NimBLEClient*, uint16_t) {}
+};
+
+class NimBLEClient {
+ public:
+  ~NimBLEClient() { for (auto* s : _svcs) delete s; }
+  void setClientCallbacks(NimBLEClientCallbacks* cb, bool = true) { _cb = cb; }
+  void setConnectTimeout(uint32_t ms) { _timeoutMs = ms; }
+  bool connect(const NimBLEAddress& addr, bool deleteAttributes = true, bool asyncConnect = false, bool exchangeMTU = true);
+  bool disconnect(uint8_t = 0x13);
+  bool cancelConnect() { return true; }   // Sim: connect() endet ohnehin nach dem Timeout
+  bool isConnected() const { return _connected; }
+  NimBLERemoteService* getService(const NimBLEUUID& u);
+  uint16_t getMTU() const { return _mtu; }
+  uint16_t getConnHandle() const { return _connected ? 1 : 0xFFFF; }
+  NimBLEAddress getPeerAddress() const { return _peer; }
+  NimBLEClientCallbacks* _cb = nullptr;
+  std::vector<NimBLERemoteService*> _svcs;
+  bool _connected = false;
+  uint16_t _mtu = 23;
+  uint32_t _timeoutMs = 30000;
+  NimBLEAddress _peer;
+};
+
+class NimBLEDevice {
+ public:
+  static bool init(const std::string& name);
+  static bool setOwnAddrType(uint8_t) { return true; }
+  static bool setPower(int) { return true; }
+  static bool setMTU(uint16_t mtu);
+  static uint16_t getMTU();
+  static NimBLEScan* getScan();
+  static NimBLEClient* createClient();
+  static bool deleteClient(NimBLEClient* c);
+  static bool setCustomGapHandler(gap_event_handler handler);
+};
@@ -0,0 +1,21 @@
+#pragma once
+// Host-Shim: Arduino-ESP32 Preferences (NVS) als prozesslokaler Schlüsselspeicher.
+// Überlebt keinen Neustart des Programms – wie ein frisch gelöschtes NVS nach dem Flashen.
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+class Preferences {
+ public:
+  bool   begin(const char* name, bool readOnly = false, const char* partition = nullptr);
+  void   end() { _ns.clear(); }
+  bool   clear();
+  bool   remove(const char* key);
+  size_t putBytes(const char* key, const void* value, size_t len);
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+  bool   isKey(const char* key) { return getBytesLength(key) > 0; }
+ private:
+  std::string _ns;
+  bool _ro = false;
+};
@@ -0,0 +1,78 @@
+#pragma once
+// Host-Shim: Arduino-String. Bewusst wie das Original ohne Small-String-Optimierung –
+// jeder nicht-leere String liegt auf dem Heap, damit die Allokationszählung im
+// Bench dieselben Spitzen zeigt wie auf dem ESP32.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+class String {
+ public:
+  String() {}
+  String(const char* s) { assign(s, s ? strlen(s) : 0); }
+  String(const __FlashStringHelper* s) : String(reinterpret_cast<const char*>(s)) {}
+  String(const std::string& s) { assign(s.data(), s.size()); }
+  String(const String& o) { assign(o._buf, o._len); }
+  String(String&& o) noexcept : _buf(o._buf), _len(o._len), _cap(o._cap) { o._buf = nullptr; o._len = o._cap = 0; }
+  explicit String(char c) { assign(&c, 1); }
+  String(int v)           { char t[12]; assignNum(t, snprintf(t, sizeof t, "%d", v)); }
+  String(unsigned v)      { char t[12]; assignNum(t, snprintf(t, sizeof t, "%u", v)); }
+  String(long v)          { char t[24]; assignNum(t, snprintf(t, sizeof t, "%ld", v)); }
+  String(unsigned long v) { char t[24]; assignNum(t, snprintf(t, sizeof t, "%lu", v)); }
+  ~String() { delete[] _buf; }
+
+  String& operator=(const String& o) { if (this != &o) assign(o._buf, o._len); return *this; }
+  String& operator=(String&& o) noexcept {
+    if (this != &o) { delete[] _buf; _buf = o._buf; _len = o._len; _cap = o._cap; o._buf = nullptr; o._len = o._cap = 0; }
+    return *this;
+  }
+  String& operator=(const char* s) { assign(s, s ? strlen(s) : 0); return *this; }
+
+  const char* c_str() const { return _buf ? _buf : ""; }
+  unsigned length() const { return (unsigned)_len; }
+  int indexOf(const char* n) const { const char* p = strstr(c_str(), n); return p ? (int)(p - c_str()) : -1; }
+  int indexOf(const String& n) const { return indexOf(n.c_str()); }
+  bool operator==(const String& o) const { return _len == o._len && memcmp(c_str(), o.c_str(), _len) == 0; }
+  bool operator!=(const String& o) const { return !(*this == o); }
+  char operator[](unsigned i) const { return i < _len ? _buf[i] : 0; }
+
+  String& concat(const char* s, size_t n) {
+    if (!n) return *this;
+    reserve(_len + n);
+    memcpy(_buf + _len, s, n);
+    _len += n; _buf[_len] = '\0';
+    return *this;
+  }
+  String& operator+=(const String& o) { return concat(o.c_str(), o._len); }
+  String& operator+=(const char* s)   { return concat(s, strlen(s)); }
+  String& operator+=(int v)           { return *this += String(v); }
+
+  friend String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const char* b)   { String r(a); r += b; return r; }
+  friend String operator+(const String& a, const __FlashStringHelper* b) { String r(a); r += reinterpret_cast<const char*>(b); return r; }
+  friend String operator+(const String& a, int b)           { String r(a); r += b; return r; }
+
+ private:
+  void reserve(size_t n) {
+    if (n < _cap) return;
+    size_t cap = n + 1 + (n >> 1);
+    char* nb = new char[cap];
+    if (_len) memcpy(nb, _buf, _len);
+    nb[_len] = '\0';
+    delete[] _buf;
+    _buf = nb; _cap = cap;
+  }
+  void assignNum(const char* t, int n) { assign(t, n > 0 ? (size_t)n : 0); }
+  void assign(const char* s, size_t n) {
+    if (!n) { if (_buf) { _buf[0] = '\0'; } _len = 0; return; }
+    if (n >= _cap) { delete[] _buf; _buf = new char[n + 1]; _cap = n + 1; }
+    memcpy(_buf, s, n);
+    _buf[n] = '\0'; _len = n;
+  }
+  char*  _buf = nullptr;
+  size_t _len = 0, _cap = 0;
+};
@@ -0,0 +1,117 @@
+// Host-Shim: Zeit, Serial, ESP, Heap-Zählung
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <stdarg.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <thread>
+#include "sim_hal.h"
+
+// ---------- Zeit ----------
+static const auto s_t0 = std::chrono::steady_clock::now();
+
+static uint64_t nowUs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - s_t0).count();
+}
+
+uint32_t millis() { return (uint32_t)(nowUs() / 1000); }
+uint32_t micros() { return (uint32_t)nowUs(); }
+void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+// ---------- CPU ----------
+static std::atomic<uint32_t> s_cpuMhz{240};
+
+uint32_t getCpuFrequencyMhz() { return s_cpuMhz.load(); }
+bool setCpuFrequencyMhz(uint32_t mhz) {
+  if (mhz != 240 && mhz != 160 && mhz != 80 && mhz != 40) return false;
+  s_cpuMhz.store(mhz);
+  return true;
+}
+
+// ---------- Heap-Zählung ----------
+// Zählt alle C++-Allokationen (auch die aus String) und heap_caps_malloc;
+// malloc() selbst bleibt ungezählt (nutzt nur der Host-Unterbau).
+// allocs/frees/bytes nur auf Threads mit allocCountThisThread() (loop()), sonst zählten
+// simuliertes OSSM und NimBLE-Shim mit; live gilt prozessweit (Heap-Modell).
+static std::atomic<uint64_t> s_allocs{0}, s_frees{0}, s_allocBytes{0};
+static std::atomic<int64_t>  s_live{0};
+static thread_local bool     t_counted = false;
+#ifndef SIM_HEAP_KB
+#define SIM_HEAP_KB 320   // freier interner Heap eines ESP32-S3 nach BLE-Init, grob
+#endif
+static constexpr uint32_t kSimHeapSize = SIM_HEAP_KB * 1024;
+
+static void* countedAlloc(size_t n) {
+  void* p = malloc(n + 16);
+  if (!p) return nullptr;
+  *(size_t*)p = n;
+  if (t_counted) {
+    s_allocs.fetch_add(1, std::memory_order_relaxed);
+    s_allocBytes.fetch_add(n, std::memory_order_relaxed);
+  }
+  s_live.fetch_add((int64_t)n, std::memory_order_relaxed);
+  return (uint8_t*)p + 16;
+}
+static void countedFree(void* p) {
+  if (!p) return;
+  uint8_t* b = (uint8_t*)p - 16;
+  if (t_counted) s_frees.fetch_add(1, std::memory_order_relaxed);
+  s_live.fetch_sub((int64_t)*(size_t*)b, std::memory_order_relaxed);
+  free(b);
+}
+
+void* operator new(size_t n)   { if (void* p = countedAlloc(n)) return p; throw std::bad_alloc(); }
+void* operator new[](size_t n) { if (void* p = countedAlloc(n)) return p; throw std::bad_alloc(); }
+void* operator new(size_t n, const std::nothrow_t&) noexcept   { return countedAlloc(n); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return countedAlloc(n); }
+void operator delete(void* p) noexcept           { countedFree(p); }
+void operator delete[](void* p) noexcept         { countedFree(p); }
+void operator delete(void* p, size_t) noexcept   { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+void* heap_caps_malloc(size_t size, uint32_t) {
+  if ((int64_t)size > (int64_t)kSimHeapSize - s_live.load()) return nullptr;
+  return countedAlloc(size);
+}
+void heap_caps_free(void* p) { countedFree(p); }
+size_t heap_caps_get_free_size(uint32_t) {
+  const int64_t f = (int64_t)kSimHeapSize - s_live.load();
+  return f > 0 ? (size_t)f : 0;
+}
+size_t heap_caps_get_largest_free_block(uint32_t caps) { return heap_caps_get_free_size(caps); }
+
+namespace sim {
+void allocCountThisThread() { t_counted = true; }
+AllocStats allocStats() {
+  return AllocStats{ s_allocs.load(), s_frees.load(), s_allocBytes.load(), s_live.load() };
+}
+}
+
+// ---------- ESP ----------
+EspClass ESP;
+
+// Zyklen aus der Wanduhr hochgerechnet – passt zur Umrechnung in perf.cpp
+uint32_t EspClass::getCycleCount() { return (uint32_t)(nowUs() * getCpuFrequencyMhz()); }
+uint32_t EspClass::getFreeHeap()    { return (uint32_t)heap_caps_get_free_size(MALLOC_CAP_DEFAULT); }
+uint32_t EspClass::getMinFreeHeap() { return getFreeHeap(); }
+uint32_t EspClass::getHeapSize()    { return kSimHeapSize; }
+
+// ---------- Serial ----------
+HWSerial Serial;
+
+size_t HWSerial::print(const char* s)     { fputs(s, stdout); return strlen(s); }
+size_t HWSerial::print(char c)            { fputc(c, stdout); return 1; }
+size_t HWSerial::print(int v)             { return (size_t)printf("%d", v); }
+size_t HWSerial::print(unsigned v)        { return (size_t)printf("%u", v); }
+size_t HWSerial::print(long v)            { return (size_t)printf("%ld", v); }
+size_t HWSerial::print(unsigned long v)   { return (size_t)printf("%lu", v); }
+size_t HWSerial::println(const char* s)   { size_t n = print(s); fputc('\n', stdout); return n + 1; }
+size_t HWSerial::println(int v)           { size_t n = print(v); fputc('\n', stdout); return n + 1; }
+size_t HWSerial::printf(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vprintf(fmt, ap);
+  va_end(ap);
+  return n > 0 ? (size_t)n : 0;
+}
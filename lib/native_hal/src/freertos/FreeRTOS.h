@@ -0,0 +1,32 @@
+#pragma once
+// Host-Shim: FreeRTOS-Ausschnitt auf std::thread/std::mutex
+#include <stdint.h>
+#include <atomic>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portTICK_PERIOD_MS 1
+#define portMAX_DELAY 0xFFFFFFFFu
+#define pdPASS 1
+#define pdTRUE 1
+#define pdFALSE 0
+#define tskNO_AFFINITY 0x7FFFFFFF
+#ifndef PRO_CPU_NUM
+#define PRO_CPU_NUM 0
+#endif
+#ifndef APP_CPU_NUM
+#define APP_CPU_NUM 1
+#endif
+
+struct portMUX_TYPE { std::atomic_flag f = ATOMIC_FLAG_INIT; };
+#define portMUX_INITIALIZER_UNLOCKED {}
+inline void vPortEnterCritical(portMUX_TYPE* m) { while (m->f.test_and_set(std::memory_order_acquire)) {} }
+inline void vPortExitCritical(portMUX_TYPE* m)  { m->f.clear(std::memory_order_release); }
+#define portENTER_CRITICAL(m) vPortEnterCritical(m)
+#define portEXIT_CRITICAL(m)  vPortExitCritical(m)
+#define taskENTER_CRITICAL(m) vPortEnterCritical(m)
+#define taskEXIT_CRITICAL(m)  vPortExitCritical(m)
+#define portENTER_CRITICAL_ISR(m) vPortEnterCritical(m)
+#define portEXIT_CRITICAL_ISR(m)  vPortExitCritical(m)
@@ -0,0 +1,78 @@
+// Host-Shim: FreeRTOS-Tasks auf std::thread
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <Arduino.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Task-Kontrollblock: Notify-Zähler + Löschwunsch. Ein fremdes vTaskDelete() kann einen
+// std::thread nicht abbrechen – der Task beendet sich am nächsten Blockierpunkt
+// (vTaskDelay / ulTaskNotifyTake), was für die Schleifen im Projekt genügt.
+struct tskTaskControlBlock {
+  std::mutex m;
+  std::condition_variable cv;
+  uint32_t notify = 0;
+  std::atomic<bool> kill{false};
+};
+
+namespace {
+struct TaskExit {};
+thread_local tskTaskControlBlock* t_self = nullptr;
+
+void checkKill() {
+  if (t_self && t_self->kill.load()) throw TaskExit{};
+}
+}  // namespace
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char*, uint32_t, void* param,
+                                   UBaseType_t, TaskHandle_t* out, BaseType_t) {
+  auto* tcb = new tskTaskControlBlock();   // lebt bis Programmende (Handles bleiben gültig)
+  if (out) *out = tcb;
+  std::thread([fn, param, tcb] {
+    t_self = tcb;
+    try { fn(param); } catch (const TaskExit&) {}
+  }).detach();
+  return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t t) {
+  if (!t || t == t_self) throw TaskExit{};
+  t->kill.store(true);
+  t->cv.notify_all();
+}
+
+void vTaskDelay(TickType_t ticks) {
+  checkKill();
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+  checkKill();
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)(millis() / portTICK_PERIOD_MS); }
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticks) {
+  tskTaskControlBlock* self = t_self;
+  if (!self) { delay(ticks); return 0; }
+  std::unique_lock<std::mutex> lk(self->m);
+  self->cv.wait_for(lk, std::chrono::milliseconds(ticks * portTICK_PERIOD_MS),
+                    [self] { return self->notify > 0 || self->kill.load(); });
+  checkKill();
+  const uint32_t v = self->notify;
+  if (clearOnExit) self->notify = 0;
+  else if (v) self->notify--;
+  return v;
+}
+
+// auch für den Haupt-Thread (loop): Kontrollblock beim ersten Aufruf anlegen
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  if (!t_self) t_self = new tskTaskControlBlock();
+  return t_self;
+}
+
+void xTaskNotifyGive(TaskHandle_t t) {
+  if (!t) return;
+  { std::lock_guard<std::mutex> lk(t->m); t->notify++; }
+  t->cv.notify_one();
+}
@@ -0,0 +1,195 @@
+// Host-Shim: Software-Rasterizer für LGFXBase/LGFX_Sprite/Panel
+#include <M5Dial.h>
+#include <stdlib.h>
+
+namespace lgfx {
+inline namespace v1 {
+
+namespace fonts {
+const IFont Font0 = { 8, 6 };
+const IFont Font2 = { 16, 8 };
+const IFont Font4 = { 26, 14 };
+}
+
+void LGFXBase::setClipRect(int32_t x, int32_t y, int32_t w, int32_t h) {
+  int32_t x1 = std::min(_w, x + w), y1 = std::min(_h, y + h);
+  _cx = std::max<int32_t>(0, x); _cy = std::max<int32_t>(0, y);
+  _cw = std::max<int32_t>(0, x1 - _cx); _ch = std::max<int32_t>(0, y1 - _cy);
+}
+
+void LGFXBase::rawFill(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t c) {
+  int32_t x0 = std::max(x, _cx), y0 = std::max(y, _cy);
+  int32_t x1 = std::min(x + w, _cx + _cw), y1 = std::min(y + h, _cy + _ch);
+  for (int32_t yy = y0; yy < y1; ++yy)
+    for (int32_t xx = x0; xx < x1; ++xx) plot(xx, yy, c);
+}
+
+void LGFXBase::rawCircle(int32_t x, int32_t y, int32_t r, uint16_t c, bool fill) {
+  for (int32_t dy = -r; dy <= r; ++dy)
+    for (int32_t dx = -r; dx <= r; ++dx) {
+      int32_t d2 = dx * dx + dy * dy;
+      if (d2 > r * r) continue;
+      if (!fill && d2 < (r - 1) * (r - 1)) continue;
+      rawFill(x + dx, y + dy, 1, 1, c);
+    }
+}
+
+void LGFXBase::rawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint16_t c, bool fill) {
+  r = std::min(r, std::min(w, h) / 2);
+  for (int32_t yy = 0; yy < h; ++yy)
+    for (int32_t xx = 0; xx < w; ++xx) {
+      int32_t ex = xx < r ? r - xx : (xx >= w - r ? xx - (w - r - 1) : 0);
+      int32_t ey = yy < r ? r - yy : (yy >= h - r ? yy - (h - r - 1) : 0);
+      int32_t d2 = ex * ex + ey * ey;
+      if (d2 > r * r) continue;
+      bool edge = xx == 0 || yy == 0 || xx == w - 1 || yy == h - 1 || (ex && ey && d2 > (r - 1) * (r - 1));
+      if (fill || edge) rawFill(x + xx, y + yy, 1, 1, c);
+    }
+}
+
+void LGFXBase::rawTriangle(int32_t x0, int32_t y0, int32_t x1, int32_t y1, int32_t x2, int32_t y2, uint16_t c) {
+  int32_t minx = std::min({ x0, x1, x2 }), maxx = std::max({ x0, x1, x2 });
+  int32_t miny = std::min({ y0, y1, y2 }), maxy = std::max({ y0, y1, y2 });
+  auto edge = [](int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t px, int32_t py) {
+    return (int64_t)(bx - ax) * (py - ay) - (int64_t)(by - ay) * (px - ax);
+  };
+  int64_t area = edge(x0, y0, x1, y1, x2, y2);
+  if (area == 0) { rawLine(x0, y0, x1, y1, c); rawLine(x1, y1, x2, y2, c); return; }
+  for (int32_t y = miny; y <= maxy; ++y)
+    for (int32_t x = minx; x <= maxx; ++x) {
+      int64_t w0 = edge(x1, y1, x2, y2, x, y), w1 = edge(x2, y2, x0, y0, x, y), w2 = edge(x0, y0, x1, y1, x, y);
+      if (area < 0) { w0 = -w0; w1 = -w1; w2 = -w2; }
+      if (w0 >= 0 && w1 >= 0 && w2 >= 0) rawFill(x, y, 1, 1, c);
+    }
+}
+
+void LGFXBase::rawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint16_t c) {
+  int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int32_t err = dx + dy;
+  for (;;) {
+    rawFill(x0, y0, 1, 1, c);
+    if (x0 == x1 && y0 == y1) break;
+    int32_t e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+void LGFXBase::rawBitmap(int32_t x, int32_t y, const uint8_t* bmp, int32_t w, int32_t h, uint16_t c) {
+  const int32_t bw = (w + 7) / 8;
+  for (int32_t yy = 0; yy < h; ++yy)
+    for (int32_t xx = 0; xx < w; ++xx)
+      if (bmp[yy * bw + xx / 8] & (0x80 >> (xx & 7))) rawFill(x + xx, y + yy, 1, 1, c);
+}
+
+// Ersatz-Glyphen: 5x7-Block-Muster aus dem Zeichencode, damit Text Pixel erzeugt
+size_t LGFXBase::drawString(const char* s, int32_t x, int32_t y) {
+  const int32_t adv = _font ? _font->advance : 6;
+  const int32_t fh  = fontHeight();
+  const int32_t tw  = textWidth(s);
+  int32_t ox = x, oy = y;
+  switch (_datum & 3) { case 1: ox -= tw / 2; break; case 2: ox -= tw; break; default: break; }
+  switch (_datum & 12) { case 4: oy -= fh / 2; break; case 8: oy -= fh; break; default: break; }
+  for (const char* p = s; *p; ++p, ox += adv) {
+    const uint8_t ch = (uint8_t)*p;
+    if (ch == ' ') continue;
+    for (int gy = 0; gy < 7; ++gy)
+      for (int gx = 0; gx < 5; ++gx)
+        if (((ch * 2654435761u) >> ((gy * 5 + gx) % 31)) & 1)
+          rawFill(ox + 1 + gx * (adv - 2) / 5, oy + 2 + gy * (fh - 4) / 7, std::max(1, (adv - 2) / 5), std::max(1, (fh - 4) / 7), _textCol);
+  }
+  return strlen(s);
+}
+
+// ---------- Panel ----------
+void LGFX_Device::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+  // Quelle: RGB565 byte-getauscht wie im Sprite-Puffer; Clip-Rect des Panels gilt
+  int32_t x0 = std::max(x, _cx), y0 = std::max(y, _cy);
+  int32_t x1 = std::min(x + w, _cx + _cw), y1 = std::min(y + h, _cy + _ch);
+  if (x0 >= x1 || y0 >= y1) return;
+  for (int32_t yy = y0; yy < y1; ++yy)
+    for (int32_t xx = x0; xx < x1; ++xx) {
+      uint16_t v = data[(yy - y) * w + (xx - x)];
+      fb[yy * _w + xx] = (uint16_t)((v << 8) | (v >> 8));
+    }
+  bytesPushed += (uint64_t)(x1 - x0) * (y1 - y0) * 2;
+  ++pushes;
+}
+
+// ---------- Sprite ----------
+void* LGFX_Sprite::createSprite(int32_t w, int32_t h) {
+  deleteSprite();
+  size_t bytes = ((size_t)w * h * _bpp + 7) / 8;
+  _buf = calloc(1, bytes);
+  if (!_buf) return nullptr;
+  _owned = true;
+  _w = w; _h = h;
+  clearClipRect();
+  return _buf;
+}
+
+void LGFX_Sprite::deleteSprite() {
+  if (_owned) free(_buf);
+  _buf = nullptr; _owned = false; _w = _h = 0;
+}
+
+void LGFX_Sprite::setBuffer(void* buf, int32_t w, int32_t h, color_depth_t bpp) {
+  deleteSprite();
+  _bpp = (uint8_t)(bpp & 0x1F) ? (uint8_t)(bpp & 0x1F) : 16;
+  _indexed = _bpp > 1 && _bpp <= 8 && !(bpp & 0x20);
+  _buf = buf; _w = w; _h = h;
+  clearClipRect();
+}
+
+bool LGFX_Sprite::createPalette() { _hasPalette = true; for (int i = 0; i < 256; ++i) _palette[i] = 0; return true; }
+void LGFX_Sprite::setPaletteColor(size_t idx, uint32_t c888) { if (idx < 256) _palette[idx] = toRGB565(c888); }
+
+void LGFX_Sprite::plot(int32_t x, int32_t y, uint16_t c) {
+  if (!_buf) return;
+  if (_bpp == 16) {
+    ((uint16_t*)_buf)[y * _w + x] = (uint16_t)((c << 8) | (c >> 8));
+  } else if (_bpp == 8) {
+    // Palette: nächster Eintrag; ohne Palette RGB332
+    uint8_t v;
+    if (_indexed) {
+      v = (uint8_t)c;   // Index (siehe conv)
+    } else if (_hasPalette) {
+      int best = 0, bd = 1 << 30;
+      for (int i = 0; i < 256; ++i) {
+        int dr = ((_palette[i] >> 11) & 31) - ((c >> 11) & 31), dg = ((_palette[i] >> 5) & 63) - ((c >> 5) & 63), db = (_palette[i] & 31) - (c & 31);
+        int dd = dr * dr * 4 + dg * dg + db * db * 4;
+        if (dd < bd) { bd = dd; best = i; if (!dd) break; }
+      }
+      v = (uint8_t)best;
+    } else {
+      v = (uint8_t)(((c >> 8) & 0xE0) | ((c >> 6) & 0x1C) | ((c >> 3) & 0x03));
+    }
+    ((uint8_t*)_buf)[y * _w + x] = v;
+  } else if (_bpp == 1) {
+    uint8_t* p = (uint8_t*)_buf + y * ((_w + 7) / 8) + x / 8;
+    if (c) *p |= (0x80 >> (x & 7)); else *p &= ~(0x80 >> (x & 7));
+  }
+}
+
+uint16_t LGFX_Sprite::readPixel565(int32_t x, int32_t y) const {
+  if (!_buf || x < 0 || y < 0 || x >= _w || y >= _h) return 0;
+  if (_bpp == 16) { uint16_t v = ((uint16_t*)_buf)[y * _w + x]; return (uint16_t)((v << 8) | (v >> 8)); }
+  if (_bpp == 8) {
+    uint8_t v = ((uint8_t*)_buf)[y * _w + x];
+    return _hasPalette ? _palette[v] : convColor(v);
+  }
+  return 0;
+}
+
+void LGFX_Sprite::pushSprite(LGFX_Device* dst, int32_t x, int32_t y) {
+  if (!_buf || !dst) return;
+  if (_bpp == 16) { dst->pushImage(x, y, _w, _h, (const uint16_t*)_buf); return; }
+  std::vector<uint16_t> tmp((size_t)_w * _h);
+  for (int32_t yy = 0; yy < _h; ++yy)
+    for (int32_t xx = 0; xx < _w; ++xx) { uint16_t c = readPixel565(xx, yy); tmp[yy * _w + xx] = (uint16_t)((c << 8) | (c >> 8)); }
+  dst->pushImage(x, y, _w, _h, tmp.data());
+}
+
+}  // namespace v1
+}  // namespace lgfx
@@ -0,0 +1,65 @@
+// Host-Shim: M5Dial-Objekte mit skriptbaren Eingaben
+#include <M5Dial.h>
+#include <mutex>
+#include "sim_hal.h"
+
+m5::M5Unified M5;
+m5::M5Dial_Class M5Dial;
+
+namespace {
+// Rohzustand, vom Szenario gesetzt, vom Sampler-Task über update() übernommen
+std::mutex s_inMtx;
+int32_t s_encPending = 0;
+bool    s_btn = false;
+bool    s_touch = false;
+int16_t s_tx = -1, s_ty = -1;
+
+constexpr uint32_t kHoldMs = 500;   // M5Unified-Default für wasHold()
+}  // namespace
+
+namespace sim {
+void encoderAdd(int32_t counts) { std::lock_guard<std::mutex> lk(s_inMtx); s_encPending += counts; }
+void button(bool pressed)       { std::lock_guard<std::mutex> lk(s_inMtx); s_btn = pressed; }
+void touch(bool pressed, int16_t x, int16_t y) {
+  std::lock_guard<std::mutex> lk(s_inMtx);
+  s_touch = pressed;
+  if (pressed) { s_tx = x; s_ty = y; }
+}
+}  // namespace sim
+
+namespace m5 {
+
+void Button_Class::tick(uint32_t ms) {
+  _prev = _now;
+  _now = _raw;
+  _holdEdge = false;
+  if (_now && !_prev) { _downMs = ms; _holdFired = false; }
+  if (_now && !_holdFired && ms - _downMs >= kHoldMs) { _holdFired = true; _holdEdge = true; }
+  // Klick-Flanke (Loslassen ohne Hold) gilt genau einen update()-Zyklus
+  if (!_now && !_prev) _holdFired = false;
+}
+
+void Touch_Class::tick() {
+  const bool was = _detail.isPressed();
+  _detail.state = (uint8_t)((_rawPressed ? 1 : 0) | (was != _rawPressed ? 2 : 0));
+  if (_rawPressed) { _detail.x = _rawX; _detail.y = _rawY; }
+}
+
+void M5Dial_Class::begin(const config_t&, bool, bool) {
+  _display.clearClipRect();
+  _display.setBrightness(255);
+}
+
+void M5Dial_Class::update() {
+  {
+    std::lock_guard<std::mutex> lk(s_inMtx);
+    Encoder._val = Encoder._val + s_encPending;
+    s_encPending = 0;
+    BtnA.setRaw(s_btn);
+    Touch.setRaw(s_touch, s_tx, s_ty);
+  }
+  BtnA.tick(millis());
+  Touch.tick();
+}
+
+}  // namespace m5
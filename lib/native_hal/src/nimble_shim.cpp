@@ -0,0 +1,328 @@
+// Host-Shim: NimBLE mit einem simulierten OSSM als Gegenstelle.
+// Scan liefert zyklisch ein echtes Advertisement-Payload (Flags, Name, 128-bit-UUID),
+// connect()/getService() blockieren wie im Original, Writes werden gezählt und
+// Write-without-Response pro Connection-Event begrenzt. Rohe Handle-Writes
+// (ble_gattc_write_*) und NOTIFY_RX über den Custom-GAP-Handler wie im NimBLE-Host.
+#include <NimBLEDevice.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include "sim_hal.h"
+
+namespace {
+
+const char* kSvcUuid  = "e5560000-6a2d-436f-a43d-82eab88dcefd";
+const char* kCtrlUuid = "e5560001-6a2d-436f-a43d-82eab88dcefd";
+const uint8_t kPeerAddr[6] = { 0x3a, 0x52, 0xa1, 0x0b, 0x4c, 0x24 };   // LE → "24:4c:0b:a1:52:3a"
+
+sim::PeerConfig s_peer;
+std::mutex s_mtx;                       // Peer-Zustand, Clients, Statistik
+uint16_t s_localMtu = 23;
+std::vector<NimBLEClient*> s_clients;
+sim::WireStats s_wire{};
+
+// Write-without-Response: Guthaben pro Connection-Event
+uint32_t s_ceStartMs = 0;
+uint8_t  s_ceUsed = 0;
+
+gap_event_handler s_gapHandler = nullptr;
+bool s_rawSubscribed = false;           // CCCD per Handle-Write gesetzt (ohne Discovery)
+
+void sleepMs(uint32_t ms) { if (ms) std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+std::vector<uint8_t> buildAdvPayload() {
+  std::vector<uint8_t> p = { 0x02, 0x01, 0x06,                 // Flags
+                             0x05, 0x09, 'O', 'S', 'S', 'M',   // Complete Local Name
+                             0x11, 0x07 };                     // Complete List of 128-bit UUIDs
+  // UUID-Bytes im Payload little-endian
+  static const uint8_t uuidLE[16] = { 0xfd, 0xce, 0x8d, 0xb8, 0xea, 0x82, 0x3d, 0xa4,
+                                      0x6f, 0x43, 0x2d, 0x6a, 0x00, 0x00, 0x56, 0xe5 };
+  p.insert(p.end(), uuidLE, uuidLE + 16);
+  return p;
+}
+
+NimBLEScan s_scan;
+std::atomic<uint32_t> s_scanGen{0};
+
+NimBLEClient* connectedClient(uint16_t connHandle) {
+  for (auto* cl : s_clients) if (cl->_connected && cl->getConnHandle() == connHandle) return cl;
+  return nullptr;
+}
+
+// Ein Write auf den Wert der Control-Char (unter s_mtx). 0 = ok, sonst BLE_HS_*
+int wireWriteLocked(NimBLEClient* c, size_t len, bool response, uint32_t& rspMs) {
+  if (!c || !c->_connected) { s_wire.rejected++; return BLE_HS_ENOTCONN; }
+  if (!response) {
+    // ohne Response: muss in ein ATT-Paket passen und braucht freies Guthaben im Conn-Event
+    if (len + 3 > c->_mtu) { s_wire.rejected++; return BLE_HS_EMSGSIZE; }
+    const uint32_t now = millis();
+    if (now - s_ceStartMs >= s_peer.connIntervalMs) { s_ceStartMs = now; s_ceUsed = 0; }
+    if (s_ceUsed >= s_peer.pktsPerEvent) { s_wire.rejected++; return BLE_HS_ENOMEM; }
+    s_ceUsed++;
+  } else {
+    if (len > 512) { s_wire.rejected++; return BLE_HS_EMSGSIZE; }
+    s_wire.writesRsp++;
+    rspMs = s_peer.writeRspMs;
+  }
+  s_wire.writes++;
+  s_wire.bytes += len;
+  return 0;
+}
+
+}  // namespace
+
+// ---------- Adresse ----------
+NimBLEAddress::NimBLEAddress(const std::string& s, uint8_t type) : _type(type) {
+  unsigned b[6] = {};
+  if (sscanf(s.c_str(), "%x:%x:%x:%x:%x:%x", &b[0], &b[1], &b[2], &b[3], &b[4], &b[5]) == 6)
+    for (int i = 0; i < 6; ++i) _val[i] = (uint8_t)b[5 - i];
+}
+
+std::string NimBLEAddress::toString() const {
+  char t[18];
+  snprintf(t, sizeof t, "%02x:%02x:%02x:%02x:%02x:%02x", _val[5], _val[4], _val[3], _val[2], _val[1], _val[0]);
+  return t;
+}
+
+// ---------- Scan ----------
+bool NimBLEScan::start(uint32_t durationMs, bool, bool) {
+  if (_running) return true;
+  _running = true;
+  const uint32_t gen = ++s_scanGen;
+  // "Host-Task": liefert das Advertisement des Peers im Advertising-Intervall
+  std::thread([this, gen, durationMs] {
+    NimBLEAdvertisedDevice adv;
+    adv.name = "OSSM";
+    adv.addr = NimBLEAddress(kPeerAddr, BLE_ADDR_PUBLIC);
+    adv.uuids.push_back(NimBLEUUID(kSvcUuid));
+    adv.payload = buildAdvPayload();
+    const uint32_t t0 = millis();
+    while (_running && s_scanGen.load() == gen) {
+      uint32_t iv;
+      bool show;
+      { std::lock_guard<std::mutex> lk(s_mtx); iv = s_peer.advIntervalMs; show = s_peer.advertise; adv.rssi = s_peer.rssi; }
+      sleepMs(iv);
+      if (!_running || s_scanGen.load() != gen) break;
+      if (durationMs && millis() - t0 >= durationMs) { _running = false; break; }
+      if (show && _cb) _cb->onResult(&adv);
+    }
+  }).detach();
+  return true;
+}
+
+void NimBLEScan::simDeliver() {}
+
+// ---------- Characteristic ----------
+bool NimBLERemoteCharacteristic::subscribe(bool, notify_callback cb, bool) {
+  std::lock_guard<std::mutex> lk(s_mtx);
+  _cb = cb;
+  return true;
+}
+
+bool NimBLERemoteCharacteristic::writeValue(const uint8_t* data, size_t len, bool response) {
+  NimBLEClient* c = nullptr;
+  std::function<void(const uint8_t*, size_t, bool)> hook;
+  uint32_t rspMs = 0;
+  {
+    std::lock_guard<std::mutex> lk(s_mtx);
+    for (auto* cl : s_clients)
+      for (auto* s : cl->_svcs)
+        for (auto* ch : s->_chars)
+          if (ch == this) c = cl;
+    if (wireWriteLocked(c, len, response, rspMs) != 0) return false;
+    hook = s_peer.onWrite;
+  }
+  if (hook) hook(data, len, response);
+  sleepMs(rspMs);          // mit Response: blockiert bis zur Bestätigung
+  return true;
+}
+
+std::string NimBLERemoteCharacteristic::readValue() { return std::string(); }
+
+// ---------- Service ----------
+NimBLERemoteCharacteristic* NimBLERemoteService::getCharacteristic(const NimBLEUUID& u) {
+  for (auto* c : _chars) if (c->getUUID() == u) return c;
+  return nullptr;
+}
+
+// ---------- Client ----------
+bool NimBLEClient::connect(const NimBLEAddress& addr, bool deleteAttributes, bool, bool exchangeMTU) {
+  uint32_t connMs, peerMtu;
+  bool present;
+  {
+    std::lock_guard<std::mutex> lk(s_mtx);
+    connMs = s_peer.connectMs; peerMtu = s_peer.peerMtu; present = s_peer.advertise;
+  }
+  if (!present || !(addr == NimBLEAddress(kPeerAddr, BLE_ADDR_PUBLIC))) {
+    sleepMs(_timeoutMs);   // Gegenstelle antwortet nicht: erst der Connect-Timeout bricht ab
+    if (_cb) _cb->onConnectFail(this, 0x0d);
+    return false;
+  }
+  sleepMs(connMs);
+  {
+    std::lock_guard<std::mutex> lk(s_mtx);
+    if (deleteAttributes) { for (auto* s : _svcs) delete s; _svcs.clear(); }
+    _peer = addr;
+    _connected = true;
+    _mtu = 23;
+    s_rawSubscribed = false;
+  }
+  if (_cb) _cb->onConnect(this);
+  if (exchangeMTU && s_localMtu > 23) {
+    _mtu = (uint16_t)std::min<uint32_t>(s_localMtu, peerMtu);
+    if (_cb) _cb->onMTUChange(this, _mtu);
+  }
+  return true;
+}
+
+bool NimBLEClient::disconnect(uint8_t reason) {
+  {
+    std::lock_guard<std::mutex> lk(s_mtx);
+    if (!_connected) return false;
+    _connected = false;
+    s_rawSubscribed = false;
+  }
+  if (_cb) _cb->onDisconnect(this, reason);
+  return true;
+}
+
+NimBLERemoteService* NimBLEClient::getService(const NimBLEUUID& u) {
+  if (!_connected) return nullptr;
+  for (auto* s : _svcs) if (s->getUUID() == u) return s;
+  uint32_t discMs;
+  uint16_t handle;
+  { std::lock_guard<std::mutex> lk(s_mtx); discMs = s_peer.discoverMs; handle = s_peer.ctrlHandle; }
+  sleepMs(discMs);
+  if (!(u == NimBLEUUID(kSvcUuid))) return nullptr;
+  auto* s = new NimBLERemoteService(u);
+  // read | writeNoRsp | write | notify
+  s->_chars.push_back(new NimBLERemoteCharacteristic(NimBLEUUID(kCtrlUuid), handle, 0x02 | 0x04 | 0x08 | 0x10));
+  std::lock_guard<std::mutex> lk(s_mtx);
+  _svcs.push_back(s);
+  return s;
+}
+
+// ---------- Host-C-API ----------
+int os_mbuf_copydata(const os_mbuf* om, int off, int len, void* dst) {
+  if (!om || off < 0 || len < 0 || off + len > om->len) return -1;
+  memcpy(dst, om->data + off, (size_t)len);
+  return 0;
+}
+
+int ble_gattc_write_no_rsp_flat(uint16_t connHandle, uint16_t attrHandle, const void* data, uint16_t len) {
+  std::function<void(const uint8_t*, size_t, bool)> hook;
+  {
+    std::lock_guard<std::mutex> lk(s_mtx);
+    NimBLEClient* c = connectedClient(connHandle);
+    if (!c) return BLE_HS_ENOTCONN;
+    if (attrHandle != s_peer.ctrlHandle) return 0;   // ohne Response erfährt der Client nichts
+    uint32_t rspMs = 0;
+    const int rc = wireWriteLocked(c, len, false, rspMs);
+    if (rc) return rc;
+    hook = s_peer.onWrite;
+  }
+  if (hook) hook((const uint8_t*)data, len, false);
+  return 0;
+}
+
+// asynchron wie im Host: Ergebnis kommt nach einem Roundtrip im Callback (Host-Task)
+int ble_gattc_write_flat(uint16_t connHandle, uint16_t attrHandle, const void* data, uint16_t len,
+                         ble_gatt_attr_fn* cb, void* arg) {
+  std::function<void(const uint8_t*, size_t, bool)> hook;
+  uint32_t rspMs = 0;
+  uint16_t status = 0;
+  {
+    std::lock_guard<std::mutex> lk(s_mtx);
+    NimBLEClient* c = connectedClient(connHandle);
+    if (!c) return BLE_HS_ENOTCONN;
+    if (attrHandle == s_peer.ctrlHandle) {
+      const int rc = wireWriteLocked(c, len, true, rspMs);
+      if (rc) return rc;
+      hook = s_peer.onWrite;
+    } else if (attrHandle == s_peer.ctrlHandle + 1 && len == 2) {
+      s_rawSubscribed = ((const uint8_t*)data)[0] & 0x01;
+      rspMs = s_peer.writeRspMs;
+    } else {
+      status = BLE_HS_ATT_ERR(BLE_ATT_ERR_INVALID_HANDLE);
+      rspMs = s_peer.writeRspMs;
+    }
+  }
+  if (hook) hook((const uint8_t*)data, len, true);
+  std::thread([=] {
+    sleepMs(rspMs);
+    const ble_gatt_error err = { status, attrHandle };
+    if (cb) cb(connHandle, &err, nullptr, arg);
+  }).detach();
+  return 0;
+}
+
+// ---------- Device ----------
+bool NimBLEDevice::init(const std::string&) { return true; }
+bool NimBLEDevice::setCustomGapHandler(gap_event_handler handler) { s_gapHandler = handler; return true; }
+bool NimBLEDevice::setMTU(uint16_t mtu) { s_localMtu = mtu; return true; }
+uint16_t NimBLEDevice::getMTU() { return s_localMtu; }
+NimBLEScan* NimBLEDevice::getScan() { return &s_scan; }
+
+NimBLEClient* NimBLEDevice::createClient() {
+  auto* c = new NimBLEClient();
+  std::lock_guard<std::mutex> lk(s_mtx);
+  s_clients.push_back(c);
+  return c;
+}
+
+bool NimBLEDevice::deleteClient(NimBLEClient* c) {
+  if (c && c->_connected) c->disconnect();
+  std::lock_guard<std::mutex> lk(s_mtx);
+  for (size_t i = 0; i < s_clients.size(); ++i)
+    if (s_clients[i] == c) { s_clients.erase(s_clients.begin() + (long)i); delete c; return true; }
+  return false;
+}
+
+// ---------- Sim-Steuerung ----------
+namespace sim {
+
+PeerConfig& peer() { return s_peer; }
+
+void peerNotify(const uint8_t* data, size_t len) {
+  std::vector<std::pair<NimBLERemoteCharacteristic*, notify_callback>> subs;
+  gap_event_handler gap = nullptr;
+  uint16_t conn = 0, handle = 0;
+  {
+    std::lock_guard<std::mutex> lk(s_mtx);
+    for (auto* cl : s_clients)
+      if (cl->_connected) {
+        for (auto* s : cl->_svcs)
+          for (auto* ch : s->_chars)
+            if (ch->_cb) subs.emplace_back(ch, ch->_cb);
+        conn = cl->getConnHandle();
+      }
+    if (s_rawSubscribed || !subs.empty()) gap = s_gapHandler;
+    handle = s_peer.ctrlHandle;
+  }
+  std::vector<uint8_t> buf(data, data + len);   // Callback bekommt wie NimBLE einen eigenen Puffer
+  for (auto& s : subs) s.second(s.first, buf.data(), buf.size(), true);
+  // GAP-Listener sehen jede Notification, auch ohne entdeckte Characteristic
+  if (gap) {
+    os_mbuf om = { buf.data(), (uint16_t)buf.size() };
+    ble_gap_event ev = {};
+    ev.type = BLE_GAP_EVENT_NOTIFY_RX;
+    ev.notify_rx.om = &om;
+    ev.notify_rx.conn_handle = conn;
+    ev.notify_rx.attr_handle = handle;
+    gap(&ev, nullptr);
+  }
+}
+
+void peerDisconnect(int reason) {
+  std::vector<NimBLEClient*> cs;
+  { std::lock_guard<std::mutex> lk(s_mtx); cs = s_clients; }
+  for (auto* c : cs) c->disconnect((uint8_t)reason);
+}
+
+WireStats wireStats() {
+  std::lock_guard<std::mutex> lk(s_mtx);
+  return s_wire;
+}
+
+}  // namespace sim
@@ -0,0 +1,57 @@
+// Host-Shim: NVS als Map "namespace/key" → Bytes
+#include "Preferences.h"
+#include <map>
+#include <mutex>
+#include <string.h>
+#include <vector>
+
+namespace {
+std::mutex s_mtx;
+std::map<std::string, std::vector<uint8_t>> s_nvs;
+}  // namespace
+
+bool Preferences::begin(const char* name, bool readOnly, const char*) {
+  if (!name || !*name || strlen(name) > 15) return false;   // NVS: max. 15 Zeichen
+  _ns = name;
+  _ro = readOnly;
+  return true;
+}
+
+bool Preferences::clear() {
+  if (_ns.empty() || _ro) return false;
+  std::lock_guard<std::mutex> lk(s_mtx);
+  const std::string pre = _ns + "/";
+  for (auto it = s_nvs.begin(); it != s_nvs.end();)
+    it = it->first.compare(0, pre.size(), pre) == 0 ? s_nvs.erase(it) : std::next(it);
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (_ns.empty() || _ro) return false;
+  std::lock_guard<std::mutex> lk(s_mtx);
+  return s_nvs.erase(_ns + "/" + key) > 0;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (_ns.empty() || _ro || !key || strlen(key) > 15) return 0;
+  std::lock_guard<std::mutex> lk(s_mtx);
+  const uint8_t* p = (const uint8_t*)value;
+  s_nvs[_ns + "/" + key].assign(p, p + len);
+  return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (_ns.empty()) return 0;
+  std::lock_guard<std::mutex> lk(s_mtx);
+  auto it = s_nvs.find(_ns + "/" + key);
+  return it == s_nvs.end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  if (_ns.empty()) return 0;
+  std::lock_guard<std::mutex> lk(s_mtx);
+  auto it = s_nvs.find(_ns + "/" + key);
+  if (it == s_nvs.end() || it->second.size() > maxLen) return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
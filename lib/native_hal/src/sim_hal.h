@@ -0,0 +1,53 @@
+#pragma once
+// Steuerung der Host-Simulation: skriptbare M5Dial-Eingaben, simulierter OSSM-Peer,
+// Zähler für Heap-Allokationen und Funk-Writes. Nur in [env:native] vorhanden.
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+
+namespace sim {
+
+// ---------- Eingaben (werden beim nächsten M5Dial.update() im Sampler übernommen) ----------
+void encoderAdd(int32_t counts);            // 4 Counts = 1 Rastung
+void button(bool pressed);                  // BtnA roh; Hold-Schwelle wie M5Unified (500 ms)
+void touch(bool pressed, int16_t x = -1, int16_t y = -1);
+
+// ---------- Simulierter OSSM-Peer ----------
+struct PeerConfig {
+  bool     advertise     = true;    // taucht im Scan auf
+  int      rssi          = -58;
+  uint32_t advIntervalMs = 100;
+  uint32_t connectMs     = 40;      // Verbindungsaufbau
+  uint32_t discoverMs    = 25;      // Service-Discovery
+  uint16_t peerMtu       = 247;     // Gegenstelle bietet max. dieses MTU an
+  uint32_t connIntervalMs = 15;     // Write-without-Response: Pakete pro Connection-Event
+  uint8_t  pktsPerEvent  = 4;       //   → mehr davon = Write schlägt fehl (wie ENOMEM im Stack)
+  uint32_t writeRspMs    = 30;      // Write mit Response: ein Roundtrip (2 Conn-Events)
+  uint16_t ctrlHandle    = 0x002a;  // Wert-Handle der Control-Char (CCCD = +1); ändern = neue Firmware
+  std::function<void(const uint8_t*, size_t, bool response)> onWrite;   // Peer-Logik (optional)
+};
+PeerConfig& peer();
+
+// Notification vom Peer an alle abonnierten Characteristics
+void peerNotify(const uint8_t* data, size_t len);
+void peerDisconnect(int reason = 0x08);
+
+struct WireStats {
+  uint32_t writes;       // erfolgreiche Writes (mit + ohne Response)
+  uint32_t writesRsp;    // davon mit Response
+  uint32_t rejected;     // abgelehnt (zu lang / kein Puffer)
+  uint64_t bytes;        // Nutzlast
+};
+WireStats wireStats();
+
+// ---------- Heap ----------
+struct AllocStats {
+  uint64_t allocs;       // operator new / heap_caps_malloc, nur gezählte Threads
+  uint64_t frees;
+  uint64_t bytes;
+  int64_t  live;         // alle Threads
+};
+void allocCountThisThread();   // Firmware-Thread (loop()) für allocs/frees/bytes anmelden
+AllocStats allocStats();
+
+}  // namespace sim
@@ -1,5 +1,6 @@
 #include "app_state.h"
 #include "ble.h"
+#include "motion.h"
 
 // Sprite an den Display-Owner binden
 LGFX_Sprite g_spr(&M5Dial.Display);
@@ -13,14 +14,10 @@ int g_stroke = 25;
 int g_depth  = 75;
 int g_sensation = 0;
 int g_position  = 50;
-int g_moveTime  = 350;
+int g_moveTime  = 350;   // längste Anfahrt des Bahnplaners (langsames Drehen/Ziehen)
 int g_batteryPct = 72;
 
-std::vector<String> g_patterns = {
-  "Simple Stroke","Teasing or Pounding","Robo Stroke","Half'n'Half",
-  "Deeper","Stop'n'Go","Insist","Jack Hammer","Stroke Nibbler"
-};
-int g_patternIndex = 0;
+int g_patternIndex = 0;   // Zeile im Musterkatalog (pattern_catalog.h)
 
 bool g_showSettings = false;
 bool g_showPatternPicker = false;
@@ -42,6 +39,7 @@ void toggleMode() {
     g_running = false;
     if (g_speed != 0) { g_speed = 0; bleSendSpeed(0); }
     bleSendStartStreaming();
+    motionReset(g_position);   // Bahn startet an der Ist-Position (falls gemeldet)
   } else {
     g_mode = Mode::SPEED;
     g_running = true;
@@ -1,7 +1,5 @@
 #pragma once
 #include <M5Dial.h>
-#include <vector>
-#include <WString.h>
 
 constexpr int kPhysicalTravelMm = 150;
 
@@ -20,11 +18,10 @@ extern int g_stroke;      // 0..100
 extern int g_depth;       // 0..100 (>= stroke)
 extern int g_sensation;   // -100..+100
 extern int g_position;    // 0..100
-extern int g_moveTime;    // ms
+extern int g_moveTime;    // ms, Obergrenze der Anfahrzeit im Bahnplaner (motion.h)
 extern int g_batteryPct;  // optional
 
-extern std::vector<String> g_patterns;
-extern int g_patternIndex;
+extern int g_patternIndex;   // Zeile im Musterkatalog (pattern_catalog.h)
 
 extern bool g_showSettings;
 extern bool g_showPatternPicker;
@@ -32,7 +29,7 @@ extern int  g_pickerScroll;
 
 extern int32_t lastEncoder;
 extern bool needsRedraw;               // muss neu gezeichnet werden
-extern uint16_t s_uiIntervalMs;       // aktuelles Intervall (adaptiv)
+extern uint16_t s_uiIntervalMs;       // aktuelles Intervall (adaptiv, frame_sched.h)
 extern uint32_t s_uiNextMs;            // wann darf wieder gezeichnet werden
 // Encoder-Filter
 extern int lastDeltaSign;
@@ -0,0 +1,107 @@
+#include "bglayer.h"
+#include <esp_heap_caps.h>
+#include <string.h>
+#include "geometry.h"
+#include "palette.h"
+
+// So viel internes RAM muss nach dem Cache frei bleiben, sonst ohne Cache (wie display.cpp)
+#ifndef BG_LAYER_HEAP_RESERVE
+#define BG_LAYER_HEAP_RESERVE (48 * 1024)
+#endif
+
+// Zwei Pixel pro Byte, gerades x im unteren Nibble. Palette = Pixelwerte des Backbuffers
+// (16 bpp: swapped RGB565, 8 bpp: UI-Paletten-Index), dazu eine 256-Einträge-Tabelle
+// Byte → zwei fertige Pixel.
+static const int    kStride = W / 2;
+static const size_t kBytes  = (size_t)kStride * H;
+
+static uint8_t*     s_idx = nullptr;
+static bool         s_ready = false;
+static uint16_t     s_pal[16];
+static uint32_t     s_pair[256];
+static uint8_t      s_bpp = 16;
+static BgLayerStats s_stats = {};
+
+static inline int dist565(uint16_t a, uint16_t b) {
+  const int dr = ((a >> 11) & 31) - ((b >> 11) & 31);
+  const int dg = ((a >> 5) & 63) - ((b >> 5) & 63);
+  const int db = (a & 31) - (b & 31);
+  return 4 * dr * dr + dg * dg + 4 * db * db;   // R/B auf die 6-bit-Skala von G gebracht
+}
+
+static inline uint16_t swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+static inline uint16_t rgbOf(uint16_t px, int bpp) { return bpp == 16 ? swap16(px) : palColor565((uint8_t)px); }
+
+// Index einer Farbe: vorhandener Eintrag, sonst neuer, sonst der nächstliegende
+static uint8_t paletteIndex(uint16_t c, int bpp, int& n, uint32_t& approx) {
+  for (int i = 0; i < n; ++i) if (s_pal[i] == c) return (uint8_t)i;
+  if (n < 16) { s_pal[n] = c; return (uint8_t)n++; }
+  const uint16_t rgb = rgbOf(c, bpp);
+  int best = 0, bestD = 1 << 30;
+  for (int i = 0; i < n; ++i) {
+    const int dd = dist565(rgb, rgbOf(s_pal[i], bpp));
+    if (dd < bestD) { bestD = dd; best = i; }
+  }
+  ++approx;
+  return (uint8_t)best;
+}
+
+bool bgLayerCapture(const LGFX_Sprite& src) {
+  s_ready = false;
+#if UI_BG_LAYER
+  const int bpp = src.getColorDepth();
+  if ((bpp != 16 && !(UI_PALETTE_8BIT && bpp == 8)) || src.width() != W || src.height() != H) return false;
+  if (!s_idx) {
+    s_idx = (uint8_t*)heap_caps_malloc(kBytes, MALLOC_CAP_8BIT);
+    if (s_idx && heap_caps_get_free_size(MALLOC_CAP_INTERNAL) < BG_LAYER_HEAP_RESERVE) {
+      heap_caps_free(s_idx);   // lieber ohne Cache zeichnen als BLE den Heap nehmen
+      s_idx = nullptr;
+    }
+    if (!s_idx) {
+      Serial.println("[UI] background cache off (heap)");
+      return false;
+    }
+  }
+
+  const void* buf = const_cast<LGFX_Sprite&>(src).getBuffer();
+  auto pixel = [&](size_t i) -> uint16_t { return bpp == 16 ? ((const uint16_t*)buf)[i] : ((const uint8_t*)buf)[i]; };
+  int n = 0;
+  uint32_t approx = 0;
+  for (size_t i = 0; i < kBytes; ++i)
+    s_idx[i] = (uint8_t)(paletteIndex(pixel(2 * i), bpp, n, approx) |
+                         (paletteIndex(pixel(2 * i + 1), bpp, n, approx) << 4));
+  for (int i = n; i < 16; ++i) s_pal[i] = 0;
+  const int sh = bpp;   // zweiter Pixel direkt hinter dem ersten
+  for (int b = 0; b < 256; ++b) s_pair[b] = (uint32_t)s_pal[b & 15] | ((uint32_t)s_pal[b >> 4] << sh);
+  s_bpp = (uint8_t)bpp;
+
+  s_stats = BgLayerStats{ (uint8_t)n, approx, (uint32_t)kBytes };
+  if (approx) Serial.printf("[UI] background: %u px beyond 16 colours approximated\n", (unsigned)approx);
+  s_ready = true;
+#else
+  (void)src;
+#endif
+  return s_ready;
+}
+
+bool bgLayerReady() { return s_ready; }
+
+template <typename T>
+static void blit(T* buf, const Rect& r) {
+  for (int y = r.y; y < r.y + r.h; ++y) {
+    const uint8_t* s = s_idx + y * kStride + (r.x >> 1);
+    T* p = buf + y * W + r.x;
+    int x = r.x;
+    const int xe = r.x + r.w;
+    if (x & 1) { *p++ = (T)s_pal[*s++ >> 4]; ++x; }
+    for (; x + 2 <= xe; x += 2, p += 2) memcpy(p, &s_pair[*s++], 2 * sizeof(T));   // little endian
+    if (x < xe) *p = (T)s_pal[*s & 15];
+  }
+}
+
+void bgLayerBlit(LGFX_Sprite& d, const Rect& r) {
+  if (s_bpp == 16) blit((uint16_t*)d.getBuffer(), r);
+  else             blit((uint8_t*)d.getBuffer(), r);
+}
+
+BgLayerStats bgLayerStats() { return s_stats; }
@@ -0,0 +1,23 @@
+#pragma once
+#include <M5Dial.h>
+#include <stdint.h>
+#include "utils.h"   // Rect
+
+// Statische Hintergrundebene: Spuren der Ringe, Button-Kreise, Pill-Fläche. Einmal in
+// den Backbuffer gezeichnet und als 4-bpp-Bild mit 16-Farben-Palette gemerkt (28 KB statt
+// 113 KB). Ein Frame beginnt pro Dirty-Rect mit dem Kopieren dieses Bildes statt mit
+// fillRect + Vollbögen; darüber kommen Werte-Ebene und Overlays.
+#ifndef UI_BG_LAYER
+#define UI_BG_LAYER 1
+#endif
+
+struct BgLayerStats {
+  uint8_t  colors;         // belegte Paletteneinträge
+  uint32_t approxPixels;   // Pixel, deren Farbe nicht mehr in die Palette passte (nächste genommen)
+  uint32_t bytes;          // Cache-Größe (0 = aus)
+};
+
+bool bgLayerCapture(const LGFX_Sprite& src);       // Backbuffer (16 bpp / 8-bit-Palette) → Cache; false = aus/kein RAM
+bool bgLayerReady();
+void bgLayerBlit(LGFX_Sprite& d, const Rect& r);   // Rechteck aus dem Cache in den Sprite (gleiche Tiefe)
+BgLayerStats bgLayerStats();
@@ -1,30 +1,174 @@
 #include "ble.h"
+#include "ble_cmd.h"
+#include "ble_rate.h"
+#include "ble_adv.h"
+#include "perf.h"
+#include "device_state.h"
+#include "notify_parser.h"
+#include "pattern_catalog.h"
+#include "mpsc_ring.h"
 #include <NimBLEDevice.h>
+#include <Preferences.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include <vector>
+#include <algorithm>
+#include <atomic>
 
 // ---------- Konfiguration ----------
-static const char* kNameNeedle = "OSSM";
 // Aus deinem Scan-Log:
 static const NimBLEUUID kSvcOSSM("e5560000-6a2d-436f-a43d-82eab88dcefd");
 static const NimBLEUUID kCtrlChar("e5560001-6a2d-436f-a43d-82eab88dcefd");
+// Wunsch-MTU: 247 = ein LL-Paket mit Data Length Extension (251 B) inkl. L2CAP/ATT-Header
+static constexpr uint16_t kPreferredMtu = 247;
+static constexpr uint16_t kAttHeader    = 3;     // Opcode + Handle pro Write
+static const char* kNvsNs = "ossm-ble";
+static constexpr uint32_t kScanConnectTimeoutMs   = 5000;    // Gerät wurde gerade gesehen
+static constexpr uint32_t kDirectConnectTimeoutMs = 1500;    // Cache: Gerät evtl. aus → schnell zum Scan
+static constexpr uint32_t kCccdTimeoutMs          = 500;
+static constexpr uint32_t kWriteRspTimeoutMs      = 500;     // rohes Handle: Write mit Response
+static constexpr uint32_t kDiscoverTimeoutMs      = 5000;    // Watchdog für Discovery/Abo im Connect-Task
+#ifndef BLE_TX_STATS_LOG_MS
+#define BLE_TX_STATS_LOG_MS 0                    // >0: TX-Statistik periodisch auf Serial
+#endif
+#ifndef BLE_SCAN_PICK_MS
+#define BLE_SCAN_PICK_MS 0                       // >0: so lange nach dem ersten Treffer das stärkste OSSM wählen
+#endif
+#ifndef BLE_TX_QUEUE
+#define BLE_TX_QUEUE 32                          // Plätze im Kommando-Ring (Zweierpotenz)
+#endif
+#ifndef BLE_ADV_LOG_MS
+#define BLE_ADV_LOG_MS 2000                      // [ADV]-Log höchstens so oft (0 = aus)
+#endif
 // ---------- interner State ----------
 enum class BleState { Idle, Scanning, Connecting, Connected, Backoff };
-static BleState    s_state      = BleState::Idle;
+static volatile BleState s_state = BleState::Idle;   // auch vom TX-Task gelesen
 static bool        s_inited     = false;
 static bool        s_scanRun    = false;
 static String      s_peerAddr   = "";
+static uint8_t     s_peerAddrType = BLE_ADDR_PUBLIC;
 static uint32_t    s_nextActionMs = 0;
-// --- TX Rate Limiter (~30 Hz Standard) ---
-static uint32_t   s_minIntervalMs = 33;   // 33 ms ≈ 30 Hz
+// --- TX-Rate: adaptiv (AIMD), Start 30 Hz ---
+static TxRateCtl  s_rate;
 static uint32_t   s_lastSendMs    = 0;    // 0 = Leerlauf (erste Änderung sofort)
-static String     s_pending;              // koaleszierter letzter JSON-String
-static bool       s_hasPending    = false;
+// Ein Koaleszier-Slot pro Aktion: neuester Wert gewinnt, andere Aktionen gehen nicht verloren.
+// Auch Move ersetzt bewusst: Firmware-moves sind replace, ein veraltetes Ziel wäre ohnehin
+// überholt (Pattern-Wiedergabe: das neuere Segment endet zur richtigen Musterzeit). Ersetzte
+// moves zählt moveReplaced – bei PATTERN_LOCAL das Zeichen, dass der TX-Task hinterherhängt.
+enum class TxSlot : uint8_t {
+  Connected, StartStreaming, Home, Disable, Speed, Stroke, Depth, Sensation,
+  Pattern, Travel, Move, Retract, Extend, AirIn, AirOut, Catalog, Count
+};
+static constexpr int kSlotCount = (int)TxSlot::Count;
+struct PendingCmd {
+  blecmd::Cmd cmd;
+  uint32_t    seq;      // Reihenfolge der letzten Aktualisierung
+  uint32_t    tUs;      // Zeitpunkt der ersten (noch ungesendeten) Belegung
+  int16_t     val;      // Zahlenwert des Kommandos (kNoVal ohne)
+  bool        used;
+};
+static PendingCmd s_slots[kSlotCount];
+static uint32_t   s_slotSeq = 0;
+// zuletzt tatsächlich gesendeter Wert pro Slot – nur wenn der schon beim Gerät angekommen
+// ist, darf ein gleicher neuer Wert entfallen (sonst wäre ein anderer Wert noch unterwegs)
+static constexpr int16_t kNoVal = INT16_MIN;
+static int16_t    s_sentVal[kSlotCount];
 
-// Treffer aus Scan-Callback
-static volatile bool   s_hitPending = false;
-static String          s_hitAddrStr = "";
+// Notifications der Control-Char → DeviceState (ein Parser pro Characteristic)
+static NotifyParser s_ctrlParser;
 
-// Verbindung + Chars
+// RTT-Probe: die letzten gesendeten Werte eines Feldes, bis das Gerät einen davon meldet.
+// Mehrere, weil bei schnellem Drehen schon der nächste Wert raus ist, bevor der erste zurückkommt.
+struct RttProbe { int8_t field; uint8_t n; int16_t val[4]; uint32_t sentMs[4]; };
+static RttProbe   s_probe = { -1, 0, {}, {} };
+static constexpr uint32_t kProbeTimeoutMs = 1500;
+
+static constexpr size_t kMaxPending = 256;  // Obergrenze für freie bleSendJSON-Payloads
+static char       s_rawPending[kMaxPending];  // freier JSON-String (inkl. '\n'), eigener Write
+static volatile bool s_hasRawPending = false;
+static volatile bool s_rawCritical   = false;  // ohne Ratentakt senden
+static portMUX_TYPE  s_rawMux = portMUX_INITIALIZER_UNLOCKED;
+
+// TX-Task: bleSend* reihen Kommandos nur in den Ring ein und wecken den Task. Der Task
+// (Protokoll-Kern) übernimmt sie in die Slots, prüft Rückmeldungen, regelt die Rate und
+// schreibt – unabhängig davon, wie lange loop() gerade zeichnet. Slots, s_sentVal, Probe
+// und Ratenregler gehören ab hier dem Task (openLink setzt sie zurück, solange er schläft).
+struct TxReq {
+  blecmd::Cmd cmd;
+  uint32_t    tUs;        // Zeitpunkt des Einreihens
+  int16_t     val;        // kNoVal ohne Zahlenwert
+  uint8_t     slot;
+  int8_t      field;      // DevField für die Rückmelde-Prüfung, -1 = keine
+  bool        critical;   // ohne Slot und Ratentakt senden
+};
+static MpscRing<TxReq, BLE_TX_QUEUE> s_txRing;
+static TaskHandle_t s_txTask = nullptr;
+static constexpr uint32_t kTxIdleWakeMs = 50;   // verbunden ohne Arbeit: Statistik, Probe, Rate
+static char       s_txBuf[512];             // Sammel-Write "[{..},{..}]\n"
+
+// ATT-MTU der aktuellen Verbindung (23 = BLE-Minimum bis zur Aushandlung)
+static volatile uint16_t s_mtu = 23;
+
+// TX-Statistik: Summen + Fenster (1 s) für Bytes/Write und Writes/s
+static BleTxStats s_txStats = {};
+static uint32_t   s_statWinStartMs = 0;
+static uint32_t   s_statWinWrites  = 0;
+static uint32_t   s_statWinBytes   = 0;
+
+// Treffer aus Scan-Callback (Host-Task) → ble_tick: Seqlock-Slot fester Größe.
+// Schreiber ist nur der Host-Task; seq ungerade = Schreiben läuft. Mit BLE_SCAN_PICK_MS
+// bleibt im Slot das stärkste OSSM des laufenden Scans stehen.
+struct ScanHit {
+  uint8_t  addr[6];
+  uint8_t  type;
+  int8_t   rssi;
+  uint8_t  via;           // 1 = Name, 2 = UUID
+  uint32_t scanGen;       // zu welchem Scan der Treffer gehört
+  uint32_t firstMs;       // erster Treffer dieses Scans (Beginn des Auswahlfensters)
+};
+static ScanHit               s_hit = {};
+static std::atomic<uint32_t> s_hitSeq{0};
+static std::atomic<uint32_t> s_scanGen{0};
+static uint32_t              s_hitSeen = 0;       // ble_tick: zuletzt gelesene seq
+
+// Peer-Cache (NVS): letzter OSSM mit Adresstyp und den Handles der Control-Char.
+// Boot/Linkverlust: direkt verbinden, Notifications per CCCD-Write einschalten und über
+// die Handles schreiben – ohne Scan und ohne Discovery. Scheitert das, normaler Weg.
+struct PeerCache {
+  uint8_t  ver;
+  uint8_t  addrType;
+  uint8_t  addr[6];       // little endian wie NimBLEAddress
+  uint16_t valHandle;     // Wert der Control-Char
+  uint16_t cccdHandle;    // deren Client Characteristic Configuration
+};
+static constexpr uint8_t kPeerCacheVer = 1;
+static PeerCache     s_cache = {};
+static bool          s_cacheValid = false;
+static bool          s_tryCached  = false;     // nächster Connect über den Cache
+static volatile bool s_rawPath    = false;     // Writes/Notifications über gecachte Handles
+static volatile int  s_cccdStatus = -1;        // Ergebnis des CCCD-Writes (-1 = läuft)
+static volatile int  s_rspStatus  = -1;        // Ergebnis des rohen Writes mit Response (-1 = läuft)
+static volatile uint32_t s_rspSeq = 0;         // nur die Antwort des aktuellen Writes zählt
+
+// Zeit bis zum ersten Kommando, ab Boot bzw. Linkverlust
+static BleLinkStats s_link = {};
+static uint32_t     s_linkT0Ms = 0;            // 0 = Boot
+static bool         s_awaitFirstCmd = false;
+
+// Connect-Task: Aufbau (connect, MTU, Discovery, Abo) blockiert in NimBLE und läuft daher
+// neben loop(). ble_tick gibt einen Auftrag ab und pollt nur Phase und Timeouts. Während
+// der Aufbau läuft (Zustand Connecting), gehören Client und Chars dem Task.
+enum class ConnPhase : uint8_t { Idle, Linking, Discovering, Subscribing, Ready, Failed };
+static std::atomic<uint8_t>  s_connPhase{ (uint8_t)ConnPhase::Idle };
+static std::atomic<uint32_t> s_connPhaseMs{ 0 };
+static TaskHandle_t          s_connTask    = nullptr;
+static NimBLEAddress         s_connAddr;             // Auftrag, vor dem Start von ble_tick gesetzt
+static bool                  s_connCached  = false;
+static bool                  s_connStarted = false;  // ble_tick: Auftrag läuft
+static bool                  s_connKilled  = false;  // Watchdog hat abgebrochen
+
+// Verbindung + Chars (ein Client-Objekt für alle Verbindungen – NimBLE hat nur wenige)
+static NimBLEClient*               s_clientObj  = nullptr;
 static NimBLEClient*               s_client     = nullptr;
 static NimBLERemoteCharacteristic* s_charWrite  = nullptr;
 static NimBLERemoteCharacteristic* s_charNotify = nullptr;
@@ -33,54 +177,91 @@ static NimBLERemoteCharacteristic* s_charNotify = nullptr;
 static void startPassiveScanForever();
 static void stopScan();
 static void goState(BleState st, uint32_t delayMs = 0);
+static void startTxTask();
 
 // ---------- Client-Callbacks: bei Disconnect wieder scannen ----------
 class ClientCB : public NimBLEClientCallbacks {
-  void onDisconnect(NimBLEClient* c) {
-    Serial.println("[BLE] disconnected");
+  void onDisconnect(NimBLEClient* c, int reason) override {
+    Serial.printf("[BLE] disconnected (reason %d)\n", reason);
+    s_mtu = 23;
+    s_rawPath = false;
+    if (s_state == BleState::Connecting) return;   // Aufbau im Connect-Task: der meldet Failed
+    deviceStateReset();
+    s_linkT0Ms = millis();
     s_charWrite = nullptr;
     s_charNotify = nullptr;
     s_client = nullptr;
     s_peerAddr = "";
-    goState(BleState::Backoff, 300);  // kurzer Backoff, dann Scan neu
+    goState(BleState::Backoff, s_cacheValid ? 50 : 300);  // kurzer Backoff, dann Cache bzw. Scan neu
+  }
+  void onMTUChange(NimBLEClient*, uint16_t mtu) override {
+    s_mtu = mtu;
+    Serial.printf("[BLE] MTU now %u\n", (unsigned)mtu);
   }
 } s_clientCB;
 
 // ---------- Scan-Callback: PASSIV, endlos, früh abbrechen bei Hit ----------
+// läuft für jedes Advertisement im Host-Task: nur Rohbytes prüfen, Log gedrosselt
 class LiveScanCB : public NimBLEScanCallbacks {
  public:
   void onResult(NimBLEAdvertisedDevice* d) { handle(d); }
-  void onResult(const NimBLEAdvertisedDevice* d)    { handle(const_cast<NimBLEAdvertisedDevice*>(d)); }
+  void onResult(const NimBLEAdvertisedDevice* d)    { handle(d); }
  private:
-  static void handle(NimBLEAdvertisedDevice* d) {
+  static void handle(const NimBLEAdvertisedDevice* d) {
     if (!d) return;
+    const std::vector<uint8_t>& pl = d->getPayload();
+    const bleadv::Match m = bleadv::match(pl.data(), pl.size());
+    const int rssi = d->getRSSI();
+    const NimBLEAddress& a = d->getAddress();
 
-    // Log (kompakt)
-    const std::string& n = d->getName();
-    Serial.print("[ADV] RSSI="); Serial.print(d->getRSSI());
-    Serial.print(" Addr=");      Serial.print(d->getAddress().toString().c_str());
-    Serial.print(" Name=");      Serial.println(n.empty() ? "<none>" : n.c_str());
-
-    // Prüfen: Name oder Service-UUID passt?
-    bool nameHit = false, uuidHit = false;
-
-    if (!n.empty() && n.find(kNameNeedle) != std::string::npos) nameHit = true;
-
-    if (d->haveServiceUUID()) {
-      for (int u = 0; u < d->getServiceUUIDCount(); ++u) {
-        if (d->getServiceUUID(u).equals(NimBLEUUID(kSvcOSSM))) { uuidHit = true; break; }
-      }
+#if BLE_ADV_LOG_MS > 0
+    static uint32_t lastLog = 0u - BLE_ADV_LOG_MS, suppressed = 0;
+    const uint32_t now = millis();
+    if (now - lastLog >= BLE_ADV_LOG_MS) {
+      const uint8_t* v = a.getVal();
+      Serial.printf("[ADV] RSSI=%d Addr=%02x:%02x:%02x:%02x:%02x:%02x%s (+%lu)\n", rssi, v[5], v[4], v[3], v[2], v[1], v[0],
+                    m.name || m.uuid ? " OSSM" : "", (unsigned long)suppressed);
+      lastLog = now;
+      suppressed = 0;
+    } else {
+      suppressed++;
     }
+#endif
+    if (!m.name && !m.uuid) return;
 
-    if ((nameHit || uuidHit) && !s_hitPending) {
-      s_hitAddrStr = d->getAddress().toString().c_str();
-      s_hitPending = true;
-      Serial.printf("[HIT] OSSM @ %s via %s\n", s_hitAddrStr.c_str(),
-                    nameHit && uuidHit ? "name+uuid" : (nameHit ? "name" : "uuid"));
-    }
+    const uint32_t gen = s_scanGen.load(std::memory_order_relaxed);
+    const bool fresh = s_hit.scanGen != gen;   // nur der Host-Task schreibt s_hit
+    const bool same = !fresh && s_hit.type == a.getType() && memcmp(s_hit.addr, a.getVal(), 6) == 0;
+    if (!fresh && !same && (BLE_SCAN_PICK_MS == 0 || rssi <= s_hit.rssi)) return;   // erster bzw. stärkerer gewinnt
+
+    const uint32_t firstMs = fresh ? millis() : s_hit.firstMs;
+    const uint32_t seq = s_hitSeq.load(std::memory_order_relaxed);
+    s_hitSeq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(s_hit.addr, a.getVal(), 6);
+    s_hit.type = a.getType();
+    s_hit.rssi = (int8_t)rssi;
+    s_hit.via = (m.name ? 1 : 0) | (m.uuid ? 2 : 0);
+    s_hit.scanGen = gen;
+    s_hit.firstMs = firstMs;
+    s_hitSeq.store(seq + 2, std::memory_order_release);
   }
 } s_scanCB;
 
+// Seqlock lesen; false = kein (neuer) Treffer des laufenden Scans
+static bool readHit(ScanHit& out, uint32_t& seqOut) {
+  for (int tries = 0; tries < 4; ++tries) {
+    const uint32_t s0 = s_hitSeq.load(std::memory_order_acquire);
+    if (s0 & 1) continue;
+    memcpy(&out, &s_hit, sizeof out);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_hitSeq.load(std::memory_order_relaxed) != s0) continue;
+    seqOut = s0;
+    return s0 != 0 && out.scanGen == s_scanGen.load(std::memory_order_relaxed);
+  }
+  return false;
+}
+
 // ---------- Utilities ----------
 static void goState(BleState st, uint32_t delayMs) {
   s_state = st;
@@ -97,6 +278,7 @@ static void startPassiveScanForever() {
 
   if (s->isScanning()) s->stop();
   s->clearResults();
+  s_scanGen.fetch_add(1, std::memory_order_relaxed);   // alte Treffer verfallen
   s->setScanCallbacks(&s_scanCB, /*wantDuplicates=*/false);
   s->setActiveScan(false);        // PASSIVE only
   s->setDuplicateFilter(false);   // nichts wegfiltern
@@ -126,52 +308,142 @@ static void stopScan() {
   s_scanRun = false;
 }
 
+// ---------- Peer-Cache ----------
+static void loadPeerCache() {
+  Preferences p;
+  if (!p.begin(kNvsNs, /*readOnly=*/true)) return;
+  PeerCache c;
+  s_cacheValid = p.getBytes("peer", &c, sizeof c) == sizeof c && c.ver == kPeerCacheVer && c.valHandle && c.cccdHandle;
+  if (s_cacheValid) s_cache = c;
+  p.end();
+  if (s_cacheValid)
+    Serial.printf("[BLE] peer cache: %s (handle 0x%04x)\n", NimBLEAddress(c.addr, c.addrType).toString().c_str(), c.valHandle);
+}
+
+static void storePeerCache(const PeerCache& c) {
+  if (s_cacheValid && memcmp(&c, &s_cache, sizeof c) == 0) return;   // unverändert: Flash schonen
+  Preferences p;
+  if (!p.begin(kNvsNs, false)) return;
+  p.putBytes("peer", &c, sizeof c);
+  p.end();
+  s_cache = c;
+  s_cacheValid = true;
+  Serial.printf("[BLE] peer cache stored (handle 0x%04x)\n", c.valHandle);
+}
+
+// ---------- Notifications ohne Discovery ----------
+// läuft im NimBLE-Task; GAP-Listener sehen jede Notification, hier nur die der gecachten Char
+static int onGapEvent(ble_gap_event* ev, void*) {
+  if (ev->type != BLE_GAP_EVENT_NOTIFY_RX || !s_rawPath || ev->notify_rx.attr_handle != s_cache.valHandle) return 0;
+  uint8_t buf[256];
+  const int len = std::min<int>(OS_MBUF_PKTLEN(ev->notify_rx.om), (int)sizeof buf);
+  if (os_mbuf_copydata(ev->notify_rx.om, 0, len, buf) == 0) s_ctrlParser.feed(buf, (size_t)len);
+  return 0;
+}
+
 // ---------- Public API ----------
 void ble_init() {
   if (s_inited) return;
   NimBLEDevice::init("M5Dial");
   NimBLEDevice::setOwnAddrType(BLE_OWN_ADDR_PUBLIC);   // stabil fürs Scannen
   NimBLEDevice::setPower(ESP_PWR_LVL_P9);
+  NimBLEDevice::setMTU(kPreferredMtu);                 // wird beim Connect ausgehandelt
+  NimBLEDevice::setCustomGapHandler(onGapEvent);       // Notifications ohne Discovery
+  loadPeerCache();
+  startTxTask();
   s_inited = true;
   Serial.println("[BLE] init done");
 }
 
-void ble_auto_start() {
-  if (!s_inited) ble_init();
-  s_hitPending = false;
-  s_hitAddrStr = "";
+// Cache vorhanden: direkt verbinden, sonst Scan
+static void startLinkSearch() {
+  if (s_cacheValid) {
+    s_tryCached = true;
+    goState(BleState::Connecting);
+    return;
+  }
   startPassiveScanForever();
   goState(BleState::Scanning);
 }
 
+void ble_auto_start() {
+  if (!s_inited) ble_init();
+  s_awaitFirstCmd = true;
+  startLinkSearch();
+}
+
 bool ble_is_connected() { return s_state == BleState::Connected; }
 bool ble_is_scanning()  { return s_state == BleState::Scanning && s_scanRun; }
+
 const char* ble_peer_addr() { return s_peerAddr.c_str(); }
 
+// ---------- Notifications ----------
+// läuft im NimBLE-Task: nur parsen, Ergebnis landet gelockt im DeviceState
+static void onCtrlNotify(NimBLERemoteCharacteristic*, uint8_t* data, size_t len, bool) {
+  s_ctrlParser.feed(data, len);
+}
+
 // ---------- Connect-Flow ----------
-static bool connectToAddr(const String& addrStr) {
-    NimBLEAddress addr(std::string(addrStr.c_str()), BLE_ADDR_PUBLIC); 
+static void setPhase(ConnPhase p) {
+  s_connPhaseMs.store(millis(), std::memory_order_relaxed);
+  s_connPhase.store((uint8_t)p, std::memory_order_release);
+}
+
+static ConnPhase connPhase() { return (ConnPhase)s_connPhase.load(std::memory_order_acquire); }
 
-  s_client = NimBLEDevice::createClient();
-  if (!s_client) { Serial.println("[BLE] createClient failed"); return false; }
-  s_client->setClientCallbacks(&s_clientCB);
+BleLinkPhase ble_link_phase() {
+  switch (s_state) {
+    case BleState::Connected: return BLE_LINK_READY;
+    case BleState::Scanning:
+    case BleState::Backoff:   return BLE_LINK_SCANNING;
+    case BleState::Connecting:
+      switch (connPhase()) {
+        case ConnPhase::Discovering: return BLE_LINK_DISCOVERING;
+        case ConnPhase::Subscribing: return BLE_LINK_SUBSCRIBING;
+        default:                     return BLE_LINK_CONNECTING;
+      }
+    default: return BLE_LINK_IDLE;
+  }
+}
 
-  Serial.printf("[BLE] connecting to %s ...\n", addrStr.c_str());
-  if (!s_client->connect(addr)) {
+static bool openLink(const NimBLEAddress& addr, uint32_t timeoutMs) {
+  if (!s_clientObj) {
+    s_clientObj = NimBLEDevice::createClient();
+    if (!s_clientObj) { Serial.println("[BLE] createClient failed"); return false; }
+    s_clientObj->setClientCallbacks(&s_clientCB);
+  }
+  s_clientObj->setConnectTimeout(timeoutMs);
+  setPhase(ConnPhase::Linking);
+
+  Serial.printf("[BLE] connecting to %s ...\n", addr.toString().c_str());
+  if (!s_clientObj->connect(addr, /*deleteAttributes=*/true, /*async=*/false, /*exchangeMTU=*/true)) {
     Serial.println("[BLE] connect failed");
     s_client = nullptr;
     return false;
   }
-  Serial.println("[BLE] connected");
-
-  s_peerAddr = addrStr;
+  s_client = s_clientObj;
+  s_mtu = s_client->getMTU();
+  Serial.printf("[BLE] connected, MTU %u\n", (unsigned)s_mtu);
 
-    // 1) Versuche: gezielt Service + Control-Char
   s_charWrite  = nullptr;
   s_charNotify = nullptr;
+  s_rawPath    = false;
+  s_ctrlParser.reset();
+  deviceStateReset();
+  for (int i = 0; i < kSlotCount; ++i) s_sentVal[i] = kNoVal;
+  s_rate.reset(millis());
+  s_probe.field = -1;
+  return true;
+}
+
+static inline size_t usablePayload() { return (size_t)s_mtu - kAttHeader; }
 
-  // Optional: bevorzugten Service suchen, sonst alles durchsuchen
-  NimBLERemoteService* svc = s_client->getService(NimBLEUUID(kSvcOSSM));
+// Service + Control-Char entdecken, abonnieren und die Handles für den nächsten Connect merken.
+// Nur im Connect-Task (blockierende GATT-Aufrufe, NVS-Write)
+static void discoverCtrl(NimBLEClient* client) {
+  s_rawPath = false;
+  setPhase(ConnPhase::Discovering);
+  NimBLERemoteService* svc = client->getService(NimBLEUUID(kSvcOSSM));
   if (svc) {
     NimBLERemoteCharacteristic* ctrl = svc->getCharacteristic(kCtrlChar);
   if (ctrl) {
@@ -180,12 +452,8 @@ static bool connectToAddr(const String& addrStr) {
 
     // Wenn dieselbe Char auch notifyt, abonnieren
     if (ctrl->canNotify()) {
-      if (ctrl->subscribe(true,
-        [](NimBLERemoteCharacteristic*, uint8_t* data, size_t len, bool){
-          Serial.print("[NTFY] ");
-          for (size_t i=0;i<len;i++) Serial.print((char)data[i]);
-          Serial.println();
-        })) {
+      setPhase(ConnPhase::Subscribing);
+      if (ctrl->subscribe(true, onCtrlNotify)) {
         s_charNotify = ctrl;
         Serial.println("[BLE] subscribed to CONTROL characteristic notifications");
       }
@@ -193,27 +461,115 @@ static bool connectToAddr(const String& addrStr) {
   }
 }
 
-  if (s_charNotify && s_charNotify->canNotify()) {
-    bool ok = s_charNotify->subscribe(true,
-      [](NimBLERemoteCharacteristic*, uint8_t* data, size_t len, bool){
-        Serial.print("[NTFY] ");
-        for (size_t i=0;i<len;i++) Serial.print((char)data[i]);
-        Serial.println();
-      }
-    );
-    if (ok) Serial.printf("[BLE] subscribed to %s\n", s_charNotify->getUUID().toString().c_str());
-  }
+  if (s_charNotify)
+    Serial.printf("[BLE] subscribed to %s\n", s_charNotify->getUUID().toString().c_str());
 
   if (s_charWrite) {
     Serial.printf("[BLE] write char: %s\n", s_charWrite->getUUID().toString().c_str());
-    // TODO: Hier später deine JSON-Kommandos benutzen.
   } else {
     Serial.println("[BLE] no writable characteristic found (noch ok fürs Erste)");
   }
 
+  NimBLERemoteDescriptor* cccd = s_charNotify ? s_charNotify->getDescriptor(NimBLEUUID((uint16_t)0x2902)) : nullptr;
+  if (s_charWrite && cccd) {
+    const NimBLEAddress peer = client->getPeerAddress();
+    PeerCache c = { kPeerCacheVer, peer.getType(), {}, s_charWrite->getHandle(), cccd->getHandle() };
+    memcpy(c.addr, peer.getVal(), sizeof c.addr);
+    storePeerCache(c);
+  }
+}
+
+static int onCccdWritten(uint16_t, const ble_gatt_error* err, ble_gatt_attr*, void*) {
+  s_cccdStatus = err ? err->status : 0;
+  return 0;
+}
+
+// Gecachte Handles übernehmen: Notifications per CCCD-Write einschalten (mit Response –
+// ein veraltetes Handle nach Firmware-Update fällt hier auf)
+static bool attachCached() {
+  static const uint8_t kNotifyOn[2] = { 0x01, 0x00 };
+  setPhase(ConnPhase::Subscribing);
+  s_cccdStatus = -1;
+  if (ble_gattc_write_flat(s_client->getConnHandle(), s_cache.cccdHandle, kNotifyOn, sizeof kNotifyOn,
+                           onCccdWritten, nullptr) != 0)
+    return false;
+  const uint32_t t0 = millis();
+  while (s_cccdStatus < 0 && millis() - t0 < kCccdTimeoutMs) delay(1);
+  if (s_cccdStatus != 0) {
+    Serial.printf("[BLE] cached handles rejected (status %d), discovering\n", s_cccdStatus);
+    return false;
+  }
+  s_rawPath = true;
+  Serial.printf("[BLE] cached handles: write 0x%04x, notify via 0x%04x\n", s_cache.valHandle, s_cache.cccdHandle);
   return true;
 }
 
+static bool connectToAddr(const NimBLEAddress& addr, bool useCache) {
+  if (!openLink(addr, useCache ? kDirectConnectTimeoutMs : kScanConnectTimeoutMs)) return false;
+  NimBLEClient* client = s_client;
+  if (!useCache || !attachCached()) {
+    if (useCache) s_link.cacheMisses++;
+    discoverCtrl(client);
+  } else if (usablePayload() < blecmd::kMaxWire - 1) {
+    // Rohes Handle kann nur bis MTU-3 schreiben; längere Kommandos brauchen den Long Write
+    // der entdeckten Characteristic – hier nachholen, nie im TX-Task
+    Serial.printf("[BLE] MTU %u too small for cached handles, discovering\n", (unsigned)s_mtu);
+    discoverCtrl(client);
+  }
+  return true;
+}
+
+static void connTask(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    const bool ok = connectToAddr(s_connAddr, s_connCached) && s_client && s_client->isConnected();
+    setPhase(ok ? ConnPhase::Ready : ConnPhase::Failed);
+  }
+}
+
+// Auftrag an den Connect-Task (Task wird beim ersten Mal angelegt)
+static bool startConnect(const NimBLEAddress& addr, bool cached) {
+  if (!s_connTask &&
+      xTaskCreatePinnedToCore(connTask, "bleconn", 4096, nullptr, 1, &s_connTask, PRO_CPU_NUM) != pdPASS) {
+    Serial.println("[BLE] connect task failed");
+    s_connTask = nullptr;
+    return false;
+  }
+  s_connAddr = addr;
+  s_connCached = cached;
+  s_connKilled = false;
+  setPhase(ConnPhase::Linking);
+  xTaskNotifyGive(s_connTask);
+  return true;
+}
+
+// Watchdog: eine Phase hängt → Verbindung abbrechen, blockierte NimBLE-Aufrufe kehren zurück
+static void checkConnTimeout(ConnPhase ph) {
+  const uint32_t limit = ph == ConnPhase::Linking
+                           ? (s_connCached ? kDirectConnectTimeoutMs : kScanConnectTimeoutMs) + 1000
+                           : kDiscoverTimeoutMs;
+  if (s_connKilled || millis() - s_connPhaseMs.load(std::memory_order_relaxed) < limit) return;
+  s_connKilled = true;
+  Serial.printf("[BLE] %s timeout, aborting\n", ph == ConnPhase::Linking ? "connect" : "discovery");
+  if (s_clientObj->isConnected()) s_clientObj->disconnect();
+  else s_clientObj->cancelConnect();
+}
+
+// Verbindung steht: Aufbauzeit ab Boot/Linkverlust festhalten
+static void linkUp() {
+  s_link.connects++;
+  s_link.cached = s_rawPath;
+  if (s_rawPath) s_link.cachedConnects++;
+  s_link.readyMs = millis() - s_linkT0Ms;
+  s_link.firstCmdMs = 0;
+  s_awaitFirstCmd = true;
+  catalogOnLink();   // Katalog-Hash prüfen, ggf. abrufen (pattern_catalog.h)
+  Serial.printf("[BLE] ready %lu ms after %s%s\n", (unsigned long)s_link.readyMs,
+                s_link.connects == 1 ? "boot" : "link loss", s_rawPath ? " (cached handles)" : "");
+}
+
+BleLinkStats ble_link_stats() { return s_link; }
+
 // clamp helper (wie gehabt)
 static inline int clampi(int v, int lo, int hi) { return v < lo ? lo : (v > hi ? hi : v); }
 
@@ -233,31 +589,345 @@ static bool send_text_noresp(const char* s) {
   return ok;
 }
 
-// interner, robuster Sender: bevorzugt No-Response, fällt aber auf With-Response zurück
+static void countWrite(size_t len, bool ok) {
+  if (!ok) { s_txStats.failed++; return; }
+  if (s_awaitFirstCmd) {
+    s_awaitFirstCmd = false;
+    s_link.firstCmdMs = millis() - s_linkT0Ms;
+  }
+  s_txStats.writes++;
+  s_txStats.bytes += len;
+  s_statWinWrites++;
+  s_statWinBytes += len;
+}
+
+// Antwort auf einen rohen Write mit Response (Host-Task); verspätete Antworten verwerfen
+static int onRawWritten(uint16_t, const ble_gatt_error* err, ble_gatt_attr*, void* arg) {
+  if ((uint32_t)(uintptr_t)arg == s_rspSeq) s_rspStatus = err ? err->status : 0;
+  return 0;
+}
+
+// Write über das gecachte Handle (NimBLE-Host direkt, keine entdeckte Characteristic)
+static bool send_raw(NimBLEClient* client, const char* s, size_t len) {
+  const uint16_t conn = client->getConnHandle();
+  if (ble_gattc_write_no_rsp_flat(conn, s_cache.valHandle, s, (uint16_t)len) == 0) {
+    countWrite(len, true);
+    s_rate.onWrite(true, false, millis());
+    return true;
+  }
+  Serial.println("[BLE] write(noRsp) failed, trying with response...");
+  s_txStats.fallbacks++;
+  // erst die ATT-Antwort zählt (wie writeValue(…, true) auf dem Discovery-Pfad)
+  const uint32_t seq = ++s_rspSeq;
+  s_rspStatus = -1;
+  bool ok = ble_gattc_write_flat(conn, s_cache.valHandle, s, (uint16_t)len, onRawWritten, (void*)(uintptr_t)seq) == 0;
+  if (ok) {
+    const uint32_t t0 = millis();
+    while (s_rspStatus < 0 && millis() - t0 < kWriteRspTimeoutMs) delay(1);
+    ok = s_rspStatus == 0;
+  }
+  if (!ok) Serial.println("[BLE] write(withResp) failed");
+  countWrite(len, ok);
+  s_rate.onWrite(ok, true, millis());
+  return ok;
+}
+
+// interner, robuster Sender: bevorzugt No-Response, fällt aber auf With-Response zurück.
+// Läuft im TX-Task; onDisconnect (Host-Task) kann die Zeiger jederzeit nullen → lokale Kopien
 static bool send_text_auto(const char* s) {
-  if (!s_client || !s_client->isConnected() || !s_charWrite) {
+  NimBLEClient* client = s_client;
+  NimBLERemoteCharacteristic* chr = s_charWrite;
+  if (!client || !client->isConnected() || (!chr && !s_rawPath)) {
     Serial.println("[BLE] send skipped: not ready");
     return false;
   }
   size_t len = strlen(s);
+  if (s_rawPath) {
+    // Kommandos passen (connectToAddr), zu lange freie Payloads weist send_wire ab
+    if (len > usablePayload()) { Serial.println("[BLE] write exceeds MTU on cached handle"); return false; }
+    return send_raw(client, s, len);
+  }
+  if (!chr) return false;
 
-  // 1) Wenn möglich: Write Without Response (schneller)
-  if (s_charWrite->canWriteNoResponse()) {
-    bool ok = s_charWrite->writeValue((uint8_t*)s, len, /*response=*/false);
-    if (ok) return true;
+  // 1) Wenn möglich: Write Without Response (schneller) – geht nur bis MTU-3
+  bool fellBack = false;
+  if (chr->canWriteNoResponse() && len <= usablePayload()) {
+    bool ok = chr->writeValue((uint8_t*)s, len, /*response=*/false);
+    if (ok) { countWrite(len, true); s_rate.onWrite(true, false, millis()); return true; }
     Serial.println("[BLE] write(noRsp) failed, trying with response...");
+    fellBack = true;   // Controller-Puffer voll: Überlastsignal für die Ratenregelung
+    s_txStats.fallbacks++;
   }
 
-  // 2) Fallback: Write With Response
-  if (s_charWrite->canWrite()) {
-    bool ok = s_charWrite->writeValue((uint8_t*)s, len, /*response=*/true);
+  // 2) Fallback: Write With Response (bei Überlänge als Long Write)
+  if (chr->canWrite()) {
+    bool ok = chr->writeValue((uint8_t*)s, len, /*response=*/true);
     if (!ok) Serial.println("[BLE] write(withResp) failed");
+    countWrite(len, ok);
+    s_rate.onWrite(ok, fellBack, millis());
     return ok;
   }
 
   Serial.println("[BLE] send skipped: char not writable");
+  countWrite(len, false);
+  return false;
+}
+// ---------- Koaleszier-Slots → ein Array-Write ----------
+static bool hasPendingSlots() {
+  for (int i = 0; i < kSlotCount; ++i) if (s_slots[i].used) return true;
   return false;
 }
+
+// Baut "[{..},{..}]\n" aus allen belegten Slots in Aktualisierungs-Reihenfolge.
+// Was nicht mehr in cap passt, bleibt für den nächsten Write liegen. Das erste
+// Kommando wird immer genommen (bei MTU 23 ist schon eins zu lang → Long Write).
+static size_t buildBatch(char* out, size_t cap, uint32_t& takenMask) {
+  takenMask = 0;
+  size_t n = 1;
+  out[0] = '[';
+  for (;;) {
+    int pick = -1;
+    for (int i = 0; i < kSlotCount; ++i) {
+      if (!s_slots[i].used || (takenMask & (1u << i))) continue;
+      if (pick < 0 || (int32_t)(s_slots[i].seq - s_slots[pick].seq) < 0) pick = i;
+    }
+    if (pick < 0) break;
+    const blecmd::Cmd& c = s_slots[pick].cmd;
+    const size_t sep = takenMask ? 1 : 0;
+    if (takenMask && n + sep + c.len + 3 > cap) break;   // "]\n\0" muss noch passen
+    if (sep) out[n++] = ',';
+    memcpy(out + n, c.s, c.len);
+    n += c.len;
+    takenMask |= 1u << pick;
+  }
+  out[n++] = ']';
+  out[n++] = '\n';
+  out[n]   = '\0';
+  return takenMask ? n : 0;
+}
+
+// Packt die Slots in Writes bis zur nutzbaren MTU; ein Kommando wird nie zerteilt.
+// Slot → gemeldetes Feld (nur Werte, die das Gerät direkt zurückmeldet)
+static int8_t probeField(int slot) {
+  switch ((TxSlot)slot) {
+    case TxSlot::Speed:     return DevSpeed;
+    case TxSlot::Stroke:    return DevStroke;
+    case TxSlot::Depth:     return DevDepth;
+    case TxSlot::Sensation: return DevSensation;
+    case TxSlot::Pattern:   return DevPattern;
+    default:                return -1;
+  }
+}
+
+static void armProbe(int slot, uint32_t nowMs) {
+  const int8_t f = probeField(slot);
+  if (f < 0 || s_slots[slot].val == kNoVal) return;
+  if (s_probe.field >= 0 && s_probe.field != f) return;
+  RttProbe& p = s_probe;
+  if (p.field < 0) p.n = 0;
+  if (p.n == 4) {   // ältesten verwerfen
+    memmove(p.val, p.val + 1, 3 * sizeof(p.val[0]));
+    memmove(p.sentMs, p.sentMs + 1, 3 * sizeof(p.sentMs[0]));
+    p.n = 3;
+  }
+  p.field = f;
+  p.val[p.n] = s_slots[slot].val;
+  p.sentMs[p.n] = nowMs;
+  p.n++;
+}
+
+// Probe auflösen: Gerät meldet einen der Werte mit Zeitstempel nach dessen Write
+static void checkProbe(uint32_t nowMs) {
+  RttProbe& p = s_probe;
+  if (p.field < 0) return;
+  if (nowMs - p.sentMs[p.n - 1] > kProbeTimeoutMs) { p.field = -1; return; }
+  const DeviceState d = deviceStateGet();
+  const DevField f = (DevField)p.field;
+  if (!d.has(f)) return;
+  for (int i = p.n - 1; i >= 0; --i) {
+    if (d.val[f] != p.val[i] || (int32_t)(d.tMs[f] - p.sentMs[i]) < 0) continue;
+    s_rate.onRtt(d.tMs[f] - p.sentMs[i], nowMs);
+    p.field = -1;
+    return;
+  }
+}
+
+// freie Payload aus bleSendJSON (eigener Write); Kopie, weil loop() nachschreiben darf
+static bool flushRaw() {
+  char buf[kMaxPending];
+  portENTER_CRITICAL(&s_rawMux);
+  const bool has = s_hasRawPending;
+  if (has) memcpy(buf, s_rawPending, sizeof buf);
+  portEXIT_CRITICAL(&s_rawMux);
+  if (!has || !send_text_auto(buf)) return false;
+  portENTER_CRITICAL(&s_rawMux);
+  if (strcmp(buf, s_rawPending) == 0) { s_hasRawPending = false; s_rawCritical = false; }   // sonst neuere Payload
+  portEXIT_CRITICAL(&s_rawMux);
+  return true;
+}
+
+static bool flushPending() {
+  bool sent = false;
+  if (s_hasRawPending) {
+    if (!flushRaw()) return false;
+    sent = true;
+  }
+  const size_t cap = std::min(sizeof(s_txBuf), usablePayload() + 1);   // +1 für '\0'
+  while (hasPendingSlots()) {
+    uint32_t mask = 0;
+    if (buildBatch(s_txBuf, cap, mask) == 0) break;
+    if (!send_text_auto(s_txBuf)) break;
+    const uint32_t nowUs = micros();
+    const uint32_t nowMs = millis();
+    for (int i = 0; i < kSlotCount; ++i) {
+      if (!(mask & (1u << i))) continue;
+      armProbe(i, nowMs);
+      s_slots[i].used = false;
+      s_sentVal[i] = s_slots[i].val;
+      s_txStats.cmds++;
+      perfRecord(PerfStage::EnqueueToWire, nowUs - s_slots[i].tUs);
+    }
+    sent = true;
+  }
+  return sent;
+}
+
+static void updateTxStatsWindow(uint32_t now) {
+  const uint32_t el = now - s_statWinStartMs;
+  if (el < 1000) return;
+  s_txStats.writesPerSec  = s_statWinWrites * 1000.0f / (float)el;
+  s_txStats.bytesPerWrite = s_statWinWrites ? (float)s_statWinBytes / (float)s_statWinWrites : 0.0f;
+  s_statWinStartMs = now;
+  s_statWinWrites  = 0;
+  s_statWinBytes   = 0;
+#if BLE_TX_STATS_LOG_MS > 0
+  static uint32_t lastLog = 0;
+  if (now - lastLog >= BLE_TX_STATS_LOG_MS) {
+    lastLog = now;
+    Serial.printf("[BLE] tx: mtu=%u %.1f writes/s %.1f B/write rate=%.0f Hz rtt=%.0f ms (total %lu writes, %lu cmds, %lu failed, %lu fallbacks, %lu drops, %lu moves replaced)\n",
+                  (unsigned)s_mtu, s_txStats.writesPerSec, s_txStats.bytesPerWrite, s_rate.hz(), s_rate.srttMs(),
+                  (unsigned long)s_txStats.writes, (unsigned long)s_txStats.cmds, (unsigned long)s_txStats.failed,
+                  (unsigned long)s_txStats.fallbacks, (unsigned long)s_rate.decreases(),
+                  (unsigned long)s_txStats.moveReplaced);
+  }
+#endif
+}
+
+BleTxStats ble_tx_stats() {
+  BleTxStats st = s_txStats;   // Summen aus dem TX-Task, ungelockt gelesen (nur Anzeige/Statistik)
+  st.mtu = s_mtu;
+  st.queueDepth = s_txRing.size();
+  st.queueHigh = s_txRing.highWater();
+  st.queueDrops = s_txRing.drops();
+  st.rateDrops = s_rate.decreases();
+  st.rateHz = s_rate.hz();
+  st.rttMs = s_rate.srttMs();
+  return st;
+}
+
+void bleSetMaxRateHz(int hz) { s_rate.setBounds(s_rate.minHz(), (float)hz); }
+void bleSetMinRateHz(int hz) { s_rate.setBounds((float)hz, s_rate.maxHz()); }
+
+// ---------- TX-Task ----------
+// Wert, den das Gerät schon meldet und der zuletzt auch so gesendet wurde: nichts senden,
+// einen noch wartenden anderen Wert derselben Aktion verwerfen
+static bool alreadyReflected(int slot, DevField f, int v) {
+  const int16_t sent = s_sentVal[slot];
+  if (sent != kNoVal && sent != v) return false;
+  if (!deviceReflects(f, v)) return false;
+  s_slots[slot].used = false;
+  s_txStats.skipped++;
+  return true;
+}
+
+static void sendCritical(const TxReq& r) {
+  char wire[blecmd::kMaxWire];
+  blecmd::frame(wire, r.cmd);
+  s_lastSendMs = millis();
+  if (!send_text_auto(wire)) return;
+  s_sentVal[r.slot] = r.val;
+  s_txStats.cmds++;
+  perfRecord(PerfStage::EnqueueToWire, micros() - r.tUs);
+}
+
+// Ring → Slots (neuester Wert je Aktion gewinnt); critical geht sofort raus
+static void drainTxRing() {
+  TxReq r;
+  while (s_txRing.pop(r)) {
+    if (r.field >= 0 && alreadyReflected(r.slot, (DevField)r.field, r.val)) continue;
+    if (r.critical) { sendCritical(r); continue; }
+    PendingCmd& p = s_slots[r.slot];
+    if (!p.used) p.tUs = r.tUs;   // Latenz ab dem ältesten wartenden Wert
+    else if (r.slot == (uint8_t)TxSlot::Move) s_txStats.moveReplaced++;
+    p.cmd  = r.cmd;
+    p.seq  = ++s_slotSeq;
+    p.val  = r.val;
+    p.used = true;
+  }
+}
+
+static bool txGateOpen(uint32_t now) {
+  return s_lastSendMs == 0 || (now - s_lastSendMs) >= s_rate.intervalMs() || s_rawCritical;
+}
+
+// Statistik, Ratenregelung, fällige Slots in Writes packen
+static void txPump() {
+  if (s_state != BleState::Connected) return;
+  const uint32_t now = millis();
+  updateTxStatsWindow(now);
+  checkProbe(now);
+  s_rate.update(now);
+  if (!s_hasRawPending && !hasPendingSlots()) return;
+  if (!txGateOpen(now)) {
+    s_rate.onBacklog();   // Takt bremst gerade – darf schneller werden, wenn die Strecke mitspielt
+    return;
+  }
+  if (flushPending()) s_lastSendMs = now;
+}
+
+// Schlafdauer bis zum nächsten fälligen Write; ohne Verbindung bis zum nächsten Wecken
+static TickType_t txWaitTicks() {
+  if (s_state != BleState::Connected) return portMAX_DELAY;
+  if (!s_hasRawPending && !hasPendingSlots()) return pdMS_TO_TICKS(kTxIdleWakeMs);
+  const uint32_t el = millis() - s_lastSendMs;
+  const uint32_t iv = s_rate.intervalMs();
+  return pdMS_TO_TICKS(el < iv ? std::max<uint32_t>(iv - el, 1) : 1);
+}
+
+static void txTask(void*) {
+  for (;;) {
+    const uint32_t woken = ulTaskNotifyTake(pdTRUE, txWaitTicks());
+    // Takt offen: noch 1 Tick sammeln, damit die Kommandos eines loop()-Durchlaufs
+    // im selben Write landen statt das erste allein den Takt zu verbrauchen
+    if (woken && s_state == BleState::Connected && txGateOpen(millis())) vTaskDelay(1);
+    drainTxRing();
+    txPump();
+  }
+}
+
+static void startTxTask() {
+  // Protokoll-Kern wie NimBLE-Host und Connect-Task; über dem Connect-Task, damit
+  // Kommandos nicht hinter dessen Polling warten
+  if (xTaskCreatePinnedToCore(txTask, "bletx", 4096, nullptr, 2, &s_txTask, PRO_CPU_NUM) != pdPASS) {
+    Serial.println("[BLE] tx task failed");
+    s_txTask = nullptr;
+  }
+}
+
+// TX-Task wecken (bleSend* tun das selbst; z.B. nach dem Verbindungsaufbau)
+void blePump() {
+  if (s_txTask) xTaskNotifyGive(s_txTask);
+}
+
+static bool enqueue(const TxReq& r) {
+  if (!s_txRing.push(r)) {
+    Serial.println("[BLE] tx queue full, dropped");
+    return false;
+  }
+  blePump();
+  return true;
+}
+
 // ---------- Tick (in loop() aufrufen) ----------
 void ble_tick() {
   if (!s_inited) return;
@@ -267,139 +937,185 @@ void ble_tick() {
       // nichts
       break;
 
-    case BleState::Scanning:
+    case BleState::Scanning: {
       // auf Treffer warten; wenn da: Scan stoppen und verbinden
-      if (s_hitPending) {
-        s_hitPending = false;
-        String target = s_hitAddrStr;
-        s_hitAddrStr = "";
-        stopScan();
-        goState(BleState::Connecting, 50); // kleine Atempause
-        // Adresse für nächsten Schritt merken:
-        s_peerAddr = target;  // temporär als "Ziel"
-      }
+      ScanHit hit;
+      uint32_t seq = 0;
+      if (!readHit(hit, seq)) break;
+#if BLE_SCAN_PICK_MS > 0
+      if (millis() - hit.firstMs < BLE_SCAN_PICK_MS) break;   // stärkeres abwarten
+#endif
+      if (seq == s_hitSeen) break;
+      s_hitSeen = seq;
+      const NimBLEAddress target(hit.addr, hit.type);
+      Serial.printf("[HIT] OSSM @ %s RSSI %d via %s\n", target.toString().c_str(), hit.rssi,
+                    hit.via == 3 ? "name+uuid" : (hit.via == 1 ? "name" : "uuid"));
+      stopScan();
+      goState(BleState::Connecting, 50); // kleine Atempause
+      // Adresse für nächsten Schritt merken:
+      s_peerAddr = target.toString().c_str();  // temporär als "Ziel"
+      s_peerAddrType = hit.type;
       break;
+    }
 
-    case BleState::Connecting:
+    case BleState::Connecting: {
       if (!due()) break;
-      if (s_peerAddr.length() == 0) {
-        Serial.println("[BLE] no target addr?");
-        goState(BleState::Backoff, 200);
+      if (!s_connStarted) {
+        const bool cached = s_tryCached;
+        s_tryCached = false;
+        if (!cached && s_peerAddr.length() == 0) {
+          Serial.println("[BLE] no target addr?");
+          goState(BleState::Backoff, 200);
+          break;
+        }
+        const NimBLEAddress addr = cached ? NimBLEAddress(s_cache.addr, s_cache.addrType)
+                                          : NimBLEAddress(std::string(s_peerAddr.c_str()), s_peerAddrType);
+        if (startConnect(addr, cached)) s_connStarted = true;
+        else goState(BleState::Backoff, 300);
         break;
       }
-      if (connectToAddr(s_peerAddr)) {
+      // Aufbau läuft im Connect-Task: nur Phase und Timeout prüfen
+      const ConnPhase ph = connPhase();
+      if (ph != ConnPhase::Ready && ph != ConnPhase::Failed) { checkConnTimeout(ph); break; }
+      s_connStarted = false;
+      setPhase(ConnPhase::Idle);
+      const bool cached = s_connCached;
+      if (ph == ConnPhase::Ready && s_client && s_client->isConnected()) {
+        s_peerAddr = s_connAddr.toString().c_str();
+        s_peerAddrType = s_connAddr.getType();
+        linkUp();
         goState(BleState::Connected);
+        blePump();   // wartende Slots + Statistik-Takt
+        break;
+      }
+      s_client = nullptr;
+      s_charWrite = nullptr;
+      s_charNotify = nullptr;
+      s_rawPath = false;
+      if (ph == ConnPhase::Ready) {
+        // zwischen Ready und hier getrennt: wie ein Linkverlust behandeln
+        s_linkT0Ms = millis();
+        s_peerAddr = "";
+        goState(BleState::Backoff, 300);
+      } else if (cached) {
+        // Gerät unter der gespeicherten Adresse nicht erreichbar: normal scannen
+        s_link.cacheMisses++;
+        s_peerAddr = "";
+        startPassiveScanForever();
+        goState(BleState::Scanning);
       } else {
         s_peerAddr = "";
         goState(BleState::Backoff, 300);
       }
       break;
+    }
 
     case BleState::Connected:
-      if (s_hasPending){
-        const uint32_t now = millis();
-        if (s_lastSendMs == 0 || (now - s_lastSendMs) >= s_minIntervalMs) {
-          if(send_text_auto(s_pending.c_str())){
-            s_lastSendMs = now;
-            s_hasPending = false;
-          }
-        }
-      }
+      // Senden läuft im TX-Task
       break;
 
     case BleState::Backoff:
       if (!due()) break;
-      // zurück in Scan
-      s_hitPending = false;
-      s_hitAddrStr = "";
-      startPassiveScanForever();
-      goState(BleState::Scanning);
+      // erst der Cache, dann Scan
+      startLinkSearch();
       break;
   }
 }
 // --- JSON/Command API --------------------------------------------------------
 
-bool bleSendJSON(const String& payload, bool critical) {
+// freie JSON-Payloads: eigener Write im TX-Task, critical (z.B. Home/Retract/Extend/Disable)
+// ohne Ratentakt. Eine noch nicht gesendete Payload wird ersetzt.
+static bool send_wire(const char* wire, size_t len, bool critical) {
   if (!ble_is_connected()) return false;
-    const uint32_t now = millis();
-    String wire = payload + "\n";
-  if (critical) {// z.B. Home/Retract/Extend/Disable
-    s_lastSendMs = now;
-    return send_text_auto(wire.c_str());
-  } else {
-    s_pending = wire;
-    s_hasPending = true;
-    return true;
+  if (len >= kMaxPending || (s_rawPath && len > usablePayload())) {   // rohes Handle: kein Long Write
+    Serial.println("[BLE] payload too long, dropped");
+    return false;
   }
+  portENTER_CRITICAL(&s_rawMux);
+  memcpy(s_rawPending, wire, len + 1);
+  s_hasRawPending = true;
+  s_rawCritical = s_rawCritical || critical;
+  portEXIT_CRITICAL(&s_rawMux);
+  blePump();
+  return true;
 }
 
-// Feste API Calls
-void bleSendConnected() {
-  bleSendJSON(F("[{\"action\":\"connected\"}]"));
+// Kommandos in den Ring; der TX-Task legt sie in den Slot der Aktion (überschreibt nur
+// dieselbe Aktion) bzw. sendet critical sofort
+static bool sendCmd(TxSlot slot, const blecmd::Cmd& c, bool critical = false, int16_t val = kNoVal,
+                    int8_t field = -1) {
+  if (!ble_is_connected()) return false;
+  perfInputEnqueued();
+  TxReq r;
+  r.cmd = c;
+  r.tUs = micros();
+  r.val = val;
+  r.slot = (uint8_t)slot;
+  r.field = field;
+  r.critical = critical;
+  return enqueue(r);
 }
 
-void bleSendHome() {
-  bleSendJSON(F("[{\"action\":\"home\"}]"));
+// Werte mit Rückmeldung: der TX-Task verwirft sie, wenn das Gerät sie schon meldet
+static void sendValue(TxSlot slot, DevField f, const blecmd::Cmd& c, int v) {
+  sendCmd(slot, c, false, (int16_t)v, (int8_t)f);
 }
 
-void bleSendDisable() {
-  bleSendJSON(F("[{\"action\":\"disable\"}]"));
+bool bleSendJSON(const String& payload, bool critical) {
+  char wire[kMaxPending];
+  const size_t n = payload.length();
+  if (n + 2 > sizeof(wire)) {
+    Serial.println("[BLE] payload too long, dropped");
+    return false;
+  }
+  memcpy(wire, payload.c_str(), n);
+  wire[n] = '\n';
+  wire[n + 1] = '\0';
+  return send_wire(wire, n + 1, critical);
 }
 
-void bleSendStartStreaming() {
-  bleSendJSON(F("[{\"action\":\"startStreaming\"}]"));
-}
+// Feste API Calls
+void bleSendConnected()      { sendCmd(TxSlot::Connected, blecmd::make(blecmd::kConnected)); }
+void bleSendHome()           { sendCmd(TxSlot::Home, blecmd::make(blecmd::kHome)); }
+void bleSendDisable()        { sendCmd(TxSlot::Disable, blecmd::make(blecmd::kDisable)); }
+void bleSendStartStreaming() { sendCmd(TxSlot::StartStreaming, blecmd::make(blecmd::kStartStreaming)); }
 
 void bleSendSpeed(int v) {
   v = clampi(v, 0, 100);
-  if (v == 0) {
-    bleSendJSON(F("[{\"action\":\"stop\"}]"));
-  } else {
-    String s = String(F("[{\"action\":\"setSpeed\",\"speed\":")) + v + F("}]");
-    bleSendJSON(s);
-  }
+  if (v == 0) sendValue(TxSlot::Speed, DevSpeed, blecmd::make(blecmd::kStop), 0);
+  else        sendValue(TxSlot::Speed, DevSpeed, blecmd::makeInt(blecmd::kSetSpeed, v), v);
 }
 
 void bleSendStroke(int v) {
   v = clampi(v, 0, 100);
-  String s = String(F("[{\"action\":\"setStroke\",\"stroke\":")) + v + F("}]");
-  bleSendJSON(s);
+  sendValue(TxSlot::Stroke, DevStroke, blecmd::makeInt(blecmd::kSetStroke, v), v);
 }
 
 void bleSendDepth(int v) {
   v = clampi(v, 0, 100);
-  String s = String(F("[{\"action\":\"setDepth\",\"depth\":")) + v + F("}]");
-  bleSendJSON(s);
+  sendValue(TxSlot::Depth, DevDepth, blecmd::makeInt(blecmd::kSetDepth, v), v);
 }
 
 void bleSendMove(int pos, int ms, bool replace) {
-  pos = clampi(pos, 0, 100);
-  ms  = clampi(ms, 50, 2000);
-  String s = String(F("[{\"action\":\"move\",\"position\":")) + pos +
-             F(",\"time\":") + ms +
-             F(",\"replace\":") + (replace ? F("true") : F("false")) + F("}]");
-  bleSendJSON(s);
+  sendCmd(TxSlot::Move, blecmd::makeMove(clampi(pos, 0, 100), clampi(ms, 50, 2000), replace));
 }
 
 void bleSendSensation(int v) {
-  if (v < -100) v = -100; else if (v > 100) v = 100;
-  String s = String(F("[{\"action\":\"setSensation\",\"sensation\":")) + v + F("}]");
-  bleSendJSON(s);
+  v = clampi(v, -100, 100);
+  sendValue(TxSlot::Sensation, DevSensation, blecmd::makeInt(blecmd::kSetSensation, v), v);
 }
 
-void bleSendPattern(int patternIndex) {
-  String s = String(F("[{\"action\":\"setPattern\",\"pattern\":")) + patternIndex + F("}]");
-  bleSendJSON(s);
+void bleSendPattern(int patternId) {
+  sendValue(TxSlot::Pattern, DevPattern, blecmd::makeInt(blecmd::kSetPattern, patternId), patternId);
 }
 
 void bleSendSetPhysicalTravel(int mm) {
   if (mm < 1) mm = 1;
-  String s = String(F("[{\"action\":\"setPhysicalTravel\",\"travel\":")) + mm + F("}]");
-  bleSendJSON(s);
+  sendCmd(TxSlot::Travel, blecmd::makeInt(blecmd::kSetTravel, mm));
 }
 
-void bleSendRetract() {  bleSendJSON(F("[{\"action\":\"retract\"}]")); }
-void bleSendExtend()  {  bleSendJSON(F("[{\"action\":\"extend\"}]"));  }
-void bleSendAirIn()   {  bleSendJSON(F("[{\"action\":\"airIn\"}]"));   }
-void bleSendAirOut()  {  bleSendJSON(F("[{\"action\":\"airOut\"}]"));  }
-
+void bleSendRetract() {  sendCmd(TxSlot::Retract, blecmd::make(blecmd::kRetract)); }
+void bleSendExtend()  {  sendCmd(TxSlot::Extend,  blecmd::make(blecmd::kExtend));  }
+void bleSendAirIn()   {  sendCmd(TxSlot::AirIn,   blecmd::make(blecmd::kAirIn));   }
+void bleSendAirOut()  {  sendCmd(TxSlot::AirOut,  blecmd::make(blecmd::kAirOut));  }
+void bleSendGetPatterns() { sendCmd(TxSlot::Catalog, blecmd::make(blecmd::kGetPatterns)); }
@@ -15,12 +15,57 @@ void ble_auto_start();
 
 // In loop() regelmäßig aufrufen
 void ble_tick();
-void bleSetMaxRateHz(int hz);   // z.B. 30
-void blePump();                 // im loop() aufrufen
+// TX-Rate regelt sich adaptiv zwischen Unter- und Obergrenze (ble_rate.h)
+void bleSetMaxRateHz(int hz);   // z.B. 60
+void bleSetMinRateHz(int hz);   // z.B. 10
+void blePump();                 // weckt den TX-Task (Senden läuft dort, nicht in loop())
+
+// TX-Statistik (Summen seit Boot, Raten über das letzte 1-s-Fenster)
+typedef struct {
+  uint16_t mtu;            // ausgehandelte ATT-MTU (nutzbar pro Write: mtu-3)
+  uint32_t writes;         // erfolgreiche GATT-Writes
+  uint32_t bytes;          // übertragene Nutzbytes
+  uint32_t cmds;           // in Writes gepackte Kommandos
+  uint32_t failed;         // fehlgeschlagene Writes
+  uint32_t skipped;        // entfallen, weil das Gerät den Wert schon meldet
+  uint32_t moveReplaced;   // move im Slot durch ein neueres ersetzt, bevor es gesendet war
+  uint32_t fallbacks;      // No-Response abgelehnt → With-Response
+  uint32_t rateDrops;      // Senkungen der TX-Rate (Überlast erkannt)
+  float    rateHz;         // aktuelle TX-Rate
+  float    rttMs;          // geglättete Laufzeit Write → Gerät meldet den Wert (0 = unbekannt)
+  uint32_t queueDepth;     // Kommandos im Ring zum TX-Task (jetzt)
+  uint32_t queueHigh;      // Höchststand seit Boot
+  uint32_t queueDrops;     // Ring voll → verworfen
+  float    bytesPerWrite;
+  float    writesPerSec;
+} BleTxStats;
+BleTxStats ble_tx_stats();
+
+// Verbindungsaufbau: Peer-Cache (NVS) vs. Scan + Discovery, Zeiten ab Boot bzw. Linkverlust
+typedef struct {
+  uint32_t connects;        // aufgebaute Verbindungen
+  uint32_t cachedConnects;  // davon über gecachte Adresse + Handles (ohne Scan/Discovery)
+  uint32_t cacheMisses;     // Cache-Versuch gescheitert → Scan bzw. Discovery
+  uint32_t readyMs;         // letzter Aufbau: bis Kommandos möglich sind
+  uint32_t firstCmdMs;      // letzter Aufbau: bis zum ersten Kommando auf der Luft (0 = noch keins)
+  bool     cached;          // letzter Aufbau lief über den Cache
+} BleLinkStats;
+BleLinkStats ble_link_stats();
 
 // Status-Helpers
 bool        ble_is_connected();
 bool        ble_is_scanning();
+
+// Fortschritt des Verbindungsaufbaus (fürs UI; der Aufbau selbst läuft im Connect-Task)
+typedef enum {
+  BLE_LINK_IDLE,          // nicht gestartet
+  BLE_LINK_SCANNING,      // sucht OSSM (Scan/Backoff)
+  BLE_LINK_CONNECTING,    // Verbindungsaufbau + MTU
+  BLE_LINK_DISCOVERING,   // Service/Characteristic suchen
+  BLE_LINK_SUBSCRIBING,   // Notifications einschalten
+  BLE_LINK_READY
+} BleLinkPhase;
+BleLinkPhase ble_link_phase();
 const char* ble_peer_addr();   // z.B. "58:8c:81:af:6a:96" oder "" wenn unbekannt
 
 // --- JSON/Command API --------------------------------------------------------
@@ -36,8 +81,8 @@ void bleSendStartStreaming();
 void bleSendSpeed(int v);            // 0..100 (0 → stop)
 void bleSendStroke(int v);           // 0..100
 void bleSendDepth(int v);            // 0..100
-void bleSendMove(int pos, int ms, bool replace);  // pos 0..100, ms 50..2000
-void bleSendPattern(int patternIndex); 
+void bleSendMove(int pos, int ms, bool replace);  // pos 0..100, ms 50..2000; ungesendetes move wird ersetzt
+void bleSendPattern(int patternId);   // ID aus dem Musterkatalog (catalogId)
 
 void bleSendSensation(int v);        // -100..+100
 void bleSendSetPhysicalTravel(int mm);
@@ -46,6 +91,7 @@ void bleSendRetract();
 void bleSendExtend();
 void bleSendAirIn();
 void bleSendAirOut();
+void bleSendGetPatterns();           // Musterkatalog anfordern (pattern_catalog.h)
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,53 @@
+#pragma once
+// OSSM-Erkennung direkt auf den rohen Advertisement-Bytes (AD-Strukturen: Länge, Typ, Daten).
+// Läuft im BLE-Host-Task für jedes empfangene Advertisement – daher ohne Heap, ohne
+// UUID-Objekte, ohne String-Kopien.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace bleadv {
+
+// e5560000-6a2d-436f-a43d-82eab88dcefd, wie im Payload little-endian
+static constexpr uint8_t kSvcUuidLE[16] = { 0xfd, 0xce, 0x8d, 0xb8, 0xea, 0x82, 0x3d, 0xa4,
+                                            0x6f, 0x43, 0x2d, 0x6a, 0x00, 0x00, 0x56, 0xe5 };
+static constexpr char    kNameNeedle[]  = "OSSM";
+
+enum : uint8_t {
+  kAdUuid128Incomplete = 0x06,
+  kAdUuid128Complete   = 0x07,
+  kAdNameShort         = 0x08,
+  kAdNameComplete      = 0x09,
+};
+
+inline bool containsNeedle(const uint8_t* p, size_t n) {
+  const size_t k = sizeof(kNameNeedle) - 1;
+  for (size_t i = 0; i + k <= n; ++i)
+    if (p[i] == (uint8_t)kNameNeedle[0] && memcmp(p + i, kNameNeedle, k) == 0) return true;
+  return false;
+}
+
+struct Match { bool name; bool uuid; };
+
+// Abgeschnittene/kaputte Strukturen beenden die Suche (was bis dahin passte, zählt)
+inline Match match(const uint8_t* p, size_t len) {
+  Match m = { false, false };
+  size_t i = 0;
+  while (i < len) {
+    const uint8_t l = p[i];
+    if (l == 0 || i + 1 + l > len) break;
+    const uint8_t type = p[i + 1];
+    const uint8_t* d = p + i + 2;
+    const size_t n = l - 1;
+    if (type == kAdNameComplete || type == kAdNameShort) {
+      m.name = m.name || containsNeedle(d, n);
+    } else if (type == kAdUuid128Complete || type == kAdUuid128Incomplete) {
+      for (size_t u = 0; u + 16 <= n; u += 16)
+        if (memcmp(d + u, kSvcUuidLE, 16) == 0) { m.uuid = true; break; }
+    }
+    i += 1 + l;
+  }
+  return m;
+}
+
+}  // namespace bleadv
@@ -0,0 +1,137 @@
+#pragma once
+// Heap-freier JSON-Encoder für die OSSM-Kommandos.
+// Alle festen Teile ("{\"action\":\"setSpeed\",\"speed\":" usw.) werden zur
+// Compile-Zeit zusammengesetzt und liegen im Flash; zur Laufzeit wird nur noch
+// memcpy + Integer-Formatierung in einen Stack-Puffer gemacht.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace blecmd {
+
+// ---------- Compile-Zeit-Strings ----------
+template <size_t N>
+struct FixedStr {
+  char s[N + 1] {};
+  static constexpr size_t size() { return N; }
+};
+
+template <size_t N>
+constexpr FixedStr<N - 1> lit(const char (&in)[N]) {
+  FixedStr<N - 1> out{};
+  for (size_t i = 0; i < N - 1; ++i) out.s[i] = in[i];
+  return out;
+}
+
+template <size_t A, size_t B>
+constexpr FixedStr<A + B> operator+(const FixedStr<A>& a, const FixedStr<B>& b) {
+  FixedStr<A + B> out{};
+  for (size_t i = 0; i < A; ++i) out.s[i] = a.s[i];
+  for (size_t i = 0; i < B; ++i) out.s[A + i] = b.s[i];
+  return out;
+}
+
+// {"action":"<name>"   (Objekt bleibt offen)
+template <size_t N>
+constexpr auto head(const char (&action)[N]) { return lit("{\"action\":\"") + lit(action) + lit("\""); }
+
+// ,"<key>":
+template <size_t N>
+constexpr auto key(const char (&k)[N]) { return lit(",\"") + lit(k) + lit("\":"); }
+
+// {"action":"<name>"}  (Kommando ohne Parameter)
+template <size_t N>
+constexpr auto bare(const char (&action)[N]) { return head(action) + lit("}"); }
+
+// "00".."99" als Tabelle – halbiert die Divisionen beim Formatieren
+struct DigitPairs { char s[200]; };
+constexpr DigitPairs makeDigitPairs() {
+  DigitPairs t{};
+  for (int i = 0; i < 100; ++i) { t.s[2 * i] = char('0' + i / 10); t.s[2 * i + 1] = char('0' + i % 10); }
+  return t;
+}
+inline constexpr DigitPairs kDigitPairs = makeDigitPairs();
+
+// ---------- Templates (Flash) ----------
+inline constexpr auto kConnected      = bare("connected");
+inline constexpr auto kHome           = bare("home");
+inline constexpr auto kDisable        = bare("disable");
+inline constexpr auto kStartStreaming = bare("startStreaming");
+inline constexpr auto kStop           = bare("stop");
+inline constexpr auto kRetract        = bare("retract");
+inline constexpr auto kExtend         = bare("extend");
+inline constexpr auto kAirIn          = bare("airIn");
+inline constexpr auto kAirOut         = bare("airOut");
+inline constexpr auto kGetPatterns    = bare("getPatterns");
+
+inline constexpr auto kSetSpeed     = head("setSpeed")          + key("speed");
+inline constexpr auto kSetStroke    = head("setStroke")         + key("stroke");
+inline constexpr auto kSetDepth     = head("setDepth")          + key("depth");
+inline constexpr auto kSetSensation = head("setSensation")      + key("sensation");
+inline constexpr auto kSetPattern   = head("setPattern")        + key("pattern");
+inline constexpr auto kSetTravel    = head("setPhysicalTravel") + key("travel");
+inline constexpr auto kMovePos      = head("move")              + key("position");
+inline constexpr auto kMoveTime     = key("time");
+inline constexpr auto kMoveReplace  = key("replace");
+
+// ---------- Laufzeit: ein Kommando-Objekt {...} im Stack-Puffer ----------
+constexpr size_t kMaxInt = 11;   // "-2147483648"
+constexpr size_t kMaxCmd = 96;   // längstes Objekt (move) + Reserve
+
+static_assert(kMovePos.size() + kMoveTime.size() + kMoveReplace.size() + 3 * kMaxInt + 1 <= kMaxCmd,
+              "kMaxCmd zu klein für move");
+
+struct Cmd {
+  char   s[kMaxCmd];
+  uint8_t len = 0;
+
+  template <size_t N>
+  Cmd& put(const FixedStr<N>& f) {
+    static_assert(N <= kMaxCmd, "Template größer als Kommando-Puffer");
+    memcpy(s + len, f.s, N); len += N;
+    return *this;
+  }
+  Cmd& putInt(int v) {
+    char tmp[kMaxInt];
+    char* p = tmp + kMaxInt;
+    uint32_t u = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+    while (u >= 100) { const uint32_t r = (u % 100) * 2; u /= 100; p -= 2; p[0] = kDigitPairs.s[r]; p[1] = kDigitPairs.s[r + 1]; }
+    if (u >= 10) { p -= 2; p[0] = kDigitPairs.s[u * 2]; p[1] = kDigitPairs.s[u * 2 + 1]; }
+    else         { *--p = char('0' + u); }
+    if (v < 0) *--p = '-';
+    const size_t n = (size_t)(tmp + kMaxInt - p);
+    memcpy(s + len, p, n); len += (uint8_t)n;
+    return *this;
+  }
+  Cmd& putBool(bool b) {
+    static constexpr auto kTrue  = lit("true");
+    static constexpr auto kFalse = lit("false");
+    return b ? put(kTrue) : put(kFalse);
+  }
+  Cmd& close() { s[len++] = '}'; return *this; }
+};
+
+template <size_t N>
+inline Cmd make(const FixedStr<N>& f) { Cmd c; c.put(f); return c; }
+
+template <size_t N>
+inline Cmd makeInt(const FixedStr<N>& prefix, int v) { Cmd c; c.put(prefix).putInt(v).close(); return c; }
+
+inline Cmd makeMove(int pos, int ms, bool replace) {
+  Cmd c;
+  c.put(kMovePos).putInt(pos).put(kMoveTime).putInt(ms).put(kMoveReplace).putBool(replace).close();
+  return c;
+}
+
+// Wire-Rahmen: "[" obj "]\n"  → out muss kMaxWire Bytes fassen, liefert Länge (ohne '\0')
+constexpr size_t kMaxWire = kMaxCmd + 4;
+inline size_t frame(char* out, const Cmd& c) {
+  out[0] = '[';
+  memcpy(out + 1, c.s, c.len);
+  out[1 + c.len] = ']';
+  out[2 + c.len] = '\n';
+  out[3 + c.len] = '\0';
+  return (size_t)c.len + 3;
+}
+
+}  // namespace blecmd
@@ -0,0 +1,56 @@
+#include "ble_rate.h"
+
+static const uint32_t kIncPeriodMs = 250;    // Erhöhung höchstens 4x pro Sekunde
+static const float    kAddHz       = 1.0f;   // … um je 1 Hz
+static const float    kDecFactor   = 0.75f;
+static const uint32_t kHoldMs      = 300;    // nach einer Senkung: Folgesignale derselben Überlast ignorieren
+static const float    kRttSlackMs  = 80.0f;  // Notify-Takt des Geräts (~100 ms) steckt im Rauschen
+
+static inline float clampHz(float v, float lo, float hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+void TxRateCtl::setBounds(float minHz, float maxHz) {
+  if (minHz < 1.0f) minHz = 1.0f;
+  if (maxHz < minHz) maxHz = minHz;
+  _minHz = minHz;
+  _maxHz = maxHz;
+  _hz = clampHz(_hz, _minHz, _maxHz);
+}
+
+void TxRateCtl::reset(uint32_t nowMs) {
+  _hz = clampHz((float)BLE_TX_START_HZ, _minHz, _maxHz);
+  _srtt = _base = 0.0f;
+  _periodMs = nowMs;
+  _lastDecMs = nowMs - kHoldMs;
+  _limited = false;
+  _clean = true;
+}
+
+void TxRateCtl::congested(uint32_t nowMs) {
+  _congestion++;
+  _clean = false;
+  if (nowMs - _lastDecMs < kHoldMs) return;
+  _lastDecMs = nowMs;
+  _hz = clampHz(_hz * kDecFactor, _minHz, _maxHz);
+  _decreases++;
+}
+
+void TxRateCtl::onWrite(bool ok, bool fellBack, uint32_t nowMs) {
+  if (!ok || fellBack) congested(nowMs);
+}
+
+void TxRateCtl::onRtt(uint32_t rttMs, uint32_t nowMs) {
+  const float r = (float)rttMs;
+  if (_base == 0.0f || r < _base) _base = r;
+  else _base += (r - _base) * (1.0f / 64);   // langsam nachziehen, falls sich die Strecke ändert
+  _srtt = _srtt == 0.0f ? r : _srtt + (r - _srtt) * (1.0f / 8);
+  if (_srtt > 2.0f * _base + kRttSlackMs) congested(nowMs);
+}
+
+void TxRateCtl::update(uint32_t nowMs) {
+  if (nowMs - _periodMs < kIncPeriodMs) return;
+  // nur erhöhen, wenn die Rate wirklich begrenzt hat – sonst läuft sie im Leerlauf davon
+  if (_limited && _clean) _hz = clampHz(_hz + kAddHz, _minHz, _maxHz);
+  _periodMs = nowMs;
+  _limited = false;
+  _clean = true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+// Adaptive Senderate der BLE-TX-Schicht (AIMD wie bei TCP).
+// Solange Writes glatt durchgehen und tatsächlich Kommandos auf den Takt warten,
+// steigt die Rate additiv. Bei Überlast – abgelehnter No-Response-Write, Rückfall auf
+// With-Response, Notification-Laufzeit deutlich über der Basis – fällt sie multiplikativ.
+// So pendelt sich pro Maschine/Funkstrecke die höchste stabile Kommandorate ein.
+#include <stdint.h>
+
+#ifndef BLE_TX_MIN_HZ
+#define BLE_TX_MIN_HZ 10
+#endif
+#ifndef BLE_TX_MAX_HZ
+#define BLE_TX_MAX_HZ 60
+#endif
+#ifndef BLE_TX_START_HZ
+#define BLE_TX_START_HZ 30
+#endif
+
+class TxRateCtl {
+ public:
+  void setBounds(float minHz, float maxHz);
+  void reset(uint32_t nowMs);                            // bei Connect: Startrate, RTT vergessen
+  void onWrite(bool ok, bool fellBack, uint32_t nowMs);  // Ergebnis eines Sammel-Writes
+  void onRtt(uint32_t rttMs, uint32_t nowMs);            // Write → Gerät meldet den Wert
+  void onBacklog() { _limited = true; }                  // Kommandos warten auf den Takt
+  void update(uint32_t nowMs);                           // periodisch: additive Erhöhung
+
+  uint32_t intervalMs() const { return (uint32_t)(1000.0f / _hz + 0.5f); }
+  float    hz() const         { return _hz; }
+  float    minHz() const      { return _minHz; }
+  float    maxHz() const      { return _maxHz; }
+  float    srttMs() const     { return _srtt; }
+  float    baseRttMs() const  { return _base; }
+  uint32_t decreases() const  { return _decreases; }
+  uint32_t congestion() const { return _congestion; }
+
+ private:
+  void congested(uint32_t nowMs);
+
+  float    _minHz = BLE_TX_MIN_HZ, _maxHz = BLE_TX_MAX_HZ;
+  float    _hz = BLE_TX_START_HZ;
+  float    _srtt = 0.0f, _base = 0.0f;     // ms, 0 = noch keine Probe
+  uint32_t _periodMs = 0;                   // Beginn des laufenden Erhöhungs-Fensters
+  uint32_t _lastDecMs = 0;
+  bool     _limited = false;                // im Fenster durch den Takt gebremst
+  bool     _clean = true;                   // im Fenster keine Überlast
+  uint32_t _decreases = 0, _congestion = 0;
+};
@@ -0,0 +1,47 @@
+#include "device_state.h"
+#include <Arduino.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+
+static DeviceState s_dev = {};
+static volatile uint32_t s_devSeq = 0;
+static portMUX_TYPE s_devMux = portMUX_INITIALIZER_UNLOCKED;
+
+void deviceStateApply(const DeviceState& upd) {
+  if (!upd.fields) return;
+  const uint32_t now = millis();
+  portENTER_CRITICAL(&s_devMux);
+  for (int f = 0; f < DevFieldCount; ++f) {
+    if (!(upd.fields & (1u << f))) continue;
+    s_dev.val[f] = upd.val[f];
+    s_dev.tMs[f] = now;
+  }
+  if (upd.has(DevStateStr)) memcpy(s_dev.state, upd.state, sizeof(s_dev.state));
+  s_dev.fields |= upd.fields;
+  s_dev.seq = ++s_devSeq;
+  portEXIT_CRITICAL(&s_devMux);
+}
+
+DeviceState deviceStateGet() {
+  portENTER_CRITICAL(&s_devMux);
+  const DeviceState d = s_dev;
+  portEXIT_CRITICAL(&s_devMux);
+  return d;
+}
+
+uint32_t deviceStateSeq() { return s_devSeq; }
+
+void deviceStateReset() {
+  portENTER_CRITICAL(&s_devMux);
+  s_dev = DeviceState{};
+  s_dev.seq = ++s_devSeq;
+  portEXIT_CRITICAL(&s_devMux);
+}
+
+bool deviceReflects(DevField f, int v, uint32_t maxAgeMs) {
+  const uint32_t now = millis();
+  portENTER_CRITICAL(&s_devMux);
+  const bool ok = s_dev.has(f) && s_dev.val[f] == v && now - s_dev.tMs[f] <= maxAgeMs;
+  portEXIT_CRITICAL(&s_devMux);
+  return ok;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+
+// Was der OSSM selbst über seinen Zustand meldet (Notifications der Control-Char).
+// Schreiber: NimBLE-Task (Notify-Callback), Leser: loop() – Zugriff nur über die
+// Funktionen unten, die unter einem Spinlock kopieren.
+enum DevField : uint8_t {
+  DevSpeed, DevStroke, DevDepth, DevSensation, DevPattern, DevPosition, DevStateStr,
+  DevFieldCount
+};
+
+struct DeviceState {
+  uint16_t fields;                    // Bit i = DevField i wurde je gemeldet
+  int16_t  val[DevFieldCount];        // Zahlenwerte (DevStateStr: unbenutzt)
+  uint32_t tMs[DevFieldCount];        // millis() der letzten Meldung pro Feld
+  char     state[24];                 // z. B. "strokeEngine.idle"
+  uint32_t seq;                       // zählt übernommene Nachrichten
+  bool has(DevField f) const { return fields & (1u << f); }
+};
+
+void        deviceStateApply(const DeviceState& upd);   // nur gesetzte Felder übernehmen
+DeviceState deviceStateGet();
+uint32_t    deviceStateSeq();                            // ändert sich mit jeder Nachricht
+void        deviceStateReset();                          // bei (Dis)Connect
+
+// Gerät meldet Feld f mit Wert v, und die Meldung ist jünger als maxAgeMs
+bool deviceReflects(DevField f, int v, uint32_t maxAgeMs = 1500);
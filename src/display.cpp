@@ -0,0 +1,182 @@
+#include "display.h"
+#include <M5Dial.h>
+#include <esp_heap_caps.h>
+#include <algorithm>
+#include "app_state.h"
+#include "geometry.h"
+#include "palette.h"
+
+#ifndef DISPLAY_DOUBLE_BUFFER
+#define DISPLAY_DOUBLE_BUFFER 1
+#endif
+// So viel internes RAM muss nach den Framebuffern frei bleiben (NimBLE-Host, Tasks, Stacks)
+#ifndef DISPLAY_HEAP_RESERVE
+#define DISPLAY_HEAP_RESERVE (64 * 1024)
+#endif
+
+static const size_t kFrameBytes = (size_t)W * H * 2;   // RGB565
+
+#if UI_PALETTE_8BIT
+// 8-bit-Backbuffer (Paletten-Index) + zwei Streifen RGB565 für den Push: Streifen k wird
+// expandiert, während Streifen k^1 per DMA läuft. Der Backbuffer selbst wird nur von der
+// CPU gelesen, also reicht ein einziger – gezeichnet wird, sobald present() zurück ist.
+static const size_t kIdxBytes    = (size_t)W * H;
+static const int    kStripePx    = W * 16;
+static uint8_t*     s_idx        = nullptr;
+static uint16_t*    s_stripe[2]  = { nullptr, nullptr };
+#endif
+
+static uint16_t* s_buf[2]   = { nullptr, nullptr };
+static int       s_back     = 0;        // Index des Puffers, in den gezeichnet wird
+static bool      s_double   = false;
+static bool      s_dmaBusy  = false;    // Frontbuffer läuft noch zum Panel
+
+// Dirty-Rects des letzten Frames: müssen vor dem Zeichnen in den (älteren) Backbuffer
+static const int kMaxSync = 8;
+static Rect s_sync[kMaxSync];
+static int  s_syncN = 0;
+
+static DisplayStats s_stats = {};
+static uint32_t     s_renderStartUs = 0;
+
+#if !UI_PALETTE_8BIT
+static void bindBack() {
+  g_spr.setBuffer(s_buf[s_back], W, H, lgfx::color_depth_t::rgb565_2Byte);
+  g_spr.clearClipRect();
+}
+#endif
+
+bool displayInit() {
+#if UI_PALETTE_8BIT
+  palInit();
+  s_idx = (uint8_t*)heap_caps_malloc(kIdxBytes, MALLOC_CAP_8BIT);
+  for (auto& st : s_stripe) st = (uint16_t*)heap_caps_malloc(kStripePx * 2, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+  if (!s_idx || !s_stripe[0] || !s_stripe[1]) {
+    Serial.println("[DSP] framebuffer alloc failed");
+    return false;
+  }
+  memset(s_idx, 0, kIdxBytes);
+  g_spr.setBuffer(s_idx, W, H, lgfx::color_depth_t::palette_8bit);
+  g_spr.clearClipRect();
+  s_stats.bufferBytes = (uint32_t)(kIdxBytes + 2 * kStripePx * 2);
+  Serial.printf("[DSP] 8-bit palette buffer, free internal heap %u\n",
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+  return true;
+#else
+  s_buf[0] = (uint16_t*)heap_caps_malloc(kFrameBytes, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+  if (!s_buf[0]) {
+    Serial.println("[DSP] framebuffer alloc failed");
+    return false;
+  }
+  memset(s_buf[0], 0, kFrameBytes);
+
+#if DISPLAY_DOUBLE_BUFFER
+  s_buf[1] = (uint16_t*)heap_caps_malloc(kFrameBytes, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+  if (s_buf[1] && heap_caps_get_free_size(MALLOC_CAP_INTERNAL) < DISPLAY_HEAP_RESERVE) {
+    heap_caps_free(s_buf[1]);   // zu knapp → lieber Einzelpuffer als BLE ohne Heap
+    s_buf[1] = nullptr;
+  }
+  if (s_buf[1]) memset(s_buf[1], 0, kFrameBytes);
+#endif
+  s_double = s_buf[1] != nullptr;
+  s_stats.doubleBuffered = s_double;
+  s_stats.bufferBytes = (uint32_t)(s_double ? 2 * kFrameBytes : kFrameBytes);
+  s_back = 0;
+  bindBack();
+  Serial.printf("[DSP] %s buffer, free internal heap %u\n", s_double ? "double" : "single",
+                (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL));
+  return true;
+#endif
+}
+
+bool displayDoubleBuffered() { return s_double; }
+
+static void waitTransfer() {
+  if (!s_dmaBusy) return;
+  const uint32_t t0 = micros();
+  auto& lcd = M5Dial.Display;
+  lcd.waitDMA();
+  lcd.endWrite();
+  s_dmaBusy = false;
+  s_stats.waitUs = micros() - t0;
+}
+
+void displayBeginFrame() {
+  s_stats.waitUs = 0;
+  s_stats.syncUs = 0;
+  if (s_double && s_syncN) {
+    // Backbuffer ist zwei Frames alt: Änderungen des letzten Frames aus dem Frontbuffer
+    // übernehmen. Lesen parallel zum DMA ist unkritisch.
+    const uint32_t t0 = micros();
+    const uint16_t* src = s_buf[s_back ^ 1];
+    uint16_t*       dst = s_buf[s_back];
+    for (int i = 0; i < s_syncN; ++i) {
+      const Rect& r = s_sync[i];
+      for (int y = r.y; y < r.y + r.h; ++y)
+        memcpy(dst + y * W + r.x, src + y * W + r.x, (size_t)r.w * 2);
+    }
+    s_syncN = 0;
+    s_stats.syncUs = micros() - t0;
+  }
+  g_spr.clearClipRect();
+  s_renderStartUs = micros();
+}
+
+void displayPresent(const Rect* rects, int n) {
+  const uint32_t tRender = micros();
+  s_stats.renderUs = tRender - s_renderStartUs;
+  auto& lcd = M5Dial.Display;
+
+#if UI_PALETTE_8BIT
+  // Rechteck streifenweise expandieren; pushImageDMA wartet selbst auf den vorigen
+  // Transfer, also ist der andere Streifen frei, sobald der Aufruf zurückkommt.
+  waitTransfer();
+  const uint32_t tPush = micros();
+  lcd.startWrite();
+  int k = 0;
+  for (int i = 0; i < n; ++i) {
+    const Rect& r = rects[i];
+    const int rows = std::max(1, std::min((int)r.h, kStripePx / r.w));
+    for (int y = r.y; y < r.y + r.h; y += rows, k ^= 1) {
+      const int h = std::min(rows, r.y + r.h - y);
+      for (int j = 0; j < h; ++j) palExpand(s_idx + (y + j) * W + r.x, s_stripe[k] + j * r.w, r.w);
+      lcd.pushImageDMA(r.x, y, r.w, h, s_stripe[k]);
+    }
+  }
+  s_dmaBusy = true;
+  s_stats.pushUs = micros() - tPush;
+#else
+
+  if (!s_double) {
+    for (int i = 0; i < n; ++i) {
+      // pushSprite respektiert das Clip-Rect des Displays → nur r geht über SPI
+      lcd.setClipRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+      g_spr.pushSprite(0, 0);
+    }
+    lcd.clearClipRect();
+    s_stats.pushUs = micros() - tRender;
+    return;
+  }
+
+  // vorheriger Transfer muss durch sein, bevor der Bus neu belegt wird
+  waitTransfer();
+  const uint32_t tPush = micros();
+  lcd.startWrite();
+  for (int i = 0; i < n; ++i) {
+    lcd.setClipRect(rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+    lcd.pushImageDMA(0, 0, W, H, s_buf[s_back]);
+  }
+  lcd.clearClipRect();
+  s_dmaBusy = true;   // endWrite erst nach waitDMA (nächster Frame)
+  s_stats.pushUs = micros() - tPush;
+
+  // Rects für den Abgleich merken (bei Überlauf: ganzer Schirm)
+  if (n > kMaxSync) { s_sync[0] = makeRect(0, 0, W, H); s_syncN = 1; }
+  else { for (int i = 0; i < n; ++i) s_sync[i] = rects[i]; s_syncN = n; }
+
+  s_back ^= 1;
+  bindBack();
+#endif
+}
+
+DisplayStats displayStats() { return s_stats; }
@@ -0,0 +1,23 @@
+#pragma once
+#include <stdint.h>
+#include "utils.h"   // Rect
+
+// Display-Pipeline: g_spr zeigt immer auf den Backbuffer.
+// Doppelpuffer: Frame N+1 wird gezeichnet, während Frame N per DMA zum Panel läuft.
+// Einzelpuffer (Fallback bei knappem RAM): synchroner Push wie bisher.
+// UI_PALETTE_8BIT (palette.h): 8-bit-Backbuffer, RGB565 erst streifenweise beim Push.
+
+struct DisplayStats {
+  uint32_t renderUs;    // Zeichnen (beginFrame → present)
+  uint32_t pushUs;      // CPU-Zeit im Push (Start/Übertragung)
+  uint32_t waitUs;      // Warten auf den vorigen DMA-Transfer
+  uint32_t syncUs;      // Nachziehen der letzten Dirty-Rects in den Backbuffer
+  bool     doubleBuffered;
+  uint32_t bufferBytes; // Framebuffer + Push-Puffer
+};
+
+bool displayInit();                              // Puffer anlegen, g_spr binden
+bool displayDoubleBuffered();
+void displayBeginFrame();                        // Backbuffer bereit machen
+void displayPresent(const Rect* rects, int n);   // Dirty-Rects zum Panel schicken
+DisplayStats displayStats();
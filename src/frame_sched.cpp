@@ -0,0 +1,89 @@
+#include "frame_sched.h"
+#include <Arduino.h>
+#include <algorithm>
+#include "app_state.h"
+
+static const uint32_t kWindowMs = 1000;   // Fenster für fps und Zeitanteile
+
+static bool     s_anyInput    = false;
+static uint32_t s_lastInputMs = 0;
+static uint32_t s_lastFrameMs = 0;
+static bool     s_pending     = false;    // needsRedraw wartet auf das Intervall
+static uint32_t s_pendingMs   = 0;
+static uint32_t s_costUs      = 0;        // EMA Render+Push
+
+static uint32_t s_winStartMs = 0, s_winFrames = 0;
+static uint32_t s_lastLoopUs = 0;
+static uint64_t s_winLoopUs = 0, s_winRenderUs = 0, s_winInputUs = 0, s_winBleUs = 0;
+
+static FrameSchedStats s_stats = { FramePhase::Idle, 1000 / FRAME_IDLE_FPS, 0, 0, 0, 0, 0, 0, 0 };
+
+static FramePhase phaseAt(uint32_t nowMs) {
+  if (!s_anyInput) return FramePhase::Idle;
+  const uint32_t dt = nowMs - s_lastInputMs;
+  if (dt < FRAME_ACTIVE_MS) return FramePhase::Active;
+  if (dt < FRAME_SETTLE_MS) return FramePhase::Settle;
+  return FramePhase::Idle;
+}
+
+// Intervall der Phase, aber nie so kurz, dass Render+Push mehr als ihren Anteil bekommen
+static void update(uint32_t nowMs) {
+  static const uint16_t kFps[] = { FRAME_ACTIVE_FPS, FRAME_SETTLE_FPS, FRAME_IDLE_FPS };
+  const FramePhase ph = phaseAt(nowMs);
+  const uint32_t base  = 1000u / kFps[(int)ph];
+  const uint32_t floor = (s_costUs * 100u / FRAME_RENDER_SHARE + 999u) / 1000u;
+  s_uiIntervalMs = (uint16_t)std::min<uint32_t>(std::max(base, floor), 1000u);
+  s_uiNextMs     = s_lastFrameMs + s_uiIntervalMs;   // Wechsel nach Active zieht den nächsten Frame vor
+  s_stats.phase      = ph;
+  s_stats.intervalMs = s_uiIntervalMs;
+}
+
+void frameSchedInput(uint32_t nowMs) {
+  s_anyInput    = true;
+  s_lastInputMs = nowMs;
+  update(nowMs);
+}
+
+bool frameSchedDue(uint32_t nowMs) {
+  if (!s_pending) { s_pending = true; s_pendingMs = nowMs; }
+  update(nowMs);
+  return (int32_t)(nowMs - s_uiNextMs) >= 0;
+}
+
+void frameSchedFrameDone(uint32_t nowMs, uint32_t costUs) {
+  s_costUs = s_costUs ? (s_costUs * 7 + costUs) / 8 : costUs;
+  // fällig war der Frame, sobald needsRedraw anstand und das Intervall um war
+  const uint32_t dueMs = (int32_t)(s_uiNextMs - s_pendingMs) > 0 ? s_uiNextMs : s_pendingMs;
+  if (s_pending && (int32_t)(nowMs - dueMs) > (int32_t)s_uiIntervalMs) s_stats.missed++;
+  s_pending     = false;
+  s_lastFrameMs = nowMs;
+  s_stats.frames++;
+  s_stats.costUs = s_costUs;
+  s_winFrames++;
+  update(nowMs);
+}
+
+void frameSchedCancel() { s_pending = false; }
+
+void frameSchedLoop(uint32_t bleUs, uint32_t inputUs, uint32_t renderUs) {
+  const uint32_t nowUs = micros();
+  if (s_lastLoopUs) s_winLoopUs += nowUs - s_lastLoopUs;
+  s_lastLoopUs = nowUs;
+  s_winBleUs    += bleUs;
+  s_winInputUs  += inputUs;
+  s_winRenderUs += renderUs;
+
+  const uint32_t nowMs = millis();
+  const uint32_t win = nowMs - s_winStartMs;
+  if (win < kWindowMs) return;
+  const uint64_t total = std::max<uint64_t>(s_winLoopUs, 1);
+  s_stats.fpsX10   = (uint16_t)(s_winFrames * 10000u / win);
+  s_stats.renderPm = (uint16_t)(s_winRenderUs * 1000 / total);
+  s_stats.inputPm  = (uint16_t)(s_winInputUs * 1000 / total);
+  s_stats.blePm    = (uint16_t)(s_winBleUs * 1000 / total);
+  s_winStartMs = nowMs;
+  s_winFrames  = 0;
+  s_winLoopUs = s_winRenderUs = s_winInputUs = s_winBleUs = 0;
+}
+
+FrameSchedStats frameSchedStats() { return s_stats; }
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+
+// Frame-Scheduler: setzt s_uiIntervalMs/s_uiNextMs (app_state.h) nach Interaktion und
+// gemessenen Kosten. Gezeichnet wird weiterhin nur bei needsRedraw – ohne Änderungen
+// also gar nicht; die Rate begrenzt nur, wie oft Änderungen auf den Schirm kommen.
+//   Active  Encoder/Touch in den letzten FRAME_ACTIVE_MS  → FRAME_ACTIVE_FPS
+//   Settle  danach bis FRAME_SETTLE_MS                    → FRAME_SETTLE_FPS
+//   Idle    sonst (Gerätemeldungen, Verbindungsstatus)    → FRAME_IDLE_FPS
+// Untergrenze in allen Phasen: Render+Push höchstens FRAME_RENDER_SHARE % eines Intervalls,
+// damit Input und BLE im loop() nicht verhungern.
+#ifndef FRAME_ACTIVE_FPS
+#define FRAME_ACTIVE_FPS 60
+#endif
+#ifndef FRAME_SETTLE_FPS
+#define FRAME_SETTLE_FPS 30
+#endif
+#ifndef FRAME_IDLE_FPS
+#define FRAME_IDLE_FPS 10
+#endif
+#ifndef FRAME_ACTIVE_MS
+#define FRAME_ACTIVE_MS 300
+#endif
+#ifndef FRAME_SETTLE_MS
+#define FRAME_SETTLE_MS 1500
+#endif
+#ifndef FRAME_RENDER_SHARE
+#define FRAME_RENDER_SHARE 50
+#endif
+
+enum class FramePhase : uint8_t { Active, Settle, Idle };
+
+struct FrameSchedStats {
+  FramePhase phase;
+  uint16_t intervalMs;     // aktuelles Intervall
+  uint16_t fpsX10;         // erreichte Frames/s im letzten Fenster ×10
+  uint32_t frames;         // seit Boot
+  uint32_t missed;         // seit Boot: Frame kam später als eine Intervalllänge nach Fälligkeit
+  uint32_t costUs;         // geglättete Kosten Render+Push
+  // Anteil am loop() im letzten Fenster, Promille
+  uint16_t renderPm, inputPm, blePm;
+};
+
+void frameSchedInput(uint32_t nowMs);                 // Encoder/Touch verarbeitet
+bool frameSchedDue(uint32_t nowMs);                   // nur bei needsRedraw fragen
+void frameSchedFrameDone(uint32_t nowMs, uint32_t costUs);
+void frameSchedCancel();                              // fällig, aber nichts zu zeichnen
+void frameSchedLoop(uint32_t bleUs, uint32_t inputUs, uint32_t renderUs);   // einmal pro loop()
+FrameSchedStats frameSchedStats();
@@ -0,0 +1,140 @@
+#include "glyphs.h"
+#include <algorithm>
+#include "palette.h"
+
+// Atlas pro Font: druckbares ASCII, je Glyphe Vorschub, belegte Zeilen und eine
+// Bitmaske pro Zeile (Bit 0 = linkes Pixel). Font2 ist 16 px hoch, Glyphen < 16 px breit.
+namespace {
+
+constexpr int kFirst  = 32;
+constexpr int kLast   = 126;
+constexpr int kGlyphs = kLast - kFirst + 1;
+constexpr int kMaxH   = 16;
+constexpr int kMaxW   = 16;
+
+struct Glyph { uint8_t adv, y0, y1; };    // belegte Zeilen [y0, y1)
+struct Atlas {
+  uint8_t  h;
+  Glyph    g[kGlyphs];
+  uint16_t rows[kGlyphs][kMaxH];
+};
+
+Atlas s_atlas[(int)GlyphFont::Count];
+
+inline uint16_t to565(uint32_t c) {
+  return (uint16_t)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+}
+inline uint16_t swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+
+inline int glyphIndex(char c) {
+  const int i = (uint8_t)c - kFirst;
+  return (i >= 0 && i < kGlyphs) ? i : 0;   // Unbekanntes als Leerzeichen
+}
+
+// eine Glyphe über LGFX in einen 1-bit-Sprite zeichnen und zeilenweise auslesen
+void renderAtlas(Atlas& a, const lgfx::IFont* font) {
+  LGFX_Sprite s;
+  s.setColorDepth(1);
+  if (!s.createSprite(kMaxW, kMaxH)) return;
+  s.setFont(font);
+  s.setTextDatum(textdatum_t::top_left);
+  s.setTextColor(TFT_WHITE);
+  a.h = (uint8_t)std::min<int32_t>(s.fontHeight(), kMaxH);
+  const uint8_t* buf = (const uint8_t*)s.getBuffer();
+  const int stride = (kMaxW + 7) / 8;
+  for (int i = 0; i < kGlyphs; ++i) {
+    const char str[2] = { (char)(kFirst + i), '\0' };
+    s.fillSprite(0);
+    s.drawString(str, 0, 0);
+    Glyph& g = a.g[i];
+    g.adv = (uint8_t)std::min<int32_t>(s.textWidth(str), kMaxW);
+    g.y0 = a.h; g.y1 = 0;
+    for (int y = 0; y < a.h; ++y) {
+      uint16_t m = 0;
+      for (int x = 0; x < g.adv; ++x)
+        if (buf[y * stride + (x >> 3)] & (0x80 >> (x & 7))) m |= (uint16_t)(1u << x);
+      a.rows[i][y] = m;
+      if (m) { if (y < g.y0) g.y0 = (uint8_t)y; g.y1 = (uint8_t)(y + 1); }
+    }
+    if (g.y0 >= g.y1) g.y0 = g.y1 = 0;
+  }
+  s.deleteSprite();
+}
+
+}  // namespace
+
+void glyphsInit() {
+  renderAtlas(s_atlas[(int)GlyphFont::Small],  &fonts::Font0);
+  renderAtlas(s_atlas[(int)GlyphFont::Normal], &fonts::Font2);
+}
+
+int glyphWidth(GlyphFont f, const char* s) {
+  const Atlas& a = s_atlas[(int)f];
+  int w = 0;
+  for (; *s; ++s) w += a.g[glyphIndex(*s)].adv;
+  return w;
+}
+
+void glyphDraw(LGFX_Sprite& d, GlyphFont f, const char* s, int x, int y, uint32_t col) {
+  const Atlas& a = s_atlas[(int)f];
+  if (!a.h) return;
+  int32_t clx, cly, clw, clh;
+  d.getClipRect(&clx, &cly, &clw, &clh);
+  const int cx0 = clx, cx1 = clx + clw, cy0 = cly, cy1 = cly + clh;
+  const int oy = y - (a.h >> 1);
+  if (oy >= cy1 || oy + a.h <= cy0) return;
+
+  uint16_t* buf = d.getColorDepth() == 16 ? (uint16_t*)d.getBuffer() : nullptr;
+  uint8_t*  idx = (UI_PALETTE_8BIT && d.getColorDepth() == 8) ? (uint8_t*)d.getBuffer() : nullptr;
+  const int stride = d.width();
+  const uint16_t colSw = swap16(to565(col));
+
+  int ox = x - (glyphWidth(f, s) >> 1);
+  for (; *s && ox < cx1; ox += a.g[glyphIndex(*s)].adv, ++s) {
+    const int gi = glyphIndex(*s);
+    const Glyph& g = a.g[gi];
+    if (ox + g.adv <= cx0 || g.y0 == g.y1) continue;
+    // Clip links/rechts als Maske über die Glyphenspalten
+    uint32_t keep = 0xFFFFu;
+    if (ox < cx0) keep &= 0xFFFFu << (cx0 - ox);
+    if (ox + kMaxW > cx1) keep &= (1u << (cx1 - ox)) - 1;
+    const int ya = std::max(oy + g.y0, cy0), yb = std::min(oy + g.y1, cy1);
+    for (int yy = ya; yy < yb; ++yy) {
+      uint32_t m = a.rows[gi][yy - oy] & keep;
+      if (buf) {
+        uint16_t* row = buf + yy * stride + ox;
+        for (; m; m &= m - 1) row[__builtin_ctz(m)] = colSw;
+        continue;
+      }
+      if (idx) {
+        uint8_t* row = idx + yy * stride + ox;
+        for (; m; m &= m - 1) row[__builtin_ctz(m)] = (uint8_t)col;
+        continue;
+      }
+      // andere Farbtiefen: zusammenhängende Läufe als Linie
+      while (m) {
+        const int b = __builtin_ctz(m);
+        const int n = __builtin_ctz(~(m >> b));
+        d.drawFastHLine(ox + b, yy, n, col);
+        m &= ~(((1u << n) - 1) << b);
+      }
+    }
+  }
+}
+
+char* fmtInt(char* p, int v) {
+  char tmp[11];
+  int n = 0;
+  unsigned u = v < 0 ? 0u - (unsigned)v : (unsigned)v;
+  do { tmp[n++] = (char)('0' + u % 10); u /= 10; } while (u);
+  if (v < 0) *p++ = '-';
+  while (n) *p++ = tmp[--n];
+  *p = '\0';
+  return p;
+}
+
+char* fmtStr(char* p, const char* s) {
+  while (*s) *p++ = *s++;
+  *p = '\0';
+  return p;
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <M5Dial.h>
+#include <stdint.h>
+
+// Text ohne Heap und ohne Font-Rasterung pro Frame: die Bitmap-Fonts der UI werden beim
+// Start einmal in einen Atlas (eine 16-bit-Zeilenmaske pro Glyphenzeile) gerendert,
+// Zeichnen ist danach nur noch ein Blit der gesetzten Bits in den Sprite-Puffer.
+// Zahlen werden mit fmtInt in Stack-Puffer formatiert statt über String.
+
+enum class GlyphFont : uint8_t { Small, Normal, Count };   // Font0, Font2
+
+void glyphsInit();                                         // vor dem ersten Frame
+int  glyphWidth(GlyphFont f, const char* s);
+// Text mittig um (x,y) wie textdatum middle_center; col wie bei LGFX: RGB888
+// (auf dem 8-bit-Backbuffer der Paletten-Index).
+// Respektiert das Clip-Rect des Sprites.
+void glyphDraw(LGFX_Sprite& d, GlyphFont f, const char* s, int x, int y, uint32_t col);
+
+// hängen an p an, setzen '\0' und geben das Ende zurück (Puffergröße prüft der Aufrufer)
+char* fmtInt(char* p, int v);
+char* fmtStr(char* p, const char* s);
@@ -4,53 +4,112 @@
 #include "geometry.h"
 #include "utils.h"
 #include "ble.h"
+#include "pattern_catalog.h"
+#include "input_queue.h"
+#include "perf.h"
+#include "motion.h"
+#include "polar_lut.h"
+#include "frame_sched.h"
+#include "power.h"
+#include "pattern_play.h"
 
 // FreeRTOS
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
 // ---- globals ----
-volatile int32_t g_enc_accum = 0;
-static portMUX_TYPE g_enc_mux = portMUX_INITIALIZER_UNLOCKED;
+// Sampler-Task (Producer) → inputUpdate (Consumer): Ereignisse mit echtem Abtastzeitpunkt
+static SpscRing<InputEvent, 64> s_events;
+static volatile uint32_t s_evDropped = 0;   // zusammengefasste/verworfene Touch-Moves bei vollem Ring
+static uint32_t s_evUs = 0;                  // Abtastzeit des gerade verarbeiteten Ereignisses
 
 static TaskHandle_t s_encTask = nullptr;
+static volatile uint32_t s_samplerMs = 8;   // power.h streckt die Periode im Leerlauf
+
+// Rückstau des Samplers bei vollem Ring: Kanten (Down/Up/Press/Hold) warten in Reihenfolge
+// (verloren erst, wenn 8 davon anstehen), aufeinanderfolgende Touch-Moves werden zur letzten Position
+// zusammengefasst – wie carry beim Encoder, Nachsenden beim nächsten Abtasten.
+static InputEvent s_pend[8];
+static uint8_t    s_pendN = 0;
+
+static void flushPending(){
+  uint8_t i = 0;
+  while (i < s_pendN && s_events.push(s_pend[i])) ++i;
+  if (!i) return;
+  for (uint8_t j = i; j < s_pendN; ++j) s_pend[j - i] = s_pend[j];
+  s_pendN -= i;
+}
 
-// Atomar abholen (read-and-reset)
-int32_t takeEncoderDelta(){
-  int32_t d;
-  taskENTER_CRITICAL(&g_enc_mux);
-  d = g_enc_accum;
-  g_enc_accum = 0;
-  taskEXIT_CRITICAL(&g_enc_mux);
-  return d;
+static void pushEvent(InputEvType type, uint32_t tUs, int16_t x = 0, int16_t y = 0, int32_t delta = 0){
+  InputEvent ev{ tUs, type, x, y, delta };
+  if (!s_pendN && s_events.push(ev)) return;
+  if (type == InputEvType::TouchMove && s_pendN && s_pend[s_pendN - 1].type == InputEvType::TouchMove) {
+    s_pend[s_pendN - 1] = ev;   // nur die letzte Position zählt
+    s_evDropped++;
+    return;
+  }
+  if (s_pendN == sizeof s_pend / sizeof s_pend[0]) {
+    // Rückstau voll (loop() hängt seit vielen Abtastungen): ältesten Move opfern, Kanten nie
+    uint8_t m = 0;
+    while (m < s_pendN && s_pend[m].type != InputEvType::TouchMove) ++m;
+    if (m == s_pendN) { s_evDropped++; return; }   // nur Kanten: loop() steht seit Sekunden
+    for (uint8_t j = m + 1; j < s_pendN; ++j) s_pend[j - 1] = s_pend[j];
+    s_pendN--;
+    s_evDropped++;
+  }
+  s_pend[s_pendN++] = ev;
 }
 
-// 1 kHz Sampler: liest M5Dial.Encoder und sammelt Deltas
+// Sampler: EINZIGE Stelle, die M5Dial.update() aufruft – Encoder, BtnA und Touch werden
+// hier abgetastet und als Ereignisse weitergereicht (kein ungesynchronisiertes Lesen aus loop()).
 static void encoderSampler(void*){
-  int32_t last = 0;
-
   // Wichtig: einmal initial update(), dann Ausgangswert holen
   M5Dial.update();
-  last = M5Dial.Encoder.read();
+  int32_t last = M5Dial.Encoder.read();
+  int32_t carry = 0;                  // Encoder-Delta, das nicht in den Ring passte
+  bool    touchDown = false;
+  int16_t tx = -1, ty = -1;
 
   for(;;){
-    // Alle 2 ms reicht meist locker, 1 ms geht auch – 2 ms schont I2C/Touch
-    vTaskDelay(pdMS_TO_TICKS(8));
+    // Alle 2 ms reicht meist locker, 1 ms geht auch – 8 ms schont I2C/Touch
+    vTaskDelay(pdMS_TO_TICKS(s_samplerMs));
 
-    // EINZIGE Stelle im Programm, die M5Dial.update() aufruft:
     M5Dial.update();
+    const uint32_t now = micros();
+    flushPending();
 
     int32_t cur = M5Dial.Encoder.read();
-    int32_t d   = cur - last;
-    if (d) {
-      portENTER_CRITICAL(&g_enc_mux);
-      g_enc_accum += d;          // verlustfrei puffer
-      portEXIT_CRITICAL(&g_enc_mux);
-      last = cur;
+    carry += cur - last;
+    last = cur;
+    if (carry) {
+      // verlustfrei: passt es nicht, wird es beim nächsten Durchlauf mitgeschickt
+      InputEvent ev{ now, InputEvType::Encoder, 0, 0, carry };
+      if (s_events.push(ev)) carry = 0;
     }
+
+    // wie bisher in inputUpdate(): Hold vor Press, Press schon beim Drücken
+    if (M5Dial.BtnA.wasHold())         pushEvent(InputEvType::BtnHold, now);
+    else if (M5Dial.BtnA.wasPressed()) pushEvent(InputEvType::BtnPress, now);
+
+    auto t = M5Dial.Touch.getDetail();
+    if (t.isPressed()) {
+      if (!touchDown) {
+        touchDown = true; tx = t.x; ty = t.y;
+        pushEvent(InputEvType::TouchDown, now, tx, ty);
+      } else if (t.x != tx || t.y != ty) {
+        tx = t.x; ty = t.y;
+        pushEvent(InputEvType::TouchMove, now, tx, ty);
+      }
+    } else if (touchDown) {
+      touchDown = false;
+      pushEvent(InputEvType::TouchUp, now, tx, ty);
+    }
+    if (s_events.size()) powerWakeFromSampler();   // loop() ggf. aus der Leerlauf-Pause holen
   }
 }
 
+void inputSetSamplerPeriod(uint32_t ms){ s_samplerMs = ms ? ms : 1; }
+
 #ifndef APP_CPU_NUM
 // Fallback: App-CPU ist i. d. R. 1 (PRO_CPU=0, APP_CPU=1) auf ESP32/S3
 #define APP_CPU_NUM 1
@@ -78,27 +137,11 @@ void stopEncoderSampler(){
 // Drag-Status nur lokal
 static bool draggingStroke=false, draggingDepth=false, draggingPosition=false, draggingSensation=false;
 
-// ---------- Buttons oben (− ⏯ +) ----------
-static int hitTopButtons(int x,int y){ // − ⏯ +
-  int cy=BUTTONS_Y; if (abs(y-cy)>24) return -1;
-  if ((x-(CX-CTRL_SPACING))*(x-(CX-CTRL_SPACING))+(y-cy)*(y-cy) <= 18*18) return 0; // minus
-  if ((x-CX)*(x-CX)+(y-cy)*(y-cy)                                   <= 24*24) return 1; // play
-  if ((x-(CX+CTRL_SPACING))*(x-(CX+CTRL_SPACING))+(y-cy)*(y-cy) <= 18*18) return 2; // plus
-  return -1;
-}
-
-// ---------- Lokale Treffer-Tests mit verlagertem Nullpunkt ----------
-static bool hitTopBandRel(int x,int y,int r_in,int r_out){
-  if (!inAnnulus(x,y,r_in,r_out)) return false;
-  float a = relTopDeg(x,y);             // −90..+90 gültig
-  return (a >= -90.0f && a <= +90.0f);
-}
+// Treffer-Tests und Reglerwerte des Hauptbildschirms: Tabellen-Lookup (polar_lut.h)
+using polar::Region;
 
-static bool hitBottomBandRel(int x,int y,int r_in,int r_out){
-  if (!inAnnulus(x,y,r_in,r_out)) return false;
-  float a = relBottomDeg(x,y);          // −75..+75 gültig
-  return (a >= -75.0f && a <= +75.0f);
-}
+// Firmware-Muster nur ohne lokale Wiedergabe; sonst tastet playTick() das neue Muster
+static void sendPattern(){ if (!PATTERN_LOCAL) bleSendPattern(catalogId(g_patternIndex)); }
 
 // ---------- Tap-Handling ----------
 static void onTap(int x,int y){
@@ -128,46 +171,39 @@ static void onTap(int x,int y){
 
   if (g_showPatternPicker){
     int listTop = CY-60 - g_pickerScroll;
-    for (int i=0;i<(int)g_patterns.size();++i){
+    for (int i=0;i<catalogCount();++i){
       int y0=listTop+i*34; int y1=y0+28;
-      if (x>=CX-96 && x<=CX+96 && y>=y0 && y<=y1){ g_patternIndex=i; closePicker(); bleSendPattern(g_patternIndex); return; }
+      if (x>=CX-96 && x<=CX+96 && y>=y0 && y<=y1){ g_patternIndex=i; closePicker(); sendPattern(); return; }
     }
     closePicker(); 
-    bleSendPattern(g_patternIndex);
+    sendPattern();
     return;
   }
 
+  const Region rg = polar::regionAt(x,y);
+
   // obere Buttons
-  int cc = hitTopButtons(x,y);
-  if (cc>=0){
-    if (cc==1){ toggleMode(); return; }                 // Play/Pause toggelt Mode
-    if (cc==0){ if (ble_is_connected()) { bleSendRetract(); bleSendAirIn(); } }
-    if (cc==2){ if (ble_is_connected()) { bleSendExtend();  bleSendAirOut(); } }
-    return;
-  }
+  if (rg==Region::Play){ toggleMode(); return; }        // Play/Pause toggelt Mode
+  if (rg==Region::Minus){ if (ble_is_connected()) { bleSendRetract(); bleSendAirIn(); } return; }
+  if (rg==Region::Plus){  if (ble_is_connected()) { bleSendExtend();  bleSendAirOut(); } return; }
 
   // Pattern-Pill unten
-  if (x>=CX-60 && x<=CX+60 && y>=CTRL_Y-12 && y<=CTRL_Y+12){ openPicker(); return; }
+  if (rg==Region::Pill){ openPicker(); return; }
 
   // Sens/Pos Band (unterer 150°-Bogen)
-  if (hitBottomBandRel(x,y,R_SENS_IN,R_SENS_OUT)){
-    float a = relBottomDeg(x,y);                // [-75..+75]
-    a = clampf(a, -75.0f, +75.0f);
-    float t = (a + 75.0f) / 150.0f;             // -> [0..1] links..rechts
-
+  if (rg==Region::SensBand){
     if (g_mode==Mode::POSITION){
       draggingPosition=true;
-      int np = (int)roundf(t*100.0f);
+      int np = polar::posValue(x,y);              // links..rechts 0..100
       if(np!=g_position){ 
         g_position=np; 
         needsRedraw=true; 
-        if(ble_is_connected()) bleSendMove(g_position,g_moveTime,true);
+        motionSetTarget(g_position, s_evUs);
       }    
     } else {
       draggingSensation=true;
       // Mapping: links = +100 → Mitte = 0 → rechts = −100
-      int ns = (int)roundf(((0.5f - t) / 0.5f) * 100.0f);
-      ns = clampi(ns,-100,100);
+      int ns = polar::sensValue(x,y);
       if (ns!=g_sensation){ g_sensation=ns; needsRedraw=true; }
     }
     return;
@@ -176,12 +212,12 @@ static void onTap(int x,int y){
   // Speed-Ring: Touch deaktiviert
 
   // Stroke/Depth Band → Griff wählen (oberer Halbring)
-  if (hitTopBandRel(x,y,R_RANGE_IN,R_RANGE_OUT)){
-    float aRel = relTopDeg(x,y);                 // [-90..+90]
+  if (rg==Region::RangeBand){
+    int32_t aRel = polar::relTop(x,y);           // [-90..+90]
     // Zielwinkel beider Griffe ebenfalls in relTop-Space:
-    float aS = -90.0f + (g_stroke/100.0f)*180.0f;
-    float aD = -90.0f + (g_depth /100.0f)*180.0f;
-    if (fabsf(aRel-aS) < fabsf(aRel-aD)) draggingStroke=true; else draggingDepth=true;
+    int32_t aS = polar::topAngleOfValue(g_stroke);
+    int32_t aD = polar::topAngleOfValue(g_depth);
+    if (labs(aRel-aS) < labs(aRel-aD)) draggingStroke=true; else draggingDepth=true;
     return;
   }
 }
@@ -189,35 +225,25 @@ static void onTap(int x,int y){
 // ---------- Drag-Handling ----------
 static void onDrag(int x,int y){
   if (draggingStroke){
-    float a = relTopDeg(x,y);
-    a = clampf(a, -90.0f, +90.0f);
-    float t = (a + 90.0f) / 180.0f;
-    int nv = (int)roundf(t * 100.0f);
+    int nv = polar::topValue(x,y);
     nv = clampi(nv, 0, g_depth - MIN_GAP);
     if (nv != g_stroke) { 
       g_stroke = nv;
       needsRedraw = true;
-      if (ble_is_connected()) bleSendStroke(g_stroke); 
+      if (ble_is_connected() && !PATTERN_LOCAL) bleSendStroke(g_stroke); 
     }
   }
   else if (draggingDepth){
-    float a = relTopDeg(x,y);
-    a = clampf(a, -90.0f, +90.0f);
-    float t = (a + 90.0f) / 180.0f;
-    int nv = (int)roundf(t * 100.0f);
+    int nv = polar::topValue(x,y);
     nv = clampi(nv, g_stroke + MIN_GAP, 100);
     if (nv != g_depth) { 
       g_depth = nv;
       needsRedraw = true;
-      if (ble_is_connected()) bleSendDepth(g_depth); 
+      if (ble_is_connected() && !PATTERN_LOCAL) bleSendDepth(g_depth); 
     }
   }
   else if (draggingSensation){
-    float a = relBottomDeg(x,y);
-    a = clampf(a, -75.0f, +75.0f);
-    float t = (a + 75.0f) / 150.0f;
-    int ns = (int)roundf(((0.5f - t) / 0.5f) * 100.0f);
-    ns = clampi(ns, -100, +100);
+    int ns = polar::sensValue(x,y);
     if (ns != g_sensation) { 
       g_sensation = ns; 
       needsRedraw = true;
@@ -227,135 +253,142 @@ static void onDrag(int x,int y){
     }
   }
   else if (draggingPosition){
-    float a = relBottomDeg(x,y);
-    a = clampf(a, -75.0f, +75.0f);
-    float t = (a + 75.0f) / 150.0f;
-    int nv = (int)roundf(t * 100.0f);
+    int nv = polar::posValue(x,y);
     if (nv != g_position) {
        g_position = nv; 
        needsRedraw = true;
-        if (ble_is_connected()) bleSendMove(g_position, g_moveTime, true); 
+        motionSetTarget(g_position, s_evUs);
     }
   }
 }
 
 static void onRelease(){ draggingStroke=draggingDepth=draggingSensation=draggingPosition=false; }
 
-// ---------- Eingabe-Update ----------
-void inputUpdate(){
-  //M5Dial.update(); // <- RAUS! Update macht jetzt der Sampler-Task
-
-  // BtnA: Long = Settings; Short = Mode toggle oder Auswahl bestätigen im Picker
-  if (M5Dial.BtnA.wasHold()) {
-    if (g_showPatternPicker) { closePicker(); } else { g_showSettings = !g_showSettings; }
-    needsRedraw = true;
-  } else if (M5Dial.BtnA.wasPressed()) {
-    if (g_showPatternPicker) { closePicker(); bleSendPattern(g_patternIndex);needsRedraw = true; }
-    else if (!g_showSettings) { toggleMode(); }
-  }
-
-  // ---------- Encoder — präzise langsam, beschleunigt schnell ----------
 // ---------- Encoder: verlustfrei + sanfte Beschleunigung ----------
-{
-  //static int32_t lastEnc = 0;
-  static uint32_t lastMs = 0;
-  static float emaVel = 0.0f;       // counts/s (geglättet)
-  static float accSpeed = 0.0f;     // Akkumulator für SPEED/POSITION Schritte (float)
-  //static int lastSign = 0;
-
-  const int   DETENT = 4;           // Counts pro Raster beim Picker
-  const float EMA_A  = 0.18f;       // Glättung der Geschwindigkeit
-  const float V0     = 15.0f;       // bis hier keine Beschleunigung
-  const float KGAIN  = 0.012f;      // Steigung für den Multiplikator jenseits V0
-  const float MULT_MAX = 10.0f;     // maximale Beschleunigung
-  const int   MAX_STEPS_PER_FRAME = 60; // Sicherheitscap (Rest bleibt im Accu)
-  const uint32_t MIN_DT_MS = 1;     // dt-Schutz
-
-int32_t dRaw = takeEncoderDelta();   // <- vom 1 kHz Sampler (verlustfrei)
-if (dRaw != 0) {
-  uint32_t now = millis();
-  uint32_t dt  = (lastMs==0) ? 16 : (now - lastMs);
-  if (dt < MIN_DT_MS) dt = MIN_DT_MS;
-  lastMs = now;
-    // Geschwindigkeit in counts/s
-    float vInst = (abs(dRaw) * 1000.0f) / (float)dt;
-    emaVel = (1.0f - EMA_A) * emaVel + EMA_A * vInst;
-
-    // kontinuierlicher Multiplikator: 1 + K * max(0, vel - V0)
-    float mult = 1.0f + KGAIN * std::max(0.0f, emaVel - V0);
-    if (mult > MULT_MAX) mult = MULT_MAX;
-
-    //lastMs  = now;
-    //lastEnc = enc;
-
-    // ---- Pattern-Picker: in Detents, verlustfrei mit eigenem Accu ----
-    if (g_showPatternPicker) {
-      static int pickAcc = 0;              // akkumuliert rohe Counts
-      pickAcc += dRaw;
-
-      int step = 0;
-      while (pickAcc >= DETENT)   { step++; pickAcc -= DETENT; }
-      while (pickAcc <= -DETENT)  { step--; pickAcc += DETENT; }
-
-      if (step != 0) {
-        int ni = clampi(g_patternIndex + step, 0, (int)g_patterns.size()-1);
-        if (ni != g_patternIndex) {
-          g_patternIndex = ni;
-
-          // Auto-Scroll in Sichtbereich
-          int itemY = (CY-60) + g_patternIndex*34 - g_pickerScroll;
-          int topVisible = CY-78 + 12;
-          int botVisible = CY+78 - 12 - 28;
-          if (itemY < topVisible) {
-            g_pickerScroll = clampi(g_pickerScroll - (topVisible - itemY), 0, (int)g_patterns.size()*34);
-          } else if (itemY > botVisible) {
-            g_pickerScroll = clampi(g_pickerScroll + (itemY - botVisible), 0, (int)g_patterns.size()*34);
-          }
-          needsRedraw = true;
+// Geschwindigkeit aus den Abtastzeitpunkten des Samplers (nicht aus der loop()-Latenz)
+static const int   DETENT = 4;            // Counts pro Raster beim Picker
+static const float VEL_TAU_US = 80000.0f; // Zeitkonstante der Geschwindigkeits-Glättung
+static const float V0     = 15.0f;        // bis hier keine Beschleunigung
+static const float KGAIN  = 0.012f;       // Steigung für den Multiplikator jenseits V0
+static const float MULT_MAX = 10.0f;      // maximale Beschleunigung
+static const int   MAX_STEPS_PER_FRAME = 60; // Sicherheitscap (Rest bleibt im Accu)
+
+static uint32_t s_lastEncUs = 0;
+static float    s_emaVel    = 0.0f;       // counts/s (geglättet)
+static float    s_accSpeed  = 0.0f;       // Akkumulator für SPEED/POSITION Schritte (float)
+static int      s_pickAcc   = 0;          // rohe Counts im Picker
+
+static void onEncoder(int32_t dRaw, uint32_t tUs){
+  // dt zwischen zwei Abtastungen; nach Pause (oder erstem Event) eine Sampler-Periode annehmen
+  uint32_t dt = s_lastEncUs ? (tUs - s_lastEncUs) : 16000;
+  if (dt > 250000) dt = 16000;
+  if (dt < 1000) dt = 1000;
+  s_lastEncUs = tUs;
+
+  // Geschwindigkeit in counts/s, zeitbasiert geglättet
+  const float vInst = (abs(dRaw) * 1e6f) / (float)dt;
+  const float a = 1.0f - expf(-(float)dt / VEL_TAU_US);
+  s_emaVel += a * (vInst - s_emaVel);
+
+  // kontinuierlicher Multiplikator: 1 + K * max(0, vel - V0)
+  float mult = 1.0f + KGAIN * std::max(0.0f, s_emaVel - V0);
+  if (mult > MULT_MAX) mult = MULT_MAX;
+
+  // ---- Pattern-Picker: in Detents, verlustfrei mit eigenem Accu ----
+  if (g_showPatternPicker) {
+    s_pickAcc += dRaw;
+
+    int step = 0;
+    while (s_pickAcc >= DETENT)   { step++; s_pickAcc -= DETENT; }
+    while (s_pickAcc <= -DETENT)  { step--; s_pickAcc += DETENT; }
+
+    if (step != 0) {
+      int ni = clampi(g_patternIndex + step, 0, catalogCount()-1);
+      if (ni != g_patternIndex) {
+        g_patternIndex = ni;
+
+        // Auto-Scroll in Sichtbereich
+        int itemY = (CY-60) + g_patternIndex*34 - g_pickerScroll;
+        int topVisible = CY-78 + 12;
+        int botVisible = CY+78 - 12 - 28;
+        if (itemY < topVisible) {
+          g_pickerScroll = clampi(g_pickerScroll - (topVisible - itemY), 0, catalogCount()*34);
+        } else if (itemY > botVisible) {
+          g_pickerScroll = clampi(g_pickerScroll + (itemY - botVisible), 0, catalogCount()*34);
         }
+        needsRedraw = true;
       }
-      return; // Picker hat Vorrang
     }
+    return; // Picker hat Vorrang
+  }
 
-    // ---- Speed/Position: verlustfrei über Float-Accumulator ----
-    //int sign = (dRaw>0) - (dRaw<0);
-    //lastSign = sign;
-
-    // Zieländerung in "Wert-Schritten": rohe Counts * mult
-    float wantDelta = (float)dRaw * mult;
-    accSpeed += wantDelta;
-
-    // Ganze Schritte extrahieren, Rest bleibt im Accu (kein Skip!)
-    int steps = (accSpeed > 0) ? (int)floorf(accSpeed) : (int)ceilf(accSpeed);
-    // pro Frame kappen, Rest verbleibt
-    if (steps >  MAX_STEPS_PER_FRAME) steps =  MAX_STEPS_PER_FRAME;
-    if (steps < -MAX_STEPS_PER_FRAME) steps = -MAX_STEPS_PER_FRAME;
-    accSpeed -= (float)steps;
+  // ---- Speed/Position: Zieländerung in "Wert-Schritten": rohe Counts * mult ----
+  s_accSpeed += (float)dRaw * mult;
+}
 
-    if (steps != 0) {
-      if (g_mode == Mode::SPEED) {
-        int ns = clampi(g_speed + steps, 0, 100);
-        if (ns != g_speed) {
-          g_speed = ns; needsRedraw = true;
-          if (ble_is_connected()) bleSendSpeed(g_speed);
-        }
-      } else { // POSITION
-        int np = clampi(g_position + steps, 0, 100);
-        if (np != g_position) {
-          g_position = np; needsRedraw = true;
-          if (ble_is_connected()) bleSendMove(g_position, g_moveTime, true);
-        }
-      }
+// Ganze Schritte aus dem Accu anwenden (einmal pro inputUpdate → ein Kommando)
+static void applyEncoderSteps(){
+  int steps = (s_accSpeed > 0) ? (int)floorf(s_accSpeed) : (int)ceilf(s_accSpeed);
+  // pro Frame kappen, Rest verbleibt (kein Skip!)
+  if (steps >  MAX_STEPS_PER_FRAME) steps =  MAX_STEPS_PER_FRAME;
+  if (steps < -MAX_STEPS_PER_FRAME) steps = -MAX_STEPS_PER_FRAME;
+  if (steps == 0) return;
+  s_accSpeed -= (float)steps;
+
+  if (g_mode == Mode::SPEED) {
+    int ns = clampi(g_speed + steps, 0, 100);
+    if (ns != g_speed) {
+      g_speed = ns; needsRedraw = true;
+      // PATTERN_LOCAL: Tempo steckt in den move-Segmenten (pattern_play.h), nur Stopp geht raus
+      if (ble_is_connected() && (!PATTERN_LOCAL || g_speed == 0)) bleSendSpeed(g_speed);
+    }
+  } else { // POSITION
+    int np = clampi(g_position + steps, 0, 100);
+    if (np != g_position) {
+      g_position = np; needsRedraw = true;
+      motionSetTarget(g_position, s_lastEncUs);
     }
   }
 }
 
+// ---------- Eingabe-Update ----------
+void inputUpdate(){
+  //M5Dial.update(); // <- RAUS! Update macht jetzt der Sampler-Task
+
+  InputEvent ev;
+  bool any = false;
+  while (s_events.pop(ev)) {
+    s_evUs = ev.tUs;
+    any = true;
+    switch (ev.type) {
+      case InputEvType::Encoder:
+        perfInputOrigin(ev.tUs);
+        onEncoder(ev.delta, ev.tUs);
+        break;
+
+      // BtnA: Long = Settings; Short = Mode toggle oder Auswahl bestätigen im Picker
+      case InputEvType::BtnHold:
+        if (g_showPatternPicker) { closePicker(); } else { g_showSettings = !g_showSettings; }
+        needsRedraw = true;
+        break;
+      case InputEvType::BtnPress:
+        if (g_showPatternPicker) { closePicker(); sendPattern();needsRedraw = true; }
+        else if (!g_showSettings) { toggleMode(); }
+        break;
+
+      // Touch
+      case InputEvType::TouchDown: perfInputOrigin(ev.tUs); onTap(ev.x, ev.y);  break;
+      case InputEvType::TouchMove: perfInputOrigin(ev.tUs); onDrag(ev.x, ev.y); break;
+      case InputEvType::TouchUp:
+        if (draggingStroke || draggingDepth || draggingSensation || draggingPosition) onRelease();
+        break;
+    }
+  }
 
-  // Touch
-  auto t = M5Dial.Touch.getDetail();
-  if (t.isPressed()) {
-    if (t.wasPressed()) onTap(t.x, t.y); else onDrag(t.x, t.y);
-  } else if (draggingStroke || draggingDepth || draggingSensation || draggingPosition) {
-    onRelease();
+  if (!g_showPatternPicker) applyEncoderSteps();
+  if (any) {
+    frameSchedInput(millis());   // Bildrate hochziehen, solange bedient wird
+    powerActivity();             // Takt/Helligkeit sofort zurück auf Active
   }
+  perfInputDone();
 }
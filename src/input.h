@@ -1,7 +1,7 @@
 #pragma once
 #include <stdint.h>
 
-int32_t takeEncoderDelta();
-void inputUpdate();  // ruft intern M5Dial.update(), verarbeitet Touch/Encoder/BtnA
+void inputUpdate();  // verarbeitet die Ereignisse des Sampler-Tasks (Touch/Encoder/BtnA)
 void startEncoderSampler();
-void stopEncoderSampler();
\ No newline at end of file
+void stopEncoderSampler();
+void inputSetSamplerPeriod(uint32_t ms);   // Abtastperiode des Samplers (power.h)
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Lock-freier Ringpuffer für genau einen Producer und einen Consumer
+// (Sampler-Task → loop()). N muss eine Zweierpotenz sein.
+template <typename T, uint32_t N>
+class SpscRing {
+  static_assert((N & (N - 1)) == 0, "N muss Zweierpotenz sein");
+ public:
+  bool push(const T& v) {
+    const uint32_t h = _head.load(std::memory_order_relaxed);
+    if (h - _tail.load(std::memory_order_acquire) >= N) return false;   // voll
+    _buf[h & (N - 1)] = v;
+    _head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+  bool pop(T& out) {
+    const uint32_t t = _tail.load(std::memory_order_relaxed);
+    if (t == _head.load(std::memory_order_acquire)) return false;      // leer
+    out = _buf[t & (N - 1)];
+    _tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+  uint32_t size() const {
+    return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+  }
+ private:
+  T _buf[N];
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _tail{0};
+};
+
+// Eingabe-Ereignis mit Abtastzeitpunkt (micros() im Sampler-Task)
+enum class InputEvType : uint8_t {
+  Encoder,     // delta = Roh-Counts seit letzter Abtastung
+  BtnPress,    // BtnA gedrückt (wasPressed)
+  BtnHold,     // BtnA lang gehalten (wasHold)
+  TouchDown,   // x/y
+  TouchMove,   // x/y (nur bei Bewegung)
+  TouchUp,
+};
+
+struct InputEvent {
+  uint32_t    tUs;
+  InputEvType type;
+  int16_t     x, y;
+  int32_t     delta;
+};
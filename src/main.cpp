@@ -3,6 +3,13 @@
 #include "ui.h"
 #include "input.h"
 #include "ble.h"
+#include "display.h"
+#include "perf.h"
+#include "motion.h"
+#include "frame_sched.h"
+#include "power.h"
+#include "pattern_play.h"
+#include "pattern_catalog.h"
 
 #define SERIAL_PORT_MONITOR true
 void setup(){
@@ -12,8 +19,7 @@ void setup(){
   Serial.println("Serial Started, initialising hardware"); 
   startEncoderSampler();       // … dann Sampler starten
 
-  g_spr.setColorDepth(16);
-  g_spr.createSprite(240,240);
+  displayInit();               // Framebuffer(s) anlegen, g_spr an Backbuffer binden
   g_spr.setTextWrap(false);
   g_spr.setTextDatum(textdatum_t::middle_center);
   g_spr.setFont(&fonts::Font4);
@@ -21,11 +27,22 @@ void setup(){
   ble_init();
   ble_auto_start();
   initUI();
+  powerInit();                 // Takt/Helligkeit/Sampler nach Ruhezeit (power.h)
 }
 
 void loop(){
   //M5Dial.update();
+  perfLoopTick();
+  const uint32_t t0 = micros();
   ble_tick();
+  catalogTick();      // Musterkatalog: Hash prüfen, ggf. abrufen (nur kurz nach dem Verbinden)
+  const uint32_t t1 = micros();
   inputUpdate();      // Buttons, Encoder, Touch, BLE-Actions auslösen
+  motionTick();       // POSITION-Mode: fälliges move-Segment
+  playTick();         // SPEED-Mode mit PATTERN_LOCAL: Muster als move-Segmente
+  const uint32_t t2 = micros();
   drawUI();
+  frameSchedLoop(t1 - t0, t2 - t1, micros() - t2);   // Zeitanteile für frameSchedStats()
+  powerTick();
+  powerIdleWait();    // Dimmed/DeepIdle: Pause bis Eingabe, fälliger Frame oder move-Segment
 }
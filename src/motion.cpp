@@ -0,0 +1,130 @@
+#include "motion.h"
+#include <Arduino.h>
+#include <math.h>
+#include "app_state.h"
+#include "ble.h"
+#include "device_state.h"
+#include "utils.h"
+
+// ---------- Parameter ----------
+static const uint32_t kSegUs     = 40000;    // Sendetakt 25 Hz (unter der Startrate der TX-Regelung)
+static const uint32_t kLookUs    = 80000;    // move zielt 2 Takte voraus
+static const float    kTMin      = 0.12f;    // kürzeste Anfahrt (s) – begrenzt Beschleunigung/Ruck
+static const float    kVMin      = 20.0f;    // %/s: langsamste Folgegeschwindigkeit
+static const float    kVMax      = 250.0f;   // %/s: Obergrenze der Maschine
+static const float    kFollow    = 1.25f;    // Bahnspitze leicht über der Eingabegeschwindigkeit
+static const float    kUserTauUs = 120000.0f;
+
+// ---------- Zustand ----------
+// Quintik p(t) = c0 + c1 t + … + c5 t^5 von (p0,v0,a0) nach (pf,0,0) über T Sekunden
+static float    s_c[6]      = { 50.0f, 0, 0, 0, 0, 0 };
+static float    s_T         = 0.0f;
+static uint32_t s_t0Us      = 0;
+static int      s_target    = 50;
+static bool     s_active    = false;     // Trajektorie läuft oder Endpunkt noch nicht gesendet
+static uint32_t s_lastSegUs = 0;
+static int      s_lastSentPos = -1;
+static uint32_t s_lastInUs  = 0;
+static float    s_userVel   = 0.0f;
+static MotionStats s_stats  = {};
+
+static void evalAt(float t, float& p, float& v, float& a) {
+  if (t >= s_T) { p = (float)s_target; v = 0.0f; a = 0.0f; return; }
+  if (t < 0.0f) t = 0.0f;
+  const float* c = s_c;
+  p = c[0] + t * (c[1] + t * (c[2] + t * (c[3] + t * (c[4] + t * c[5]))));
+  v = c[1] + t * (2 * c[2] + t * (3 * c[3] + t * (4 * c[4] + t * 5 * c[5])));
+  a = 2 * c[2] + t * (6 * c[3] + t * (12 * c[4] + t * 20 * c[5]));
+}
+
+static float elapsed(uint32_t nowUs) { return (float)(int32_t)(nowUs - s_t0Us) * 1e-6f; }
+
+void motionReset(int pos) {
+  // Ist-Position vom Gerät, wenn bekannt – sonst die übergebene
+  const DeviceState dev = deviceStateGet();
+  const int p0 = dev.has(DevPosition) ? clampi(dev.val[DevPosition], 0, 100) : clampi(pos, 0, 100);
+  s_c[0] = (float)p0;
+  for (int i = 1; i < 6; ++i) s_c[i] = 0.0f;
+  s_T = 0.0f;
+  s_target = p0;
+  s_active = false;
+  s_lastSentPos = p0;
+  s_userVel = 0.0f;
+  s_lastInUs = 0;
+}
+
+void motionSetTarget(int pos, uint32_t tUs) {
+  pos = clampi(pos, 0, 100);
+  if (pos == s_target) return;
+
+  // Eingabegeschwindigkeit (%/s), zeitbasiert geglättet wie beim Encoder
+  uint32_t dt = s_lastInUs ? tUs - s_lastInUs : 40000;
+  if (dt > 300000) { dt = 40000; s_userVel = 0.0f; }
+  if (dt < 2000) dt = 2000;
+  s_lastInUs = tUs;
+  const float vIn = fabsf((float)(pos - s_target)) * 1e6f / (float)dt;
+  s_userVel += (1.0f - expf(-(float)dt / kUserTauUs)) * (vIn - s_userVel);
+
+  // Anfahrt vom Bahnzustand zum Abtastzeitpunkt (stetig in p, v, a)
+  float p0, v0, a0;
+  evalAt(elapsed(tUs), p0, v0, a0);
+  const float h = (float)pos - p0;
+  // Min-Jerk: Spitzengeschwindigkeit = 1.875·h/T. Dauer aus der Eingabegeschwindigkeit,
+  // höchstens g_moveTime (Nachlauf), aber nie schneller als die Maschine darf
+  const float vPeak = clampf(s_userVel * kFollow, kVMin, kVMax);
+  const float tMax = clampf(g_moveTime / 1000.0f, kTMin, 2.0f);
+  float T = clampf(1.875f * fabsf(h) / vPeak, kTMin, tMax);
+  T = fmaxf(T, 1.875f * fabsf(h) / kVMax);
+
+  const float T2 = T * T, T3 = T2 * T;
+  s_c[0] = p0;
+  s_c[1] = v0;
+  s_c[2] = a0 * 0.5f;
+  s_c[3] = (20.0f * h - 12.0f * v0 * T - 3.0f * a0 * T2) / (2.0f * T3);
+  s_c[4] = (-30.0f * h + 16.0f * v0 * T + 3.0f * a0 * T2) / (2.0f * T3 * T);
+  s_c[5] = (12.0f * h - 6.0f * v0 * T - a0 * T2) / (2.0f * T3 * T2);
+  s_T = T;
+  s_t0Us = tUs;
+  s_target = pos;
+  s_active = true;
+  s_stats.replans++;
+}
+
+bool motionNextSegment(uint32_t nowUs, MotionSegment& out) {
+  if (!s_active) return false;
+  if (s_lastSegUs && nowUs - s_lastSegUs < kSegUs) return false;
+
+  const float t = elapsed(nowUs);
+  const float tLook = t + kLookUs * 1e-6f;
+  float p, v, a;
+  evalAt(tLook, p, v, a);
+  s_stats.planVel = v;
+
+  int ms = (int)(kLookUs / 1000);
+  if (tLook >= s_T) {
+    // Endpunkt: Restzeit statt Vorausschau, danach Ruhe
+    ms = (int)lroundf((s_T - t) * 1000.0f);
+    if (ms < 50) ms = 50;
+    s_active = false;
+  }
+  const int pos = clampi((int)lroundf(p), 0, 100);
+  s_lastSegUs = nowUs;
+  if (pos == s_lastSentPos && s_active) return false;   // 1-%-Raster: nichts Neues
+  s_lastSentPos = pos;
+  out = MotionSegment{ pos, ms };
+  s_stats.segments++;
+  return true;
+}
+
+void motionTick() {
+  if (g_mode != Mode::POSITION) return;
+  MotionSegment seg;
+  if (motionNextSegment(micros(), seg) && ble_is_connected())
+    bleSendMove(seg.pos, seg.ms, true);
+}
+
+MotionStats motionStats() {
+  MotionStats st = s_stats;
+  st.userVel = s_userVel;
+  return st;
+}
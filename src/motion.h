@@ -0,0 +1,27 @@
+#pragma once
+#include <stdint.h>
+
+// POSITION-Mode: Bahnplaner zwischen Eingabe und BLE.
+// Das Ziel des Nutzers wird nicht direkt als move gesendet, sondern als ruckarme
+// (Min-Jerk-)Trajektorie geplant. In festem Takt geht je ein replace-move an den OSSM,
+// der auf den Bahnpunkt eine Vorausschau-Zeit voraus zielt – so bleibt die Bewegung
+// auch bei Funk-Jitter stetig, und die Kommandorate ist unabhängig von der Eingaberate.
+// Die Anfahrdauer richtet sich nach der Drehgeschwindigkeit des Nutzers.
+
+struct MotionSegment {
+  int pos;    // 0..100
+  int ms;     // Fahrzeit bis dorthin
+};
+
+struct MotionStats {
+  uint32_t segments;    // gesendete move-Segmente
+  uint32_t replans;     // neue Ziele
+  float    userVel;     // geglättete Eingabegeschwindigkeit (%/s)
+  float    planVel;     // aktuelle Bahngeschwindigkeit (%/s)
+};
+
+void motionReset(int pos);                        // Ist = Soll = pos, Stillstand
+void motionSetTarget(int pos, uint32_t tUs);      // neues Ziel (tUs = Abtastzeit der Eingabe)
+bool motionNextSegment(uint32_t nowUs, MotionSegment& out);   // true = jetzt senden
+void motionTick();                                // in loop(): sendet fällige Segmente
+MotionStats motionStats();
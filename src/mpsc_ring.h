@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+// Lock-freier Ringpuffer für beliebig viele Producer und genau einen Consumer
+// (loop()/Motion → BLE-TX-Task). Jede Zelle trägt eine Sequenznummer: Producer
+// reservieren per CAS auf _head, schreiben und geben die Zelle mit seq = pos+1 frei;
+// der Consumer liest nur freigegebene Zellen und gibt sie mit seq = pos+N zurück.
+// N muss eine Zweierpotenz sein. Zusätzlich: Höchststand und verworfene pushes.
+template <typename T, uint32_t N>
+class MpscRing {
+  static_assert((N & (N - 1)) == 0, "N muss Zweierpotenz sein");
+ public:
+  MpscRing() {
+    for (uint32_t i = 0; i < N; ++i) _cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+  bool push(const T& v) {
+    uint32_t pos = _head.load(std::memory_order_relaxed);
+    Cell* c;
+    for (;;) {
+      c = &_cells[pos & (N - 1)];
+      const int32_t d = (int32_t)(c->seq.load(std::memory_order_acquire) - pos);
+      if (d == 0) {
+        if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (d < 0) {
+        _drops.fetch_add(1, std::memory_order_relaxed);   // voll
+        return false;
+      } else {
+        pos = _head.load(std::memory_order_relaxed);      // anderer Producer war schneller
+      }
+    }
+    c->val = v;
+    c->seq.store(pos + 1, std::memory_order_release);
+    noteDepth(pos + 1 - _tail.load(std::memory_order_relaxed));
+    return true;
+  }
+  bool pop(T& out) {
+    const uint32_t pos = _tail.load(std::memory_order_relaxed);
+    Cell& c = _cells[pos & (N - 1)];
+    if ((int32_t)(c.seq.load(std::memory_order_acquire) - (pos + 1)) < 0) return false;   // leer
+    out = c.val;
+    c.seq.store(pos + N, std::memory_order_release);
+    _tail.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+  uint32_t size() const {
+    return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+  }
+  uint32_t highWater() const { return _high.load(std::memory_order_relaxed); }
+  uint32_t drops() const { return _drops.load(std::memory_order_relaxed); }
+
+ private:
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    T val;
+  };
+  void noteDepth(uint32_t d) {
+    uint32_t h = _high.load(std::memory_order_relaxed);
+    while (d > h && !_high.compare_exchange_weak(h, d, std::memory_order_relaxed)) {}
+  }
+  Cell _cells[N];
+  std::atomic<uint32_t> _head{0};
+  std::atomic<uint32_t> _tail{0};
+  std::atomic<uint32_t> _high{0};
+  std::atomic<uint32_t> _drops{0};
+};
@@ -0,0 +1,211 @@
+#include "notify_parser.h"
+#include <string.h>
+#include "pattern_catalog.h"
+
+namespace {
+
+inline bool isWs(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+// "-12", "40.6" → gerundet; false bei allem anderen (true/false/null/leer)
+bool parseNum(const char* s, uint8_t n, int& out) {
+  uint8_t i = 0;
+  bool neg = false;
+  if (i < n && (s[i] == '-' || s[i] == '+')) neg = s[i++] == '-';
+  if (i >= n || s[i] < '0' || s[i] > '9') return false;
+  int32_t v = 0;
+  while (i < n && s[i] >= '0' && s[i] <= '9') { if (v < 100000) v = v * 10 + (s[i] - '0'); ++i; }
+  if (i < n && s[i] == '.') {
+    ++i;
+    if (i < n && s[i] >= '5' && s[i] <= '9') ++v;   // erste Nachkommastelle rundet
+    while (i < n && s[i] >= '0' && s[i] <= '9') ++i;
+  }
+  if (i != n) return false;
+  if (v > 32767) v = 32767;
+  out = neg ? -(int)v : (int)v;
+  return true;
+}
+
+struct KeyMap { const char* key; DevField f; };
+const KeyMap kKeys[] = {
+  { "speed", DevSpeed }, { "stroke", DevStroke }, { "depth", DevDepth },
+  { "sensation", DevSensation }, { "pattern", DevPattern },
+  { "position", DevPosition }, { "pos", DevPosition },
+};
+
+// "4294967295" → uint32 (Katalog-Hash); false bei Vorzeichen, Bruch oder Überlauf
+bool parseU32(const char* s, uint8_t n, uint32_t& out) {
+  if (!n) return false;
+  uint64_t v = 0;
+  for (uint8_t i = 0; i < n; ++i) {
+    if (s[i] < '0' || s[i] > '9') return false;
+    v = v * 10 + (uint64_t)(s[i] - '0');
+    if (v > 0xFFFFFFFFull) return false;
+  }
+  out = (uint32_t)v;
+  return true;
+}
+
+}  // namespace
+
+void NotifyParser::reset() {
+  const uint32_t m = _messages, e = _errors;
+  *this = NotifyParser();
+  _messages = m; _errors = e;
+}
+
+void NotifyParser::fail() {
+  _errors++;
+  reset();
+}
+
+bool NotifyParser::keyIs(const char* k) const {
+  return _haveKey && !_trunc && strlen(k) == _keyLen && memcmp(k, _key, _keyLen) == 0;
+}
+
+void NotifyParser::push(bool isObj) {
+  if (_depth >= kMaxDepth) { fail(); return; }
+  if (isObj && _catDepth && _depth == _catDepth) { _catId = -1; _catNameLen = 0; }   // neuer Katalog-Eintrag
+  if (isObj) {
+    _objMask |= (uint8_t)(1u << _depth);
+    if (_objDepth++ == 0) _upd = DeviceState{};   // neue Nachricht
+  } else {
+    _objMask &= (uint8_t)~(1u << _depth);
+  }
+  _depth++;
+  _haveKey = false;
+}
+
+void NotifyParser::pop() {
+  const bool wasObj = inObject();
+  if (_catDepth && wasObj && _depth == _catDepth + 1) {
+    catalogOnEntry(_catId >= 0 ? _catId : _catCount, _catName, _catNameLen);
+    _catCount++;
+  } else if (_catDepth && !wasObj && _depth == _catDepth) {
+    catalogOnEnd();
+    _catDepth = 0;
+  }
+  _depth--;
+  if (wasObj && --_objDepth == 0) {
+    deviceStateApply(_upd);
+    _messages++;
+  }
+  _st = _depth ? St::AfterValue : St::Idle;
+}
+
+// Werte innerhalb von "patterns": bloßer String = Eintrag, sonst name/idx des Eintrags.
+// Zu lange Namen werden gekürzt übernommen statt verworfen.
+bool NotifyParser::catalogString(bool isString) {
+  if (!_catDepth) return false;
+  if (_depth == _catDepth && !inObject()) {
+    if (isString) catalogOnEntry(_catCount++, _val, _valLen);
+    return true;
+  }
+  if (_depth != _catDepth + 1 || !inObject() || !_haveKey) return false;
+  if (isString && _keyLen == 4 && memcmp(_key, "name", 4) == 0) {
+    _catNameLen = _valLen < sizeof(_catName) ? _valLen : (uint8_t)sizeof(_catName);
+    memcpy(_catName, _val, _catNameLen);
+  } else if (!isString && (keyIs("idx") || keyIs("id"))) {
+    int v;
+    if (parseNum(_val, _valLen, v)) _catId = (int16_t)v;
+  }
+  _haveKey = false;
+  return true;
+}
+
+void NotifyParser::deliver(bool isString) {
+  if (catalogString(isString)) return;
+  if (!_haveKey || _trunc) { _haveKey = false; return; }
+  if (!isString && keyIs("patternsHash")) {
+    uint32_t h;
+    if (parseU32(_val, _valLen, h)) catalogOnHash(h);
+    _haveKey = false;
+    return;
+  }
+  _haveKey = false;
+  if (isString && _keyLen == 5 && memcmp(_key, "state", 5) == 0) {
+    const uint8_t n = _valLen < sizeof(_upd.state) - 1 ? _valLen : (uint8_t)(sizeof(_upd.state) - 1);
+    memcpy(_upd.state, _val, n);
+    _upd.state[n] = '\0';
+    _upd.fields |= 1u << DevStateStr;
+    return;
+  }
+  for (const KeyMap& k : kKeys) {
+    if (strlen(k.key) != _keyLen || memcmp(k.key, _key, _keyLen) != 0) continue;
+    int v;
+    if (parseNum(_val, _valLen, v)) {
+      _upd.val[k.f] = (int16_t)v;
+      _upd.fields |= 1u << k.f;
+    }
+    return;
+  }
+}
+
+void NotifyParser::feed(const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    const char c = (char)data[i];
+    switch (_st) {
+      case St::Idle:
+        if (c == '{')      { push(true);  _st = St::KeyOrEnd; }
+        else if (c == '[') { push(false); _st = St::Value; }
+        break;                                   // alles andere vor einer Nachricht überlesen
+
+      case St::KeyOrEnd:
+        if (isWs(c)) break;
+        if (c == '"')      { _keyLen = 0; _trunc = false; _esc = false; _st = St::Key; }
+        else if (c == '}') pop();
+        else fail();
+        break;
+
+      case St::Key:
+        if (_esc)            _esc = false;
+        else if (c == '\\') { _esc = true; break; }
+        else if (c == '"')  { _st = St::Colon; break; }
+        if (_keyLen < sizeof(_key)) _key[_keyLen++] = c; else _trunc = true;
+        break;
+
+      case St::Colon:
+        if (isWs(c)) break;
+        if (c == ':') { _haveKey = true; _st = St::Value; }
+        else fail();
+        break;
+
+      case St::Value:
+        if (isWs(c)) break;
+        if (c == '"')      { _valLen = 0; _esc = false; _st = St::Str; }
+        else if (c == '{') { push(true);  _st = St::KeyOrEnd; }
+        else if (c == '[') {
+          const bool cat = keyIs("patterns");
+          push(false);
+          if (cat) { _catDepth = _depth; _catCount = 0; }
+          _st = St::Value;
+        }
+        else if (c == ']' && !inObject()) pop();   // leeres Array
+        else if (c == ',' || c == '}' || c == ']') fail();
+        else { _valLen = 0; _val[_valLen++] = c; _st = St::Scalar; }
+        break;
+
+      case St::Str:
+        if (_esc)            _esc = false;
+        else if (c == '\\') { _esc = true; break; }
+        else if (c == '"')  { deliver(true); _st = St::AfterValue; break; }
+        if (_valLen < sizeof(_val)) _val[_valLen++] = c; else _trunc = true;
+        break;
+
+      case St::Scalar:
+        if (!isWs(c) && c != ',' && c != '}' && c != ']') {
+          if (_valLen < sizeof(_val)) _val[_valLen++] = c; else _trunc = true;
+          break;
+        }
+        deliver(false);
+        _st = St::AfterValue;
+        [[fallthrough]];   // Trenner gleich als Ende des Werts auswerten
+      case St::AfterValue:
+        if (isWs(c)) break;
+        if (c == ',')                    _st = inObject() ? St::KeyOrEnd : St::Value;
+        else if (c == '}' && inObject()) pop();
+        else if (c == ']' && _depth && !inObject()) pop();
+        else fail();
+        break;
+    }
+  }
+}
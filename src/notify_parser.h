@@ -0,0 +1,55 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "device_state.h"
+
+// Inkrementeller JSON-Parser für OSSM-Notifications, eine Instanz pro Characteristic.
+// Kein Heap, kein Nachrichtenpuffer: nur der aktuelle Schlüssel und Skalarwert liegen
+// in kleinen festen Feldern, Pakete dürfen an jeder Stelle geteilt sein.
+//
+// Annahmen zum Format (vom OSSM nicht dokumentiert):
+//  - ein JSON-Objekt pro Nachricht, optional in einem Array "[{..},{..}]", Trenner egal
+//  - bekannte Schlüssel auf beliebiger Tiefe: speed, stroke, depth, sensation, pattern,
+//    position (oder pos) als Zahl, state als String; Zahlen 0..100 wie in den Kommandos
+//  - unbekannte Schlüssel und Array-Skalare werden überlesen
+//  - Musterkatalog "patterns":[…] und "patternsHash" gehen an pattern_catalog.h
+// Ein vollständiges Objekt der äußersten Ebene wird atomar in den DeviceState übernommen.
+class NotifyParser {
+ public:
+  void reset();
+  void feed(const uint8_t* data, size_t len);
+  uint32_t messages() const { return _messages; }
+  uint32_t errors() const   { return _errors; }
+
+ private:
+  enum class St : uint8_t { Idle, KeyOrEnd, Key, Colon, Value, Str, Scalar, AfterValue };
+  static constexpr uint8_t kMaxDepth = 8;
+
+  void push(bool isObj);
+  void pop();
+  void fail();
+  void deliver(bool isString);
+  bool inObject() const { return _depth && (_objMask & (1u << (_depth - 1))); }
+  bool keyIs(const char* k) const;
+  bool catalogString(bool isString);
+
+  St       _st = St::Idle;
+  uint8_t  _depth = 0;
+  uint8_t  _objMask = 0;        // Bit d: Ebene d ist Objekt (sonst Array)
+  uint8_t  _objDepth = 0;       // Anzahl offener Objekte
+  bool     _esc = false;        // vorheriges Zeichen war '\'
+  bool     _haveKey = false;    // Wert gehört zu _key
+  char     _key[12];
+  uint8_t  _keyLen = 0;
+  char     _val[24];
+  uint8_t  _valLen = 0;
+  bool     _trunc = false;      // Schlüssel/Wert länger als der Puffer → verwerfen
+  DeviceState _upd{};
+  // Katalog: Tiefe des "patterns"-Arrays (0 = keins), laufender Eintrag
+  uint8_t  _catDepth = 0;
+  uint8_t  _catCount = 0;
+  int16_t  _catId = -1;
+  char     _catName[24];
+  uint8_t  _catNameLen = 0;
+  uint32_t _messages = 0, _errors = 0;
+};
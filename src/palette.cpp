@@ -0,0 +1,79 @@
+#include "palette.h"
+
+static uint16_t s_pal565[256];   // Host-Byteorder (Mischen, Vergleichen)
+static uint16_t s_palSw[256];    // Puffer-Byteorder (Expandieren)
+static int      s_used = 0;
+static uint32_t s_approx = 0;
+
+// Mischfarben-Cache: direkt abgebildet, Schlüssel fg | bg << 8 | Stufe << 16
+static const int kCacheSize = 512;
+static uint32_t  s_cacheKey[kCacheSize];
+static uint8_t   s_cacheVal[kCacheSize];
+
+static inline uint16_t to565(uint32_t c) {
+  return (uint16_t)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+}
+static inline uint16_t swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+
+// wie blend565 in raster.cpp, Deckung in 16 Stufen
+static inline uint16_t mix565(uint16_t fg, uint16_t bg, uint32_t a16) {
+  uint32_t rb = bg & 0xF81F;
+  rb += ((fg & 0xF81F) - rb) * a16 >> 4;
+  uint32_t g = bg & 0x07E0;
+  g += ((fg & 0x07E0) - g) * a16 >> 4;
+  return (uint16_t)((rb & 0xF81F) | (g & 0x07E0));
+}
+
+static inline int dist565(uint16_t a, uint16_t b) {
+  const int dr = ((a >> 11) & 31) - ((b >> 11) & 31);
+  const int dg = ((a >> 5) & 63) - ((b >> 5) & 63);
+  const int db = (a & 31) - (b & 31);
+  return 4 * dr * dr + dg * dg + 4 * db * db;
+}
+
+static void setEntry(int i, uint16_t c) { s_pal565[i] = c; s_palSw[i] = swap16(c); }
+
+void palInit() {
+  for (int i = 0; i < 256; ++i) setEntry(i, 0);
+  for (int i = 0; i < (int)Pal::Count; ++i) setEntry(i, to565(kPal888[i]));
+  s_used = (int)Pal::Count;
+  s_approx = 0;
+  for (int i = 0; i < kCacheSize; ++i) s_cacheKey[i] = 0xFFFFFFFFu;
+}
+
+uint16_t palColor565(uint8_t idx) { return s_pal565[idx]; }
+
+static uint8_t findOrAdd(uint16_t c) {
+  for (int i = 0; i < s_used; ++i) if (s_pal565[i] == c) return (uint8_t)i;
+  if (s_used < 256) { setEntry(s_used, c); return (uint8_t)s_used++; }
+  int best = 0, bestD = 1 << 30;
+  for (int i = 0; i < 256; ++i) {
+    const int dd = dist565(c, s_pal565[i]);
+    if (dd < bestD) { bestD = dd; best = i; }
+  }
+  ++s_approx;
+  return (uint8_t)best;
+}
+
+uint8_t palBlend(uint8_t fg, uint8_t bg, uint32_t alpha) {
+  const uint32_t a16 = (alpha * 16 + 128) >> 8;   // 0..16
+  if (a16 == 0 || fg == bg) return bg;
+  if (a16 >= 16) return fg;
+  const uint32_t key = fg | (uint32_t)bg << 8 | a16 << 16;
+  const int slot = (int)((key * 2654435761u) >> 23) & (kCacheSize - 1);
+  if (s_cacheKey[slot] == key) return s_cacheVal[slot];
+  const uint8_t v = findOrAdd(mix565(s_pal565[fg], s_pal565[bg], a16));
+  s_cacheKey[slot] = key;
+  s_cacheVal[slot] = v;
+  return v;
+}
+
+void palExpand(const uint8_t* src, uint16_t* dst, int n) {
+  for (; n >= 4; n -= 4, src += 4, dst += 4) {
+    dst[0] = s_palSw[src[0]]; dst[1] = s_palSw[src[1]];
+    dst[2] = s_palSw[src[2]]; dst[3] = s_palSw[src[3]];
+  }
+  while (n--) *dst++ = s_palSw[*src++];
+}
+
+PaletteStats paletteStats() { return PaletteStats{ (uint16_t)s_used, s_approx }; }
@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+
+// UI-Farben als feste Paletteneinträge. Gezeichnet wird immer mit uiCol(Pal::…):
+// im 16-bit-Modus ist das der RGB888-Wert (wie color888), mit UI_PALETTE_8BIT der
+// Paletten-Index, den LGFX auf Palette-Sprites direkt als Pixelwert schreibt.
+// Der 8-bit-Backbuffer (57,6 KB statt 115 KB) wird erst beim Push nach RGB565 expandiert.
+#ifndef UI_PALETTE_8BIT
+#define UI_PALETTE_8BIT 0
+#endif
+
+enum class Pal : uint8_t {
+  Black, White, Green, Silver,
+  Track,          // Ringspuren, Button-Kreise
+  TrackRange,     // Stroke/Depth-Spur
+  Pill,           // Pattern-Pill, Picker-Einträge
+  PillSel,        // gewählter Picker-Eintrag
+  Dim,            // inaktive Punkte/Balken
+  Panel,          // Dialog-Hintergrund
+  Frame,          // Dialog-/Eintragsrahmen
+  BtnFrame,       // Settings-Buttons
+  Accent,         // Speed, verbunden, Schrittpunkte
+  DevPos,         // Ist-Position vom Gerät
+  SpeedPos,       // Speed-Bogen im POSITION-Mode
+  SpeedPosHandle,
+  Range,          // Stroke/Depth-Bogen und Griffe
+  LinkText,
+  Preview,        // Pattern-Vorschau
+  RangeLabel,
+  SpeedLabel,
+  Light,
+  SensNeg,
+  Stop,
+  SensPos,
+  SensHandle,
+  PerfText,
+  Count
+};
+
+constexpr uint32_t rgb888(uint8_t r, uint8_t g, uint8_t b) { return ((uint32_t)r << 16) | ((uint32_t)g << 8) | b; }
+
+constexpr uint32_t kPal888[(int)Pal::Count] = {
+  rgb888(0,0,0),       rgb888(255,255,255), rgb888(0,255,0),     rgb888(192,192,192),
+  rgb888(30,30,30),    rgb888(28,28,28),    rgb888(40,40,40),    rgb888(40,40,70),
+  rgb888(50,50,50),    rgb888(25,25,25),    rgb888(80,80,80),    rgb888(90,90,90),
+  rgb888(0,180,255),   rgb888(0,200,255),   rgb888(60,80,100),   rgb888(120,140,160),
+  rgb888(120,255,120), rgb888(140,160,190), rgb888(180,200,255), rgb888(180,255,180),
+  rgb888(200,220,255), rgb888(220,220,220), rgb888(255,120,0),   rgb888(255,120,120),
+  rgb888(255,200,0),   rgb888(255,230,150), rgb888(255,255,0),
+};
+
+constexpr uint32_t uiCol(Pal p) { return UI_PALETTE_8BIT ? (uint32_t)p : kPal888[(int)p]; }
+
+// Laufzeit-Palette: die festen Einträge, dahinter Mischfarben für geglättete Kanten,
+// die beim ersten Auftreten angelegt werden (Deckung in 16 Stufen). Ist die Palette voll,
+// wird der nächstliegende Eintrag genommen.
+struct PaletteStats {
+  uint16_t used;       // belegte Einträge
+  uint32_t approx;     // Mischfarben ohne eigenen Eintrag
+};
+
+void     palInit();
+uint16_t palColor565(uint8_t idx);                            // RGB565, Host-Byteorder
+uint8_t  palBlend(uint8_t fg, uint8_t bg, uint32_t alpha);    // alpha 0..255
+void     palExpand(const uint8_t* src, uint16_t* dst, int n); // Indizes → RGB565 (Puffer-Byteorder)
+PaletteStats paletteStats();
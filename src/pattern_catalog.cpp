@@ -0,0 +1,370 @@
+#include "pattern_catalog.h"
+#include <Arduino.h>
+#include <Preferences.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "app_state.h"
+#include "ble.h"
+#include "pattern_play.h"   // PATTERN_LOCAL
+#include "patterns.h"
+#include "ui.h"
+
+static const char* kNvsNs = "ossm-cat";
+static constexpr uint8_t  kCatVer     = 2;
+static constexpr uint16_t kInRegistry = 0xFFFF;   // Name = Registry-String im Flash
+static constexpr int      kPoolMax    = kCatalogMax * (kCatalogNameMax + 1);
+static constexpr int      kWinSlots   = 7;        // 6 sichtbare Picker-Zeilen + Auswahl (Pill)
+
+// NVS-Blob "tab"; "pool" enthält die übrigen Namen, je mit '\0' abgeschlossen
+struct CatEntry { uint8_t id; int8_t gen; uint16_t off; };
+struct CatTable {
+  uint8_t  ver, count;
+  uint16_t poolBytes;
+  uint8_t  dropped;       // Einträge jenseits kCatalogMax (gekürzt, Hash deckt sie nicht ab)
+  uint32_t hash;
+  uint32_t regHash;       // Registry beim Speichern – ändert sie sich (Update), ist gen ungültig
+  CatEntry e[kCatalogMax];
+};
+
+static CatTable      s_tab = {};
+static CatalogSource s_src = CatalogSource::Builtin;
+static CatalogStats  s_stats = {};
+
+// Namensfenster: Pool-Namen der sichtbaren Zeilen und der Auswahl
+struct WinSlot { int8_t row; uint32_t used; char name[kCatalogNameMax + 1]; };
+static WinSlot  s_win[kWinSlots];
+static uint32_t s_winTick = 0;
+static int      s_winFirst = 0, s_winN = 0;
+
+// Abruf: Puffer nur während des Empfangs; NimBLE-Task schreibt, loop() übernimmt
+struct Staging {
+  uint8_t n;
+  uint8_t dropped;        // Einträge über kCatalogMax
+  int16_t id[kCatalogMax];
+  char    name[kCatalogMax][kCatalogNameMax + 1];
+};
+enum class Fetch : uint8_t { Idle, WaitHash, Receiving, Done };
+static portMUX_TYPE      s_mux = portMUX_INITIALIZER_UNLOCKED;
+static Staging*          s_stage = nullptr;
+static volatile Fetch    s_fetch = Fetch::Idle;
+static volatile bool     s_complete = false;
+static volatile bool     s_devHashKnown = false;
+static volatile uint32_t s_devHash = 0;
+static uint32_t          s_linkMs = 0, s_fetchMs = 0;
+
+static uint32_t fnv1a(uint32_t h, const void* p, size_t n) {
+  const uint8_t* b = (const uint8_t*)p;
+  for (size_t i = 0; i < n; ++i) h = (h ^ b[i]) * 16777619u;
+  return h;
+}
+static constexpr uint32_t kFnvBasis = 2166136261u;
+
+static uint32_t registryHash() {
+  uint32_t h = kFnvBasis;
+  for (int i = 0; i < patternCount(); ++i) h = fnv1a(h, patternName(i), strlen(patternName(i)) + 1);
+  return h;
+}
+
+static int registryIndex(const char* name, size_t len) {
+  for (int i = 0; i < patternCount(); ++i)
+    if (strlen(patternName(i)) == len && memcmp(patternName(i), name, len) == 0) return i;
+  return -1;
+}
+
+static const char* sourceName(CatalogSource s) {
+  switch (s) {
+    case CatalogSource::Cached: return "NVS";
+    case CatalogSource::Device: return "device";
+    default:                    return "builtin";
+  }
+}
+
+static void clearWindow() {
+  for (WinSlot& w : s_win) w.row = -1;
+}
+
+static void fillWindow();
+
+// Registry als Katalog: Index = ID, wie vor dem Katalog
+static void useBuiltin() {
+  CatTable t = {};
+  t.ver = kCatVer;
+  t.count = (uint8_t)std::min(patternCount(), kCatalogMax);
+  uint32_t h = kFnvBasis;
+  for (int i = 0; i < t.count; ++i) {
+    t.e[i] = CatEntry{ (uint8_t)i, (int8_t)i, kInRegistry };
+    h = fnv1a(fnv1a(h, &t.e[i].id, 1), patternName(i), strlen(patternName(i)) + 1);
+  }
+  t.hash = h;
+  t.regHash = registryHash();
+  s_tab = t;
+  s_src = CatalogSource::Builtin;
+  clearWindow();
+}
+
+void catalogInit() {
+  useBuiltin();
+  Preferences p;
+  if (p.begin(kNvsNs, /*readOnly=*/true)) {
+    CatTable t;
+    if (p.getBytes("tab", &t, sizeof t) == sizeof t && t.ver == kCatVer && t.count && t.count <= kCatalogMax &&
+        t.regHash == s_tab.regHash) {
+      s_tab = t;
+      s_src = CatalogSource::Cached;
+    }
+    p.end();
+  }
+  fillWindow();   // Name der Auswahl für die Pill
+  Serial.printf("[CAT] %u patterns from %s (hash %08x)\n", (unsigned)s_tab.count, sourceName(s_src), (unsigned)s_tab.hash);
+}
+
+// -------------------- Zugriff --------------------
+int catalogCount() { return s_tab.count; }
+
+static int clampRow(int i) { return i < 0 ? 0 : (i >= s_tab.count ? s_tab.count - 1 : i); }
+
+int catalogId(int i)  { return s_tab.count ? s_tab.e[clampRow(i)].id : i; }
+int catalogGen(int i) { return s_tab.count ? s_tab.e[clampRow(i)].gen : -1; }
+
+const uint8_t* catalogPreview(int i) {
+  const int g = catalogGen(i);
+  return g >= 0 ? patternPreview(g) : nullptr;
+}
+
+static bool pinned(int row) {
+  return row == g_patternIndex || (row >= s_winFirst && row < s_winFirst + s_winN);
+}
+
+// freier bzw. am längsten ungenutzter, nicht gepinnter Slot
+static WinSlot& freeSlot() {
+  WinSlot* best = nullptr;
+  for (WinSlot& w : s_win) {
+    if (w.row < 0) return w;
+    if (pinned(w.row)) continue;
+    if (!best || w.used < best->used) best = &w;
+  }
+  return best ? *best : s_win[0];
+}
+
+static bool inWindow(int row) {
+  for (const WinSlot& w : s_win) if (w.row == row) return true;
+  return false;
+}
+
+// Fehlende Pool-Namen der Fensterzeilen und der Auswahl mit einem NVS-Zugriff laden –
+// außerhalb des Zeichnens (catalogSetWindow, Init, Übernahme), catalogName liest nur
+static void fillWindow() {
+  int need[kWinSlots];
+  int n = 0;
+  auto want = [&](int row) {
+    if (row < 0 || row >= s_tab.count || s_tab.e[row].off == kInRegistry || inWindow(row)) return;
+    for (int k = 0; k < n; ++k) if (need[k] == row) return;
+    if (n < kWinSlots) need[n++] = row;
+  };
+  want(g_patternIndex);
+  for (int i = std::max(s_winFirst, 0); i < std::min(s_winFirst + s_winN, (int)s_tab.count); ++i) want(i);
+  if (!n) return;
+
+  char pool[kPoolMax];   // nur für diesen Aufruf
+  size_t len = 0;
+  Preferences p;
+  if (p.begin(kNvsNs, /*readOnly=*/true)) {
+    len = p.getBytes("pool", pool, sizeof pool);
+    p.end();
+  }
+  s_stats.poolReads++;
+  for (int k = 0; k < n; ++k) {
+    WinSlot& w = freeSlot();
+    w.row = (int8_t)need[k];
+    w.used = ++s_winTick;
+    w.name[0] = '\0';
+    const uint16_t off = s_tab.e[need[k]].off;
+    if (off < len) {
+      strncpy(w.name, pool + off, kCatalogNameMax);
+      w.name[kCatalogNameMax] = '\0';
+    }
+    s_stats.nameLoads++;
+  }
+}
+
+const char* catalogName(int i) {
+  if (!s_tab.count) return "";
+  i = clampRow(i);
+  const CatEntry& e = s_tab.e[i];
+  if (e.off == kInRegistry) return patternName(e.gen);
+  for (WinSlot& w : s_win)
+    if (w.row == i) { w.used = ++s_winTick; return w.name; }
+  return "";   // nicht im Fenster: catalogSetWindow() lädt sie vor dem Zeichnen
+}
+
+void catalogSetWindow(int first, int n) {
+  s_winFirst = first;
+  s_winN = n;
+  fillWindow();
+}
+
+CatalogStats catalogStats() {
+  CatalogStats st = s_stats;
+  st.source = s_src;
+  st.count = s_tab.count;
+  st.hash = s_tab.hash;
+  st.poolBytes = s_tab.poolBytes;
+  st.dropped = s_tab.dropped;
+  return st;
+}
+
+// -------------------- Abruf --------------------
+void catalogOnHash(uint32_t h) {
+  s_devHash = h;
+  s_devHashKnown = true;
+}
+
+void catalogOnEntry(int id, const char* name, uint8_t len) {
+  portENTER_CRITICAL(&s_mux);
+  if (s_fetch == Fetch::Receiving && s_stage && s_stage->n < kCatalogMax && id >= 0 && id <= 255) {
+    Staging& st = *s_stage;
+    const uint8_t n = len < kCatalogNameMax ? len : (uint8_t)kCatalogNameMax;
+    memcpy(st.name[st.n], name, n);
+    st.name[st.n][n] = '\0';
+    st.id[st.n] = (int16_t)id;
+    st.n++;
+  } else if (s_fetch == Fetch::Receiving && s_stage && s_stage->n == kCatalogMax && s_stage->dropped < 255) {
+    s_stage->dropped++;
+  }
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void catalogOnEnd() {
+  if (s_fetch == Fetch::Receiving) s_complete = true;
+}
+
+static void dropStaging() {
+  portENTER_CRITICAL(&s_mux);
+  Staging* st = s_stage;
+  s_stage = nullptr;
+  s_complete = false;
+  portEXIT_CRITICAL(&s_mux);
+  free(st);
+}
+
+static void startFetch(uint32_t now) {
+  dropStaging();
+  Staging* st = (Staging*)calloc(1, sizeof(Staging));
+  if (!st) { Serial.println("[CAT] no memory for catalog fetch"); s_fetch = Fetch::Done; return; }
+  portENTER_CRITICAL(&s_mux);
+  s_stage = st;
+  portEXIT_CRITICAL(&s_mux);
+  s_fetch = Fetch::Receiving;
+  s_fetchMs = now;
+  s_stats.fetches++;
+  bleSendGetPatterns();
+}
+
+// Empfangene Liste internieren: Registry-Namen → Flash, übrige einmal in den Pool
+static void commit(const Staging& st) {
+  CatTable t = {};
+  t.ver = kCatVer;
+  t.regHash = registryHash();
+  char pool[kPoolMax];
+  uint16_t pb = 0;
+  uint32_t h = kFnvBasis;
+  for (int i = 0; i < st.n; ++i) {
+    const char* name = st.name[i];
+    const size_t len = strlen(name);
+    const uint8_t id = (uint8_t)st.id[i];
+    h = fnv1a(fnv1a(h, &id, 1), name, len + 1);
+    const int gen = registryIndex(name, len);
+    uint16_t off = kInRegistry;
+    if (gen < 0) {
+      for (uint16_t o = 0; o < pb; o += (uint16_t)strlen(pool + o) + 1)
+        if (strcmp(pool + o, name) == 0) { off = o; break; }
+      if (off == kInRegistry) {
+        off = pb;
+        memcpy(pool + pb, name, len + 1);
+        pb = (uint16_t)(pb + len + 1);
+      }
+    }
+    t.e[t.count++] = CatEntry{ id, (int8_t)gen, off };
+  }
+  t.hash = s_devHashKnown ? s_devHash : h;
+  t.poolBytes = pb;
+  t.dropped = st.dropped;
+  if (!t.count) { Serial.println("[CAT] device sent an empty catalog, ignored"); return; }
+  if (t.dropped)
+    Serial.printf("[CAT] device sent %u more patterns than fit (%d), catalog incomplete\n", (unsigned)t.dropped,
+                  kCatalogMax);
+
+  const int selId = catalogId(g_patternIndex);
+  const bool same = s_src != CatalogSource::Builtin && t.hash == s_tab.hash && t.count == s_tab.count &&
+                    t.dropped == s_tab.dropped && memcmp(t.e, s_tab.e, t.count * sizeof(CatEntry)) == 0;
+  if (!same) {
+    Preferences p;
+    if (p.begin(kNvsNs, false)) {
+      p.putBytes("tab", &t, sizeof t);
+      if (pb) p.putBytes("pool", pool, pb); else p.remove("pool");
+      p.end();
+      s_stats.stores++;
+    }
+  }
+  s_tab = t;
+  s_src = CatalogSource::Device;
+  clearWindow();
+
+  // Auswahl bleibt auf derselben Geräte-ID; fehlt sie, erstes Muster – und das auch der
+  // Maschine sagen, sonst zeigt die Pill ein anderes Muster als das laufende
+  int sel = -1;
+  for (int i = 0; i < t.count; ++i) if (t.e[i].id == selId) { sel = i; break; }
+  if (sel < 0) {
+    Serial.printf("[CAT] selected pattern %d no longer offered, switching to %d\n", selId, (int)t.e[0].id);
+    sel = 0;
+    if (!PATTERN_LOCAL) bleSendPattern(t.e[0].id);
+  }
+  g_patternIndex = sel;
+  fillWindow();
+  uiInvalidateAll();
+  Serial.printf("[CAT] %u patterns from device (hash %08x, %u B pool)%s\n", (unsigned)t.count, (unsigned)t.hash,
+                (unsigned)pb, same ? ", unchanged" : ", stored");
+}
+
+void catalogOnLink() {
+  dropStaging();
+  s_devHashKnown = false;
+  s_fetch = Fetch::WaitHash;
+  s_linkMs = millis();
+}
+
+void catalogTick() {
+  if (s_fetch != Fetch::WaitHash && s_fetch != Fetch::Receiving) return;   // nur kurz nach dem Verbinden
+  if (!ble_is_connected()) { dropStaging(); s_fetch = Fetch::Idle; return; }
+  const uint32_t now = millis();
+  switch (s_fetch) {
+    case Fetch::WaitHash:
+      // gekürzter Katalog: gleicher Hash sagt nichts über die fehlenden Einträge, immer abrufen
+      if (s_devHashKnown && s_src != CatalogSource::Builtin && !s_tab.dropped && s_devHash == s_tab.hash) {
+        s_stats.skips++;
+        s_fetch = Fetch::Done;
+        Serial.printf("[CAT] catalog unchanged (hash %08x), no fetch\n", (unsigned)s_tab.hash);
+      } else if (s_devHashKnown || now - s_linkMs >= CATALOG_HASH_WAIT_MS) {
+        startFetch(now);
+      }
+      break;
+    case Fetch::Receiving:
+      if (s_complete) {
+        portENTER_CRITICAL(&s_mux);
+        s_fetch = Fetch::Done;   // ab hier schreibt der NimBLE-Task nicht mehr
+        portEXIT_CRITICAL(&s_mux);
+        commit(*s_stage);
+        dropStaging();
+        s_fetch = Fetch::Done;
+      } else if (now - s_fetchMs >= CATALOG_FETCH_MS) {
+        Serial.printf("[CAT] no catalog from device, keeping %s\n", sourceName(s_src));
+        dropStaging();
+        s_fetch = Fetch::Done;
+      }
+      break;
+    default:
+      break;
+  }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <stdint.h>
+
+// Musterkatalog: welche Muster die Maschine anbietet und unter welcher ID (setPattern).
+// Quelle: Gerät beim Verbinden, sonst die NVS-Kopie des letzten Abrufs, sonst die
+// eingebaute Registry (patterns.h, Index = ID wie bisher).
+//
+// RAM: nur die Tabelle ID / Registry-Index / Pool-Offset (4 B pro Muster). Namen, die es in
+// der Registry gibt, zeigen auf deren Flash-String; alle anderen liegen im NVS-Pool
+// (dedupliziert) und werden nur für die sichtbaren Picker-Zeilen und die Auswahl geladen.
+//
+// Protokoll-Annahmen (vom OSSM nicht dokumentiert, Parser: notify_parser.cpp):
+//  - {"action":"getPatterns"} auf der Control-Char fordert den Katalog an
+//  - Antwort per Notification, beliebig geteilt: {"patterns":[{"idx":0,"name":"…"},…]};
+//    Einträge dürfen auch bloße Strings sein (ID = Position), "id" statt "idx" geht auch
+//  - "patternsHash":<uint32> auf beliebiger Ebene, z. B. in der Statusmeldung, kennzeichnet
+//    die Katalog-Version. Stimmt er mit dem gespeicherten überein, entfällt der Abruf.
+//    Meldet das Gerät keinen, wird nach CATALOG_HASH_WAIT_MS abgerufen und ein FNV-1a über
+//    IDs und Namen verglichen – geschrieben wird der Flash dann nur bei Änderungen.
+//  - mehr als kCatalogMax Einträge: gekürzt und als unvollständig markiert – dann wird bei
+//    jedem Verbinden abgerufen, der Hash allein gilt nicht als "unverändert"
+//  - keine Antwort binnen CATALOG_FETCH_MS: Firmware kennt das Kommando nicht, der
+//    bisherige Katalog bleibt.
+#ifndef CATALOG_HASH_WAIT_MS
+#define CATALOG_HASH_WAIT_MS 1500
+#endif
+#ifndef CATALOG_FETCH_MS
+#define CATALOG_FETCH_MS 3000
+#endif
+
+constexpr int kCatalogMax     = 24;
+constexpr int kCatalogNameMax = 24;   // längere Namen werden gekürzt (wie im Parser)
+
+enum class CatalogSource : uint8_t { Builtin, Cached, Device };
+
+struct CatalogStats {
+  CatalogSource source;
+  uint8_t  count;
+  uint32_t hash;
+  uint32_t fetches;      // angeforderte Kataloge seit Boot
+  uint32_t skips;        // Verbindungen ohne Abruf (Hash unverändert)
+  uint32_t stores;       // NVS-Schreibvorgänge
+  uint16_t poolBytes;    // Namen außerhalb der Registry im NVS
+  uint8_t  dropped;      // Einträge über kCatalogMax (Katalog unvollständig)
+  uint32_t nameLoads;    // Namen aus dem Pool ins Fenster geladen
+  uint32_t poolReads;    // NVS-Lesezugriffe auf den Pool (einer je Fensterwechsel mit fehlenden Namen)
+};
+
+void           catalogInit();               // NVS laden (vor dem ersten Zeichnen)
+int            catalogCount();
+int            catalogId(int i);            // für bleSendPattern
+int            catalogGen(int i);           // Index in die Registry, −1 = kein Generator
+const char*    catalogName(int i);          // Fenster/Auswahl, sonst ""; ohne NVS-Zugriff
+const uint8_t* catalogPreview(int i);       // nullptr ohne Generator
+void           catalogSetWindow(int first, int n);   // Picker: diese Zeilen (und die Auswahl) laden, vor dem Zeichnen
+void           catalogTick();               // loop(): Abruf nach dem Verbinden, Übernahme
+void           catalogOnLink();             // ble_tick: Verbindung steht
+CatalogStats   catalogStats();
+
+// aus dem Notification-Parser (NimBLE-Task)
+void catalogOnHash(uint32_t h);
+void catalogOnEntry(int id, const char* name, uint8_t len);
+void catalogOnEnd();
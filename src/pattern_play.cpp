@@ -0,0 +1,167 @@
+#include "pattern_play.h"
+#include <Arduino.h>
+#include <math.h>
+#include <algorithm>
+#include "app_state.h"
+#include "ble.h"
+#include "device_state.h"
+#include "pattern_catalog.h"
+#include "utils.h"
+
+// ---------- Parameter ----------
+static const uint32_t kStepMs    = 10;     // Tastschritt des Generators
+static const uint32_t kMinMoveMs = 50;     // kürzestes move (bleSendMove klemmt auf 50)
+static const uint32_t kMinSegMs  = 80;     // kürzestes Segment: Reserve für verspätetes Senden
+static const uint32_t kMaxSegMs  = 250;    // längstes Segment, auch bei geraden Stücken
+static const uint32_t kLeadInMs  = 400;    // Einlauf von der Ist-Position zum Musterstart
+static const int      kMaxSteps  = kMaxSegMs / kStepMs;
+
+// ---------- Zustandsmaschine ----------
+float PatternStream::sample(float phase) const {
+  const float v = clampf(_p.gen(phase), 0.0f, 1.0f);
+  return (float)_p.lo + v * (float)(_p.hi - _p.lo);
+}
+
+bool PatternStream::push(const Seg& s) {
+  if (_n == kCap) return false;
+  _buf[(_head + _n) % kCap] = s;
+  _n++;
+  _tail = s;
+  return true;
+}
+
+void PatternStream::start(const PlayParams& p, uint32_t nowMs, int fromPos) {
+  _p = p;
+  _running = true;
+  _head = _n = 0;
+  _sentAny = false;
+  _cur = Seg{ nowMs, 0.0f, (uint8_t)clampi(fromPos, 0, 100) };
+  push(Seg{ nowMs + kLeadInMs, 0.0f, (uint8_t)lroundf(sample(0.0f)) });
+}
+
+void PatternStream::setParams(const PlayParams& p) {
+  if (!_running || p == _p) return;
+  _p = p;
+  _head = _n = 0;
+  _stats.replans++;
+  // noch nichts gesendet: Einlauf mit neuen Werten, sonst ab dem laufenden Segment neu tasten
+  if (!_sentAny) push(Seg{ _cur.tMs + kLeadInMs, 0.0f, (uint8_t)lroundf(sample(0.0f)) });
+  else           _tail = _cur;
+}
+
+// Ab _tail tasten, bis der Puffer PLAY_LOOKAHEAD_MS reicht. Ein Segment endet am letzten
+// Tastpunkt, bis zu dem die Gerade vom Anfang alle Zwischenwerte innerhalb PLAY_TOL_PCT trifft.
+void PatternStream::refill(uint32_t nowMs) {
+  if (_n && (int32_t)(_tail.tMs - nowMs) >= (int32_t)PLAY_LOOKAHEAD_MS / 2) return;
+  if ((int32_t)(nowMs - _tail.tMs) > 0) {
+    // langer Stau: Musterzeit nachziehen statt Vergangenes nachzuholen
+    _tail.phase = fmodf(_tail.phase + (float)(nowMs - _tail.tMs) / (float)_p.cycleMs, 1.0f);
+    _tail.tMs = nowMs;
+  }
+  _stats.batches++;
+
+  const float dPhase = (float)kStepMs / (float)_p.cycleMs;
+  float sp[kMaxSteps];
+  int k = 0;
+  Seg a = _tail;
+  uint32_t t = a.tMs;
+  float ph = a.phase;
+  while ((int32_t)(t - nowMs) < (int32_t)PLAY_LOOKAHEAD_MS && _n < kCap) {
+    const float prevPh = ph;
+    t += kStepMs;
+    ph += dPhase;
+    if (ph >= 1.0f) ph -= 1.0f;
+    const float v = sample(ph);
+
+    bool fits = k < kMaxSteps;
+    for (int i = 0; fits && i < k; ++i) {
+      const float lin = (float)a.pos + (v - (float)a.pos) * (float)(i + 1) / (float)(k + 1);
+      fits = fabsf(sp[i] - lin) <= PLAY_TOL_PCT;
+    }
+    if (fits || (uint32_t)k * kStepMs < kMinSegMs) { sp[k++] = v; continue; }
+    // Gerade passt nicht mehr: Segment am vorigen Tastpunkt beenden, dieser beginnt das nächste
+    if (!push(Seg{ t - kStepMs, prevPh, (uint8_t)lroundf(sp[k - 1]) })) break;
+    a = _tail;
+    sp[0] = v;
+    k = 1;
+  }
+}
+
+bool PatternStream::next(uint32_t nowMs, uint32_t latencyMs, MotionSegment& out) {
+  if (!_running) return false;
+  refill(nowMs);
+  while (_n) {
+    // Segment beginnt am Ende des vorigen; so früh senden, dass es dann ankommt
+    const int32_t early = (int32_t)(_cur.tMs - latencyMs - nowMs);
+    if (early > 0) return false;
+    const Seg s = _buf[_head];
+    _head = (uint8_t)((_head + 1) % kCap);
+    _n--;
+    _cur = s;
+    if (!_n) refill(nowMs);
+    const int32_t ms = (int32_t)(s.tMs - (nowMs + latencyMs));
+    if (ms < (int32_t)kMinMoveMs) { _stats.skipped++; continue; }
+    if ((uint32_t)-early > _stats.maxLateMs) _stats.maxLateMs = (uint32_t)-early;
+    _sentAny = true;
+    out = MotionSegment{ s.pos, (int)ms };
+    _stats.segments++;
+    return true;
+  }
+  return false;
+}
+
+int32_t PatternStream::dueInMs(uint32_t nowMs, uint32_t latencyMs) const {
+  if (!_running) return -1;
+  if (!_n) return 0;   // Puffer leer: next() tastet nach
+  const int32_t early = (int32_t)(_cur.tMs - latencyMs - nowMs);
+  return early > 0 ? early : 0;
+}
+
+PlayStats PatternStream::stats(uint32_t nowMs) const {
+  PlayStats st = _stats;
+  const int32_t buffered = _n ? (int32_t)(_tail.tMs - nowMs) : 0;
+  st.bufferedMs = (uint16_t)clampi(buffered, 0, 65535);
+  return st;
+}
+
+// -------------------- Gerät --------------------
+static PatternStream s_stream;
+
+#if PATTERN_LOCAL
+static PlayParams currentParams() {
+  const int lo = std::min(g_stroke, g_depth), hi = std::max(g_stroke, g_depth);
+  const int sp = clampi(g_speed, 1, 100);
+  const uint32_t cycle = PLAY_CYCLE_SLOW_MS - (uint32_t)(PLAY_CYCLE_SLOW_MS - PLAY_CYCLE_FAST_MS) * (sp - 1) / 99;
+  const int gen = catalogGen(g_patternIndex);   // Gerätemuster ohne Generator: Simple Stroke
+  return PlayParams{ patternAt(gen < 0 ? 0 : gen).gen, lo, hi, cycle };
+}
+
+// Laufzeit ≈ halbe RTT der TX-Regelung, ohne Messung ein typischer Verbindungsabstand
+static uint32_t latencyMs() {
+  const float rtt = ble_tx_stats().rttMs;
+  return rtt > 0.0f ? (uint32_t)clampf(rtt * 0.5f, 5.0f, 150.0f) : 15;
+}
+
+void playTick() {
+  const bool want = g_mode == Mode::SPEED && g_running && g_speed > 0 && ble_is_connected();
+  if (!want) { s_stream.stop(); return; }
+  const uint32_t now = millis();
+  const PlayParams p = currentParams();
+  if (!s_stream.running()) {
+    bleSendStartStreaming();
+    const DeviceState dev = deviceStateGet();
+    s_stream.start(p, now, dev.has(DevPosition) ? dev.val[DevPosition] : p.lo);
+  } else {
+    s_stream.setParams(p);
+  }
+  MotionSegment seg;
+  if (s_stream.next(now, latencyMs(), seg)) bleSendMove(seg.pos, seg.ms, true);
+}
+
+int32_t playDueInMs() { return s_stream.dueInMs(millis(), latencyMs()); }
+#else
+void playTick() {}
+int32_t playDueInMs() { return -1; }
+#endif
+
+PlayStats playStats() { return s_stream.stats(millis()); }
@@ -0,0 +1,86 @@
+#pragma once
+#include <stdint.h>
+#include "motion.h"     // MotionSegment
+#include "patterns.h"   // PatternGen
+
+// Pattern-Wiedergabe auf der Fernbedienung (SPEED-Mode mit PATTERN_LOCAL=1):
+// Statt setPattern an die Firmware werden die Generatoren aus patterns.cpp (oder eigene)
+// blockweise vorausgetastet, zu move-Segmenten mit Endzeit zusammengefasst (stückweise
+// linear, Abweichung ≤ PLAY_TOL_PCT) und aus einem Vorausschau-Puffer gesendet.
+//   Skalierung  Position = Stroke + gen(t)·(Depth − Stroke), Zyklusdauer aus g_speed
+//   Zeitbasis   jedes Segment endet zu einer festen Musterzeit; gesendet wird um die
+//               geschätzte Laufzeit früher, ms = Endzeit − Ankunft. Kommt ein Segment zu
+//               spät (loop()-Stau), wird es kürzer statt verschoben – Jitter summiert sich
+//               nicht auf. Ist es kürzer als 50 ms, entfällt es zugunsten des nächsten.
+//   Änderung    Speed/Stroke/Depth/Muster: Puffer ab dem laufenden Segment neu tasten,
+//               Phase läuft stetig weiter.
+// Default aus: dann spielt wie bisher die Firmware ihr Muster (bleSendPattern).
+#ifndef PATTERN_LOCAL
+#define PATTERN_LOCAL 0
+#endif
+#ifndef PLAY_CYCLE_SLOW_MS
+#define PLAY_CYCLE_SLOW_MS 6000   // Vorschau-Zyklus bei Speed 1
+#endif
+#ifndef PLAY_CYCLE_FAST_MS
+#define PLAY_CYCLE_FAST_MS 1200   // … bei Speed 100
+#endif
+#ifndef PLAY_LOOKAHEAD_MS
+#define PLAY_LOOKAHEAD_MS 600     // so weit reicht der Puffer nach einem Nachtasten
+#endif
+#ifndef PLAY_TOL_PCT
+#define PLAY_TOL_PCT 1.0f         // erlaubte Abweichung der Segmente vom Generator
+#endif
+
+struct PlayParams {
+  PatternGen gen;
+  int        lo, hi;       // 0..100
+  uint32_t   cycleMs;
+  bool operator==(const PlayParams& o) const {
+    return gen == o.gen && lo == o.lo && hi == o.hi && cycleMs == o.cycleMs;
+  }
+};
+
+struct PlayStats {
+  uint32_t segments;     // gesendete move-Segmente
+  uint32_t skipped;      // zu spät (< 50 ms Restzeit), übersprungen
+  uint32_t batches;      // Nachtast-Blöcke
+  uint32_t replans;      // Puffer wegen Parameteränderung verworfen
+  uint32_t maxLateMs;    // größte Verspätung eines Sendezeitpunkts
+  uint16_t bufferedMs;   // Vorrat im Puffer (jetzt)
+};
+
+class PatternStream {
+ public:
+  static constexpr int kCap = 32;
+
+  void start(const PlayParams& p, uint32_t nowMs, int fromPos);   // Einlauf von fromPos
+  void setParams(const PlayParams& p);       // Änderung ab dem laufenden Segment
+  void stop() { _running = false; }
+  bool running() const { return _running; }
+  // true = jetzt senden; latencyMs = geschätzte Laufzeit bis zum Gerät
+  bool next(uint32_t nowMs, uint32_t latencyMs, MotionSegment& out);
+  // ms bis zum nächsten Sendezeitpunkt (0 = jetzt), −1 = läuft nicht; für Pausen in loop()
+  int32_t dueInMs(uint32_t nowMs, uint32_t latencyMs) const;
+  PlayStats stats(uint32_t nowMs) const;
+
+ private:
+  struct Seg { uint32_t tMs; float phase; uint8_t pos; };   // Ankunft an pos zur Musterzeit tMs
+
+  void  refill(uint32_t nowMs);
+  float sample(float phase) const;
+  bool  push(const Seg& s);
+
+  PlayParams _p = {};
+  bool       _running = false;
+  bool       _sentAny = false;
+  Seg        _buf[kCap];
+  uint8_t    _head = 0, _n = 0;
+  Seg        _tail = {};       // zuletzt getasteter Endpunkt (Beginn des nächsten Blocks)
+  Seg        _cur = {};        // Endpunkt des zuletzt gesendeten Segments
+  PlayStats  _stats = {};
+};
+
+// Gerät: in loop() nach inputUpdate()
+void      playTick();
+int32_t   playDueInMs();   // powerIdleWait(): Pause endet vor dem nächsten Segment; −1 = keine Wiedergabe
+PlayStats playStats();
@@ -0,0 +1,86 @@
+#include "patterns.h"
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+
+// ---------- Generatoren (Formeln wie bisher in der Picker-Vorschau) ----------
+static float genSimple(float t)  { return 0.5f + 0.45f * sinf(2*M_PI*t); }
+static float genTeasing(float t) { return 0.5f + 0.45f * powf(sinf(2*M_PI*t),3); }
+static float genRobo(float t)    { return 1.0f - fabsf(fmodf(t*2.0f,2.0f)-1.0f); }
+static float genHalf(float t)    { return 0.5f + (((int)floorf(t*2)%2)? 0.25f:0.45f) * sinf(2*M_PI*fmodf(t*2,1.0f)); }
+static float genDeeper(float t)  { float a = (floorf(t*4)+1)/4.0f; return 0.5f + 0.45f*a*sinf(2*M_PI*fmodf(t*4,1.0f)); }
+static float genStopGo(float t)  { float loc=fmodf(t*3,1.0f); return (loc<0.7f)? 0.5f + 0.45f*sinf(2*M_PI*loc/0.7f) : 0.5f; }
+static float genInsist(float t)  { return 0.5f + 0.15f*sinf(2*M_PI*t) + 0.25f*sinf(4*M_PI*t); }
+static float genJack(float t)    { return (t<0.6f)? 0.5f + 0.35f*sinf(20*M_PI*t) : 1.0f - (t-0.6f)/0.4f; }
+static float genNibbler(float t) { return 0.5f + 0.2f*sinf(10*M_PI*t); }
+
+static const PatternDesc kPatterns[] = {
+  { "Simple Stroke",       genSimple  },
+  { "Teasing or Pounding", genTeasing },
+  { "Robo Stroke",         genRobo    },
+  { "Half'n'Half",         genHalf    },
+  { "Deeper",              genDeeper  },
+  { "Stop'n'Go",           genStopGo  },
+  { "Insist",              genInsist  },
+  { "Jack Hammer",         genJack    },
+  { "Stroke Nibbler",      genNibbler },
+};
+static constexpr int kPatternCount = sizeof(kPatterns) / sizeof(kPatterns[0]);
+
+static uint8_t s_preview[kPatternCount][kPreviewH * kPreviewStride];
+static bool    s_previewReady = false;
+
+// ---------- Vorschau rastern: 60 Stützstellen als Polylinie ----------
+static void plot(uint8_t* bmp, int x, int y) {
+  if (x < 0 || y < 0 || x >= kPreviewW || y >= kPreviewH) return;
+  bmp[y * kPreviewStride + (x >> 3)] |= (uint8_t)(0x80 >> (x & 7));
+}
+
+static void line(uint8_t* bmp, int x0, int y0, int x1, int y1) {
+  int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int err = dx + dy;
+  for (;;) {
+    plot(bmp, x0, y0);
+    if (x0 == x1 && y0 == y1) break;
+    int e2 = 2 * err;
+    if (e2 >= dy) { err += dy; x0 += sx; }
+    if (e2 <= dx) { err += dx; y0 += sy; }
+  }
+}
+
+static void renderPreview(const PatternDesc& p, uint8_t* bmp) {
+  const int prevN = 60;
+  const int w = kPreviewW - 1, h = kPreviewH - 1;
+  memset(bmp, 0, kPreviewH * kPreviewStride);
+  int lastx = 0, lasty = h / 2;
+  for (int k = 0; k < prevN; k++) {
+    float t = (float)k / (prevN - 1);
+    float v = p.gen(t);
+    int x = (int)roundf(t * w);
+    int y = h - (int)roundf(v * h);
+    line(bmp, lastx, lasty, x, y);
+    lastx = x; lasty = y;
+  }
+}
+
+void patternsInit() {
+  if (s_previewReady) return;
+  for (int i = 0; i < kPatternCount; ++i) renderPreview(kPatterns[i], s_preview[i]);
+  s_previewReady = true;
+}
+
+int patternCount() { return kPatternCount; }
+
+const PatternDesc& patternAt(int i) {
+  if (i < 0) i = 0; else if (i >= kPatternCount) i = kPatternCount - 1;
+  return kPatterns[i];
+}
+
+const char* patternName(int i) { return patternAt(i).name; }
+
+const uint8_t* patternPreview(int i) {
+  if (!s_previewReady) patternsInit();
+  if (i < 0) i = 0; else if (i >= kPatternCount) i = kPatternCount - 1;
+  return s_preview[i];
+}
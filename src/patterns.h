@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+
+// Pattern-Registry: Name, Generator und eine beim Start einmal gerasterte Vorschau.
+// Ohne Katalog vom Gerät ist der Index zugleich die ID für setPattern (pattern_catalog.h).
+
+// Generator: t in [0..1) → normierte Position 0..1 (ein Vorschau-Zyklus)
+typedef float (*PatternGen)(float t);
+
+struct PatternDesc {
+  const char* name;
+  PatternGen  gen;
+};
+
+// Vorschau-Bitmap (1 bpp, MSB zuerst, Zeilen auf Bytes aufgerundet)
+constexpr int kPreviewW      = 81;
+constexpr int kPreviewH      = 19;
+constexpr int kPreviewStride = (kPreviewW + 7) / 8;
+
+void               patternsInit();          // rastert die Vorschauen (einmalig)
+int                patternCount();
+const PatternDesc& patternAt(int i);
+const char*        patternName(int i);
+const uint8_t*     patternPreview(int i);   // kPreviewH * kPreviewStride Bytes
@@ -0,0 +1,122 @@
+#include "perf.h"
+
+#if PERF_ENABLE
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+
+// log2-Histogramm in µs: Bucket k = [2^k, 2^(k+1)), Bucket 0 = [0, 2)
+static const int kBuckets = 21;   // bis ~2 s
+
+struct Hist {
+  uint32_t bucket[kBuckets];
+  uint32_t n, maxUs;
+  uint64_t sumUs;
+};
+
+static Hist s_hist[(int)PerfStage::Count];
+static uint32_t s_frameCycles[(int)PerfStage::Count];
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;   // Record kommt auch aus dem BLE-Pfad
+
+static uint32_t s_inputOriginUs = 0;
+static uint32_t s_lastLoopUs    = 0;
+static uint32_t s_lastReportMs  = 0;
+static uint32_t s_overlayVer    = 0;
+static char     s_overlay[48]   = "";
+
+static const char* const kNames[(int)PerfStage::Count] = {
+  "in->enq", "enq->wire", "render", " arcs", " text", "push", "loop"
+};
+
+uint32_t perfCyclesToUs(uint32_t cycles) {
+  const uint32_t mhz = getCpuFrequencyMhz();
+  return mhz ? cycles / mhz : cycles;
+}
+
+static int bucketOf(uint32_t us) {
+  int k = 0;
+  while (us > 1 && k < kBuckets - 1) { us >>= 1; ++k; }
+  return k;
+}
+
+// obere Grenze des Buckets, in dem das q-Quantil liegt
+static uint32_t quantileUs(const Hist& h, float q) {
+  if (!h.n) return 0;
+  const uint32_t target = (uint32_t)(q * (float)h.n + 0.5f);
+  uint32_t acc = 0;
+  for (int k = 0; k < kBuckets; ++k) {
+    acc += h.bucket[k];
+    if (acc >= target) return (2u << k) - 1;
+  }
+  return h.maxUs;
+}
+
+void perfRecord(PerfStage s, uint32_t us) {
+  Hist& h = s_hist[(int)s];
+  portENTER_CRITICAL(&s_mux);
+  h.bucket[bucketOf(us)]++;
+  h.n++;
+  h.sumUs += us;
+  if (us > h.maxUs) h.maxUs = us;
+  portEXIT_CRITICAL(&s_mux);
+}
+
+void perfAccum(PerfStage s, uint32_t cycles) { s_frameCycles[(int)s] += cycles; }
+
+void perfFlushFrame() {
+  for (int i = 0; i < (int)PerfStage::Count; ++i) {
+    if (!s_frameCycles[i]) continue;
+    perfRecord((PerfStage)i, perfCyclesToUs(s_frameCycles[i]));
+    s_frameCycles[i] = 0;
+  }
+}
+
+void perfInputOrigin(uint32_t tUs) { if (!s_inputOriginUs) s_inputOriginUs = tUs ? tUs : 1; }
+void perfInputEnqueued() {
+  if (!s_inputOriginUs) return;
+  perfRecord(PerfStage::InputToEnqueue, micros() - s_inputOriginUs);
+  s_inputOriginUs = 0;
+}
+void perfInputDone() { s_inputOriginUs = 0; }
+
+static void report(uint32_t nowMs) {
+  Hist snap[(int)PerfStage::Count];
+  portENTER_CRITICAL(&s_mux);
+  memcpy(snap, s_hist, sizeof(snap));
+  memset(s_hist, 0, sizeof(s_hist));
+  portEXIT_CRITICAL(&s_mux);
+
+  Serial.printf("[PERF] %lu ms window\n", (unsigned long)(nowMs - s_lastReportMs));
+  Serial.println("[PERF] stage          n   avg_us   p50<=   p99<=   max_us");
+  for (int i = 0; i < (int)PerfStage::Count; ++i) {
+    const Hist& h = snap[i];
+    if (!h.n) continue;
+    Serial.printf("[PERF] %-10s %6lu %8lu %7lu %7lu %8lu\n", kNames[i], (unsigned long)h.n,
+                  (unsigned long)(h.sumUs / h.n), (unsigned long)quantileUs(h, 0.5f),
+                  (unsigned long)quantileUs(h, 0.99f), (unsigned long)h.maxUs);
+  }
+
+  const Hist& lp = snap[(int)PerfStage::LoopPeriod];
+  const Hist& rd = snap[(int)PerfStage::Render];
+  const Hist& ps = snap[(int)PerfStage::Push];
+  snprintf(s_overlay, sizeof(s_overlay), "L%lu R%lu P%lu us",
+           (unsigned long)(lp.n ? lp.sumUs / lp.n : 0), (unsigned long)(rd.n ? rd.sumUs / rd.n : 0),
+           (unsigned long)(ps.n ? ps.sumUs / ps.n : 0));
+  s_overlayVer++;
+}
+
+void perfLoopTick() {
+  const uint32_t now = micros();
+  if (s_lastLoopUs) perfRecord(PerfStage::LoopPeriod, now - s_lastLoopUs);
+  s_lastLoopUs = now;
+
+  const uint32_t ms = millis();
+  if (ms - s_lastReportMs >= PERF_REPORT_MS) {
+    report(ms);
+    s_lastReportMs = ms;
+  }
+}
+
+uint32_t perfOverlayVersion() { return s_overlayVer; }
+void perfOverlayText(char* buf, size_t n) { snprintf(buf, n, "%s", s_overlay); }
+
+#endif  // PERF_ENABLE
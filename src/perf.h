@@ -0,0 +1,66 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// Latenz-Instrumentierung auf Basis des CPU-Zykluszählers.
+// Mit PERF_ENABLE=0 (Default) wird alles zu leeren Inlines → kein Overhead.
+//   -D PERF_ENABLE=1          Histogramme + Serial-Zusammenfassung alle PERF_REPORT_MS
+//   -D PERF_OVERLAY=1         zusätzlich Kurzzeile oben auf dem Display
+#ifndef PERF_ENABLE
+#define PERF_ENABLE 0
+#endif
+#ifndef PERF_OVERLAY
+#define PERF_OVERLAY 0
+#endif
+#ifndef PERF_REPORT_MS
+#define PERF_REPORT_MS 5000
+#endif
+
+enum class PerfStage : uint8_t {
+  InputToEnqueue,   // Encoder-/Touch-Abtastung → bleSend*-Slot
+  EnqueueToWire,    // Slot → writeValue
+  Render,           // drawUI: Zeichnen in den Backbuffer
+  Arcs,             //   davon Ringe
+  Text,             //   davon Text
+  Push,             // drawUI: Push + Warten auf DMA
+  LoopPeriod,       // Abstand zweier loop()-Durchläufe
+  Count
+};
+
+#if PERF_ENABLE
+#include <Arduino.h>
+
+inline uint32_t perfCycles() { return ESP.getCycleCount(); }
+uint32_t perfCyclesToUs(uint32_t cycles);
+
+void perfRecord(PerfStage s, uint32_t us);       // ein Messwert in das Histogramm
+void perfAccum(PerfStage s, uint32_t cycles);    // Teilzeit innerhalb eines Frames aufsummieren
+void perfFlushFrame();                           // aufsummierte Frame-Teilzeiten als je 1 Wert
+void perfInputOrigin(uint32_t tUs);              // Abtastzeit des ersten noch nicht gesendeten Inputs
+void perfInputEnqueued();                        // bleSend* hat einen Slot befüllt
+void perfInputDone();                            // Ende inputUpdate: offenen Ursprung verwerfen
+void perfLoopTick();                             // einmal pro loop()
+uint32_t perfOverlayVersion();                   // ändert sich mit jeder Zusammenfassung
+void perfOverlayText(char* buf, size_t n);
+
+// misst den umschließenden Block und summiert ihn auf die Stage des laufenden Frames
+struct PerfScope {
+  PerfStage st; uint32_t c0;
+  explicit PerfScope(PerfStage s) : st(s), c0(perfCycles()) {}
+  ~PerfScope() { perfAccum(st, perfCycles() - c0); }
+};
+#define PERF_CAT2(a, b) a##b
+#define PERF_CAT(a, b) PERF_CAT2(a, b)
+#define PERF_SCOPE(stage) PerfScope PERF_CAT(_perf_, __LINE__)(stage)
+
+#else
+inline void perfRecord(PerfStage, uint32_t) {}
+inline void perfFlushFrame() {}
+inline void perfInputOrigin(uint32_t) {}
+inline void perfInputEnqueued() {}
+inline void perfInputDone() {}
+inline void perfLoopTick() {}
+inline uint32_t perfOverlayVersion() { return 0; }
+inline void perfOverlayText(char* buf, size_t n) { if (n) buf[0] = '\0'; }
+#define PERF_SCOPE(stage) do {} while (0)
+#endif
@@ -0,0 +1,148 @@
+#include "polar_lut.h"
+#include "geometry.h"
+
+namespace polar {
+namespace {
+
+constexpr int32_t U = kUnitsPerDeg;
+
+// ---------- Regionen ----------
+// dx ≥ 0 (gespiegelt); Minus/Plus teilen sich einen Eintrag, das Vorzeichen von dx entscheidet.
+// Die Kreise überlappen Play: links gewinnt Minus (wird zuerst geprüft), rechts Play.
+enum : uint8_t { kNone, kSide, kSidePlay, kPlay, kPill, kSens, kRange };
+
+constexpr int kCols = W - CX + 1;            // dx = 0..120 (x = 0 spiegelt auf dx = 120)
+constexpr int kRowBytes = (kCols + 1) / 2;
+
+constexpr bool inRing(int dx, int dy, int rIn, int rOut) {
+  const int r2 = dx * dx + dy * dy;
+  return r2 >= rIn * rIn && r2 <= rOut * rOut;
+}
+
+// Reihenfolge wie in onTap: Buttons, Pill, Sens-Bogen, Range-Halbring
+constexpr uint8_t regionOf(int dx, int dy) {
+  const int by = dy - (BUTTONS_Y - CY);
+  if (by >= -24 && by <= 24) {
+    const int sx = dx - CTRL_SPACING;
+    const bool side = sx * sx + by * by <= 18 * 18;
+    const bool play = dx * dx + by * by <= 24 * 24;
+    if (side) return play ? kSidePlay : kSide;
+    if (play) return kPlay;
+  }
+  if (dx <= 60 && dy >= CTRL_Y - 12 - CY && dy <= CTRL_Y + 12 - CY) return kPill;
+  // Bogen 15°..165°: dy/|dx| ≥ tan 15° = 2 − √3, ganzzahlig ohne Wurzel
+  if (inRing(dx, dy, R_SENS_IN, R_SENS_OUT) && dy > 0) {
+    const int d = 2 * dx - dy;
+    if (d <= 0 || 3 * dx * dx >= d * d) return kSens;
+  }
+  if (inRing(dx, dy, R_RANGE_IN, R_RANGE_OUT) && dy <= 0) return kRange;
+  return kNone;
+}
+
+struct RegionTable { uint8_t v[H][kRowBytes] = {}; };
+
+constexpr RegionTable buildRegions() {
+  RegionTable t;
+  for (int y = 0; y < H; ++y)
+    for (int dx = 0; dx < kCols; ++dx)
+      t.v[y][dx >> 1] |= (uint8_t)(regionOf(dx, y - CY) << ((dx & 1) * 4));
+  return t;
+}
+
+constexpr RegionTable kRegions = buildRegions();
+
+// ---------- atan-Tabelle ----------
+// atan(i/kAtanN) für i = 0..kAtanN in Einheiten; Reihe nach Euler (konvergiert für x ≤ 1 schnell)
+constexpr int kAtanN = 1024;
+constexpr int kAtanBits = 10;
+
+constexpr double atanEuler(double x) {
+  const double q = x * x / (1.0 + x * x);
+  double term = x / (1.0 + x * x), sum = 0.0;
+  for (int n = 1; n < 60; ++n) {
+    sum += term;
+    term *= q * (2.0 * n) / (2.0 * n + 1.0);
+  }
+  return sum;
+}
+
+struct AtanTable { int32_t v[kAtanN + 1] = {}; };
+
+constexpr AtanTable buildAtan() {
+  AtanTable t;
+  const double k = 180.0 / 3.14159265358979323846 * U;
+  for (int i = 0; i <= kAtanN; ++i) t.v[i] = (int32_t)(atanEuler((double)i / kAtanN) * k + 0.5);
+  return t;
+}
+
+constexpr AtanTable kAtan = buildAtan();
+
+// (-180°, 180°] wie wrap180
+inline int32_t wrap(int32_t a) {
+  if (a > 180 * U) a -= 360 * U;
+  else if (a <= -180 * U) a += 360 * U;
+  return a;
+}
+
+inline int32_t clamp(int32_t v, int32_t lo, int32_t hi) { return v < lo ? lo : (v > hi ? hi : v); }
+
+}  // namespace
+
+Region regionAt(int x, int y) {
+  if ((unsigned)x >= (unsigned)W || (unsigned)y >= (unsigned)H) return Region::None;
+  const int dx = x - CX;
+  const int ax = dx < 0 ? -dx : dx;
+  const uint8_t r = (kRegions.v[y][ax >> 1] >> ((ax & 1) * 4)) & 0x0F;
+  switch (r) {
+    case kSide:     return dx < 0 ? Region::Minus : Region::Plus;
+    case kSidePlay: return dx < 0 ? Region::Minus : Region::Play;
+    case kPlay:     return Region::Play;
+    case kPill:     return Region::Pill;
+    case kSens:     return Region::SensBand;
+    case kRange:    return Region::RangeBand;
+    default:        return Region::None;
+  }
+}
+
+int32_t rawAngle(int x, int y) {
+  const int dx = x - CX, dy = y - CY;
+  const uint32_t ax = dx < 0 ? -dx : dx, ay = dy < 0 ? -dy : dy;
+  if (ax == 0 && ay == 0) return 0;
+  // erster Oktant: Verhältnis klein/groß ∈ [0,1] als 20-bit-Festkomma
+  const bool steep = ay > ax;
+  const uint32_t q = ((steep ? ax : ay) << 20) / (steep ? ay : ax);
+  const uint32_t i = q >> kAtanBits, f = q & (kAtanN - 1);
+  int32_t a = kAtan.v[i];
+  if (f) a += (int32_t)(((int64_t)(kAtan.v[i + 1] - a) * f) >> kAtanBits);
+  if (steep) a = 90 * U - a;
+  if (dx < 0) a = 180 * U - a;
+  if (dy < 0) a = 360 * U - a;
+  return a == 360 * U ? 0 : a;
+}
+
+int32_t relTop(int x, int y)    { return wrap(rawAngle(x, y) - 270 * U); }
+int32_t relBottom(int x, int y) { return wrap(rawAngle(x, y) - 90 * U); }
+
+// round(t·100) mit t = (a+90°)/180°: Schritt 1,8°, Grenzen auf halben Schritten
+int topValue(int x, int y) {
+  const int32_t a = clamp(relTop(x, y), -90 * U, 90 * U) + 90 * U;
+  return (int)((a + 9 * U / 10) / (18 * U / 10));
+}
+
+int posValue(int x, int y) {
+  const int32_t a = clamp(relBottom(x, y), -75 * U, 75 * U) + 75 * U;
+  return (int)((a + 3 * U / 4) / (3 * U / 2));
+}
+
+// round(100 − 200·t): Schritt 0,75°, Halbwerte weg von 0 wie roundf
+int sensValue(int x, int y) {
+  const int32_t a = clamp(relBottom(x, y), -75 * U, 75 * U);   // 0 = Mitte
+  const int32_t step = 3 * U / 4;
+  const int32_t m = a < 0 ? -a : a;
+  const int v = (int)((m + step / 2) / step);
+  return a < 0 ? v : -v;
+}
+
+int32_t topAngleOfValue(int v) { return -90 * U + v * (18 * U / 10); }
+
+}  // namespace polar
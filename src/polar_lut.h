@@ -0,0 +1,35 @@
+#pragma once
+// Touch → Bedienelement und Reglerwert ohne atan2f/Wurzeln pro Abtastung.
+// Regionen: 4-bit-Tabelle über die halbe Bildschirmbreite (links/rechts gespiegelt),
+// zur Compile-Zeit aus denselben Ganzzahl-Tests erzeugt wie früher (liegt im Flash).
+// Winkel: Oktant-Reduktion + atan-Tabelle mit linearer Interpolation, Festkomma mit
+// kUnitsPerDeg – so fein, dass die Rundungsgrenzen der Regler (1,8° / 1,5° / 0,75°)
+// ganzzahlig liegen und die Werte exakt wie mit relTopDeg/relBottomDeg herauskommen.
+#include <stdint.h>
+
+namespace polar {
+
+static constexpr int32_t kUnitsPerDeg = 40 * 4096;   // 0,9° · 0,75° · 0,375° ganzzahlig
+
+enum class Region : uint8_t {
+  None,
+  Minus,       // − (links neben Play)
+  Play,
+  Plus,        // + (rechts)
+  Pill,        // Pattern-Pill unten
+  SensBand,    // Sens/Pos-Bogen unten (±75°)
+  RangeBand,   // Stroke/Depth-Halbring oben
+};
+
+Region  regionAt(int x, int y);      // außerhalb des Bildschirms: None
+int32_t rawAngle(int x, int y);      // [0°, 360°) in Einheiten, 0° = rechts, 90° = unten
+int32_t relTop(int x, int y);        // wie relTopDeg, (-180°, 180°]
+int32_t relBottom(int x, int y);     // wie relBottomDeg
+
+// Reglerwerte wie in onTap/onDrag (Winkel geklemmt, gerundet)
+int topValue(int x, int y);          // Stroke/Depth 0..100
+int posValue(int x, int y);          // Position 0..100 (links → rechts)
+int sensValue(int x, int y);         // Sensation +100 (links) .. −100 (rechts)
+int32_t topAngleOfValue(int v);      // Griffwinkel (relTop) eines Stroke/Depth-Werts
+
+}  // namespace polar
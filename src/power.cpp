@@ -0,0 +1,138 @@
+#include "power.h"
+#include <M5Dial.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <algorithm>
+#include "app_state.h"
+#include "input.h"
+#include "pattern_play.h"
+
+#if defined(__has_include)
+#if __has_include(<esp_pm.h>)
+#include <esp_pm.h>
+#define POWER_HAS_PM 1
+#endif
+#endif
+#ifndef POWER_HAS_PM
+#define POWER_HAS_PM 0
+#endif
+
+// -------------------- Zustandsmaschine --------------------
+PowerManager::PowerManager(const PowerConfig& cfg, const PowerHooks& hooks, uint32_t (*clock)())
+  : _cfg(cfg), _hooks(hooks), _clock(clock) {}
+
+void PowerManager::begin() {
+  const uint32_t now = _clock();
+  _lastActivityMs = now;
+  _accountedMs = now;
+  _level = PowerLevel::Count;   // erzwingt das Anwenden
+  enter(PowerLevel::Active, now);
+  _stats.transitions = 0;
+}
+
+void PowerManager::account(uint32_t now) {
+  _stats.msIn[(int)_level] += now - _accountedMs;
+  _accountedMs = now;
+}
+
+void PowerManager::enter(PowerLevel l, uint32_t now) {
+  if (l == _level) return;
+  if (_level != PowerLevel::Count) { account(now); _stats.transitions++; }
+  _level = l;
+  _stats.level = l;
+  const PowerLevelCfg& c = _cfg.level[(int)l];
+  if (_hooks.cpu)        _hooks.cpu(c.cpuMhz, l != PowerLevel::Active);
+  if (_hooks.brightness) _hooks.brightness(c.brightness);
+  if (_hooks.samplerMs)  _hooks.samplerMs(c.samplerMs);
+}
+
+void PowerManager::activity() {
+  const uint32_t now = _clock();
+  _lastActivityMs = now;
+  enter(PowerLevel::Active, now);
+}
+
+void PowerManager::tick() {
+  const uint32_t now = _clock();
+  const uint32_t idle = now - _lastActivityMs;
+  PowerLevel want = PowerLevel::Active;
+  if (idle >= _cfg.deepAfterMs)     want = PowerLevel::DeepIdle;
+  else if (idle >= _cfg.dimAfterMs) want = PowerLevel::Dimmed;
+  if (want > _level) enter(want, now);   // nach oben geht es nur über activity()
+}
+
+uint32_t PowerManager::waitMs() const { return _cfg.level[(int)_level].waitMs; }
+
+PowerStats PowerManager::stats() {
+  account(_clock());
+  return _stats;
+}
+
+// -------------------- Gerät --------------------
+static bool         s_pmOk = false;       // esp_pm aktiv → Takt/Light Sleep über PM-Konfiguration
+static TaskHandle_t s_loopTask = nullptr;
+
+static void hwCpu(uint32_t mhz, bool lightSleep) {
+#if POWER_HAS_PM
+  if (s_pmOk) {
+    // max = Stufe, min = 80 MHz (BLE); Light Sleep nur außerhalb von Active
+    esp_pm_config_esp32s3_t pm = { (int)mhz, lightSleep ? 80 : (int)mhz, lightSleep };
+    if (esp_pm_configure(&pm) == ESP_OK) return;
+  }
+#endif
+  (void)lightSleep;
+  setCpuFrequencyMhz(mhz);
+}
+
+static void hwBrightness(uint8_t b) { M5Dial.Display.setBrightness(b); }
+static void hwSampler(uint32_t ms)  { inputSetSamplerPeriod(ms); }
+static uint32_t hwClock()           { return millis(); }
+
+// Active = Helligkeit beim Start, die übrigen Stufen relativ dazu
+static PowerConfig deviceConfig() {
+  PowerConfig c;
+  const uint8_t b = M5Dial.Display.getBrightness();
+  if (b) {
+    c.level[(int)PowerLevel::Active].brightness = b;
+    c.level[(int)PowerLevel::Dimmed].brightness = (uint8_t)std::max(b / 4, 16);
+  }
+  return c;
+}
+
+static PowerManager& manager() {
+  static PowerManager pm(deviceConfig(), PowerHooks{ hwCpu, hwBrightness, hwSampler }, hwClock);
+  return pm;
+}
+
+void powerInit() {
+  s_loopTask = xTaskGetCurrentTaskHandle();
+#if POWER_HAS_PM
+  esp_pm_config_esp32s3_t pm = { 240, 240, false };
+  s_pmOk = esp_pm_configure(&pm) == ESP_OK;
+#endif
+  manager().begin();
+  Serial.printf("[PWR] dim after %u s, deep idle after %u s, light sleep %s\n",
+                (unsigned)(POWER_DIM_MS / 1000), (unsigned)(POWER_DEEP_MS / 1000),
+                s_pmOk ? "via esp_pm" : "unavailable (frequency only)");
+}
+
+void powerTick()     { manager().tick(); }
+void powerActivity() { manager().activity(); }
+
+void powerIdleWait() {
+  uint32_t wait = manager().waitMs();
+  if (!wait) return;
+  // ein anstehender Frame verkürzt die Pause
+  if (needsRedraw) {
+    const int32_t due = (int32_t)(s_uiNextMs - millis());
+    wait = due <= 0 ? 0 : std::min<uint32_t>(wait, (uint32_t)due);
+  }
+  // lokale Wiedergabe: das nächste move-Segment muss pünktlich raus (pattern_play.h)
+  const int32_t play = playDueInMs();
+  if (play >= 0) wait = std::min<uint32_t>(wait, (uint32_t)play);
+  if (wait) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+}
+
+void powerWakeFromSampler() { if (s_loopTask) xTaskNotifyGive(s_loopTask); }
+
+PowerStats powerStats() { return manager().stats(); }
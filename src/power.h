@@ -0,0 +1,83 @@
+#pragma once
+#include <stdint.h>
+
+// Energiestufen nach Ruhezeit seit der letzten Bedienung (Encoder, BtnA, Touch):
+//   Active    volle Taktfrequenz, Helligkeit wie beim Start, Sampler 8 ms, loop() ohne Pause
+//   Dimmed    ab POWER_DIM_MS:  160 MHz, Helligkeit/4, Sampler 16 ms, loop() wartet bis 10 ms
+//   DeepIdle  ab POWER_DEEP_MS:  80 MHz (Minimum für BLE), Backlight fast aus, Sampler 40 ms,
+//             loop() wartet bis 40 ms – mit aktivem esp_pm schläft die CPU dabei leicht
+//             (Light Sleep zwischen den Verbindungsereignissen, NimBLE hält den Link).
+// Jede Bedienung schaltet sofort auf Active; der Sampler weckt die Warte-Pause per Notify.
+//
+// PowerManager ist die reine Zustandsmaschine: Zeit kommt von einer Uhr-Funktion, Wirkung
+// über Hooks – so lassen sich Übergänge und Tastverhältnis auf dem Host durchspielen
+// (sim_bench.cpp). powerInit()/powerTick()/… verdrahten sie mit millis() und der Hardware.
+#ifndef POWER_DIM_MS
+#define POWER_DIM_MS 30000
+#endif
+#ifndef POWER_DEEP_MS
+#define POWER_DEEP_MS 120000
+#endif
+
+enum class PowerLevel : uint8_t { Active, Dimmed, DeepIdle, Count };
+
+struct PowerLevelCfg {
+  uint16_t cpuMhz;
+  uint8_t  brightness;
+  uint8_t  samplerMs;   // Abtastperiode Encoder/Touch/BtnA
+  uint8_t  waitMs;      // längste Pause pro loop()
+};
+
+struct PowerConfig {
+  uint32_t dimAfterMs  = POWER_DIM_MS;
+  uint32_t deepAfterMs = POWER_DEEP_MS;
+  PowerLevelCfg level[(int)PowerLevel::Count] = {
+    { 240, 255,  8,  0 },
+    { 160,  64, 16, 10 },
+    {  80,   8, 40, 40 },
+  };
+};
+
+struct PowerHooks {
+  void (*cpu)(uint32_t mhz, bool lightSleep);
+  void (*brightness)(uint8_t b);
+  void (*samplerMs)(uint32_t ms);
+};
+
+struct PowerStats {
+  PowerLevel level;
+  uint32_t   transitions;
+  uint32_t   msIn[(int)PowerLevel::Count];   // Verweildauer je Stufe seit Start
+};
+
+class PowerManager {
+ public:
+  PowerManager(const PowerConfig& cfg, const PowerHooks& hooks, uint32_t (*clock)());
+
+  void begin();                    // Active anwenden, Zeitbasis setzen
+  void activity();                 // Bedienung: sofort Active
+  void tick();                     // Ruhezeit prüfen, ggf. eine Stufe tiefer
+  uint32_t waitMs() const;         // erlaubte Pause dieser loop()-Runde
+  PowerLevel level() const { return _level; }
+  PowerStats stats();
+
+ private:
+  void enter(PowerLevel l, uint32_t now);
+  void account(uint32_t now);
+
+  PowerConfig _cfg;
+  PowerHooks  _hooks;
+  uint32_t  (*_clock)();
+  PowerLevel  _level = PowerLevel::Active;
+  uint32_t    _lastActivityMs = 0;
+  uint32_t    _accountedMs = 0;
+  PowerStats  _stats = {};
+};
+
+// Gerät: einmal in setup() nach Display/BLE, dann pro loop()
+void powerInit();
+void powerTick();                  // Stufe nachführen
+void powerActivity();              // aus inputUpdate bei Ereignissen
+void powerIdleWait();              // Pause am Ende von loop(), weckt bei Eingabe sofort
+void powerWakeFromSampler();       // Sampler-Task: neues Ereignis im Ring
+PowerStats powerStats();
@@ -0,0 +1,151 @@
+#include "raster.h"
+#include <math.h>
+#include <algorithm>
+#include "palette.h"
+
+// Statt Dreiecksfächer (2 fillTriangle + 8× sin/cos pro 3°-Schritt) pro Bogen nur
+// 2× sin/cos für die Kantenvektoren; pro Zeile ein paar sqrtf für die Spannweiten,
+// pro Pixel nur an den Kanten (≤ 1 px) eine echte Abstandsrechnung.
+
+namespace {
+
+inline uint16_t to565(uint32_t c) {
+  return (uint16_t)(((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+}
+inline uint16_t swap16(uint16_t v) { return (uint16_t)((v << 8) | (v >> 8)); }
+
+// RGB565-Blend, alpha 0..255 (R/B gemeinsam, G getrennt)
+inline uint16_t blend565(uint16_t fg, uint16_t bg, uint32_t alpha) {
+  uint32_t rb = bg & 0xF81F;
+  rb += ((fg & 0xF81F) - rb) * (alpha >> 2) >> 6;
+  uint32_t g = bg & 0x07E0;
+  g += ((fg & 0x07E0) - g) * alpha >> 8;
+  return (uint16_t)((rb & 0xF81F) | (g & 0x07E0));
+}
+
+inline float cov01(float v) { return v <= 0.0f ? 0.0f : (v >= 1.0f ? 1.0f : v); }
+
+// Schreibt einen Pixel mit Deckung cov; 16 bpp direkt in den Puffer, 8 bpp (UI-Palette)
+// über die Mischfarben der Palette, sonst über LGFX (ohne AA)
+struct Target {
+  LGFX_Sprite& d;
+  uint16_t* buf;
+  uint8_t* idx;
+  int stride;
+  uint16_t col565, colSw;
+  uint32_t col888;
+
+  inline void put(int x, int y, float cov) {
+    if (buf) {
+      uint16_t& px = buf[y * stride + x];
+      if (cov >= 0.998f)     px = colSw;
+      else if (cov > 0.002f) px = swap16(blend565(col565, swap16(px), (uint32_t)(cov * 255.0f + 0.5f)));
+    } else if (idx) {
+      uint8_t& px = idx[y * stride + x];
+      if (cov >= 0.998f)     px = (uint8_t)col888;
+      else if (cov > 0.002f) px = palBlend((uint8_t)col888, px, (uint32_t)(cov * 255.0f + 0.5f));
+    } else if (cov >= 0.5f) {
+      d.drawPixel(x, y, col888);
+    }
+  }
+};
+
+}  // namespace
+
+void rasterArcBand(LGFX_Sprite& d, int cx, int cy, int r_in, int r_out, float a0, float a1, uint32_t col) {
+  if (a1 < a0) std::swap(a0, a1);
+  if (r_out < r_in) std::swap(r_in, r_out);
+  const float span = a1 - a0;
+  if (span <= 0.0f) return;
+
+  int32_t clx, cly, clw, clh;
+  d.getClipRect(&clx, &cly, &clw, &clh);
+  if (clw <= 0 || clh <= 0) return;
+
+  Target t{ d, nullptr, nullptr, (int)d.width(), to565(col), 0, col };
+  t.colSw = swap16(t.col565);
+  if (d.getColorDepth() == 16) t.buf = (uint16_t*)d.getBuffer();
+  else if (UI_PALETTE_8BIT && d.getColorDepth() == 8) t.idx = (uint8_t*)d.getBuffer();
+
+  // Winkelbereich: ≤180° = konvexer Keil (pro Zeile ein x-Intervall),
+  // >180° = Komplement eines Keils, ≥360° = voller Ring
+  const bool full = span >= 360.0f;
+  const bool wide = !full && span > 180.0f;
+  float e0 = a0, e1 = a1;
+  if (wide) { e0 = a1; e1 = a0 + 360.0f; }   // Komplement-Keil
+  const float r0 = e0 * (float)M_PI / 180.0f, r1 = e1 * (float)M_PI / 180.0f;
+  const float u0x = cosf(r0), u0y = sinf(r0);
+  const float u1x = cosf(r1), u1y = sinf(r1);
+
+  const float ro = (float)r_out, ri = (float)r_in;
+  const float roA = ro + 0.5f, roS = ro - 0.5f;   // äußere Kante: >0 / volle Deckung
+  const float riA = ri - 0.5f, riS = ri + 0.5f;   // innere Kante
+
+  // Zeilenbereich: Bounding-Box des Sektors (Endpunkte + Achsen-Extrema)
+  float ymin = -roA, ymax = roA;
+  if (!full && !wide) {
+    ymin = std::min(std::min(ri * u0y, ro * u0y), std::min(ri * u1y, ro * u1y));
+    ymax = std::max(std::max(ri * u0y, ro * u0y), std::max(ri * u1y, ro * u1y));
+    for (float q = ceilf(a0 / 90.0f) * 90.0f; q < a1; q += 90.0f) {
+      const int k = ((int)lroundf(q / 90.0f) % 4 + 4) % 4;
+      if (k == 1) ymax = ro;          // 90° = unten
+      else if (k == 3) ymin = -ro;    // 270° = oben
+    }
+    ymin -= 1.0f; ymax += 1.0f;
+  }
+  const int yBeg = std::max((int)cly, cy + (int)floorf(ymin));
+  const int yEnd = std::min((int)(cly + clh - 1), cy + (int)ceilf(ymax));
+  const int xClipL = clx, xClipR = clx + clw - 1;
+
+  for (int y = yBeg; y <= yEnd; ++y) {
+    const float dy = (float)(y - cy);
+    const float dy2 = dy * dy;
+    if (dy2 >= roA * roA) continue;
+    const float xo  = sqrtf(roA * roA - dy2);
+    const float xoS = dy2 < roS * roS ? sqrtf(roS * roS - dy2) : -1.0f;
+    const float xi  = dy2 < riA * riA ? sqrtf(riA * riA - dy2) : -1.0f;
+    const float xiS = dy2 < riS * riS ? sqrtf(riS * riS - dy2) : -1.0f;
+
+    // Keil-Intervall aus den beiden Halbebenen (mit 0,5 px AA-Saum)
+    float L = -xo, R = xo;
+    if (!full && !wide) {
+      // cross(u0,p) > -0.5  ⇔  u0y*dx < 0.5 + u0x*dy
+      const float b0 = 0.5f + u0x * dy;
+      if (u0y > 1e-6f)       R = std::min(R, b0 / u0y);
+      else if (u0y < -1e-6f) L = std::max(L, b0 / u0y);
+      else if (b0 <= 0.0f)   continue;
+      // cross(p,u1) > -0.5  ⇔  u1y*dx > u1x*dy - 0.5
+      const float b1 = u1x * dy - 0.5f;
+      if (u1y > 1e-6f)       L = std::max(L, b1 / u1y);
+      else if (u1y < -1e-6f) R = std::min(R, b1 / u1y);
+      else if (b1 >= 0.0f)   continue;
+      if (L > R) continue;
+    }
+
+    // radial: links [-xo,-xi], rechts [xi,xo] (ohne Loch: ein Bereich)
+    float spans[2][2] = { { -xo, xi < 0.0f ? xo : -xi }, { xi, xo } };
+    const int nSpans = xi < 0.0f ? 1 : 2;
+    for (int s = 0; s < nSpans; ++s) {
+      const float sl = std::max(spans[s][0], L), sr = std::min(spans[s][1], R);
+      if (sl > sr) continue;
+      const int xBeg = std::max(xClipL, cx + (int)ceilf(sl));
+      const int xEnd = std::min(xClipR, cx + (int)floorf(sr));
+      for (int x = xBeg; x <= xEnd; ++x) {
+        const float dx = (float)(x - cx);
+        const float adx = fabsf(dx);
+        float cov = 1.0f;
+        if (adx > xoS || adx < xiS) {
+          const float r = sqrtf(dx * dx + dy2);
+          cov = cov01(roA - r) * cov01(r - riA);
+        }
+        if (!full) {
+          const float c0 = cov01(u0x * dy - u0y * dx + 0.5f);
+          const float c1 = cov01(dx * u1y - dy * u1x + 0.5f);
+          const float inWedge = std::min(c0, c1);
+          cov *= wide ? 1.0f - inWedge : inWedge;
+        }
+        if (cov > 0.0f) t.put(x, y, cov);
+      }
+    }
+  }
+}
@@ -0,0 +1,9 @@
+#pragma once
+#include <M5Dial.h>
+#include <stdint.h>
+
+// Ringsektor [a0..a1] (Grad, 0° = rechts, 90° = unten) zwischen r_in und r_out,
+// zeilenweise direkt in den Sprite-Puffer gerastert, mit geglätteten Kanten.
+// Respektiert das Clip-Rect des Sprites. col wie bei LGFX: uint32_t = RGB888,
+// auf dem 8-bit-Backbuffer (UI_PALETTE_8BIT) der Paletten-Index.
+void rasterArcBand(LGFX_Sprite& d, int cx, int cy, int r_in, int r_out, float a0, float a1, uint32_t col);
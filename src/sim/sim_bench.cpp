@@ -0,0 +1,557 @@
+// Mikro-Benchmarks für [env:native]: neue Pfade gegen die ursprünglichen Varianten.
+// check() zählt verletzte Prüfungen; sie machen den Lauf fehlschlagen (Exit-Code 1).
+#if defined(NATIVE_SIM)
+#include <M5Dial.h>
+#include <NimBLEDevice.h>
+#include <sim_hal.h>
+#include <math.h>
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "../app_state.h"
+#include "../bglayer.h"
+#include "../ble_adv.h"
+#include "../ble_cmd.h"
+#include "../device_state.h"
+#include "../motion.h"
+#include "../polar_lut.h"
+#include "../power.h"
+#include "../geometry.h"
+#include "../glyphs.h"
+#include "../palette.h"
+#include "../pattern_play.h"
+#include "../patterns.h"
+#include "../raster.h"
+#include "../utils.h"
+
+namespace {
+
+volatile uint32_t s_sink = 0;
+int s_fails = 0;   // verletzte Prüfungen; simMicroBench() gibt sie zurück, main() endet dann mit 1
+
+// Prüfung: bei Verletzung FEHLER-Zeile und Zähler, Lauf läuft weiter
+bool check(bool ok, const char* what) {
+  if (!ok) { printf("  FEHLER: %s\n", what); ++s_fails; }
+  return ok;
+}
+
+struct BenchResult { double nsPerOp; double allocsPerOp; };
+
+template <typename F>
+BenchResult measure(uint32_t iters, F&& fn) {
+  const sim::AllocStats a0 = sim::allocStats();
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iters; ++i) fn(i);
+  const auto t1 = std::chrono::steady_clock::now();
+  const sim::AllocStats a1 = sim::allocStats();
+  return BenchResult{ std::chrono::duration<double, std::nano>(t1 - t0).count() / iters,
+                      (double)(a1.allocs - a0.allocs) / iters };
+}
+
+void report(const char* name, const BenchResult& r) {
+  printf("  %-28s %10.1f ns/op %8.2f alloc/op\n", name, r.nsPerOp, r.allocsPerOp);
+}
+
+// ---------- JSON: String-Verkettung (ursprünglicher bleSendMove) vs. blecmd ----------
+void benchJson() {
+  printf("[BENCH] move-Kommando kodieren\n");
+  const uint32_t N = 200000;
+  report("String-Verkettung", measure(N, [](uint32_t i) {
+    const int pos = (int)(i % 101), ms = 50 + (int)(i % 1951);
+    const bool replace = i & 1;
+    String s = String(F("[{\"action\":\"move\",\"position\":")) + pos +
+               F(",\"time\":") + ms +
+               F(",\"replace\":") + (replace ? F("true") : F("false")) + F("}]");
+    s_sink += s.length();
+  }));
+  report("blecmd::makeMove + frame", measure(N, [](uint32_t i) {
+    const int pos = (int)(i % 101), ms = 50 + (int)(i % 1951);
+    char wire[blecmd::kMaxWire];
+    s_sink += (uint32_t)blecmd::frame(wire, blecmd::makeMove(pos, ms, i & 1));
+  }));
+}
+
+// ---------- Ringe: Dreiecksfächer (ursprüngliches drawArcBandAA) vs. Scanline ----------
+void fanArcBand(LGFX_Sprite& d, int cx, int cy, int r_in, int r_out, float a0, float a1, uint32_t col) {
+  if (a1 < a0) std::swap(a0, a1);
+  int steps = std::max(12, (int)ceilf(fabs(a1 - a0) / 3.0f));
+  for (int i = 0; i < steps; i++) {
+    float t0 = lerp(a0, a1, (float)i / steps);
+    float t1 = lerp(a0, a1, (float)(i + 1) / steps);
+    float r0 = t0 * (float)M_PI / 180.0f;
+    float r1 = t1 * (float)M_PI / 180.0f;
+    int x0i = cx + (int)roundf(r_in * cosf(r0)),  y0i = cy + (int)roundf(r_in * sinf(r0));
+    int x0o = cx + (int)roundf(r_out * cosf(r0)), y0o = cy + (int)roundf(r_out * sinf(r0));
+    int x1o = cx + (int)roundf(r_out * cosf(r1)), y1o = cy + (int)roundf(r_out * sinf(r1));
+    int x1i = cx + (int)roundf(r_in * cosf(r1)),  y1i = cy + (int)roundf(r_in * sinf(r1));
+    d.fillTriangle(x0i, y0i, x0o, y0o, x1o, y1o, col);
+    d.fillTriangle(x0i, y0i, x1o, y1o, x1i, y1i, col);
+  }
+}
+
+void benchArcs() {
+  LGFX_Sprite spr;
+  spr.setColorDepth(16);
+  spr.createSprite(W, H);
+  const uint32_t col = LGFX_Sprite::color888(60, 140, 255);
+  const uint32_t N = 2000;
+
+  printf("[BENCH] Ringsegment zeichnen (Vollbild-Sprite 240x240, 16 bpp)\n");
+  struct Case { const char* name; int rin, rout; float a0, a1; };
+  const Case cases[] = {
+    { "Speed-Spur 180°",   R_SPEED_IN, R_SPEED_OUT, TOP_START,  TOP_END  },
+    { "Range-Band 90°",    R_RANGE_IN, R_RANGE_OUT, 225.0f,     315.0f   },
+    { "Sens-Band 150°",    R_SENS_IN,  R_SENS_OUT,  SENS_START, SENS_END },
+  };
+  for (const Case& c : cases) {
+    char name[64];
+    snprintf(name, sizeof name, "Fächer   %s", c.name);
+    report(name, measure(N, [&](uint32_t) { fanArcBand(spr, CX, CY, c.rin, c.rout, c.a0, c.a1, col); }));
+    snprintf(name, sizeof name, "Scanline %s", c.name);
+    report(name, measure(N, [&](uint32_t) { rasterArcBand(spr, CX, CY, c.rin, c.rout, c.a0, c.a1, col); }));
+  }
+  spr.deleteSprite();
+}
+
+
+// ---------- Scan-Callback: Name/UUID-Objekte (ursprünglich) vs. Rohbytes ----------
+void benchAdv() {
+  printf("[BENCH] Advertisement prüfen (fremdes Gerät / OSSM)\n");
+  NimBLEAdvertisedDevice other, ossm;
+  other.name = "Galaxy Buds";
+  other.uuids.push_back(NimBLEUUID("0000fd69-0000-1000-8000-00805f9b34fb"));
+  other.payload = { 0x02, 0x01, 0x06, 0x0c, 0x09, 'G', 'a', 'l', 'a', 'x', 'y', ' ', 'B', 'u', 'd', 's',
+                    0x03, 0x03, 0x69, 0xfd };
+  ossm.name = "OSSM";
+  ossm.uuids.push_back(NimBLEUUID("e5560000-6a2d-436f-a43d-82eab88dcefd"));
+  ossm.payload = { 0x02, 0x01, 0x06, 0x05, 0x09, 'O', 'S', 'S', 'M', 0x11, 0x07 };
+  ossm.payload.insert(ossm.payload.end(), bleadv::kSvcUuidLE, bleadv::kSvcUuidLE + 16);
+  const NimBLEAdvertisedDevice* devs[2] = { &other, &ossm };
+
+  const uint32_t N = 200000;
+  report("getName + NimBLEUUID", measure(N, [&](uint32_t i) {
+    const NimBLEAdvertisedDevice* d = devs[i & 1];
+    const std::string& n = d->getName();
+    bool hit = !n.empty() && n.find("OSSM") != std::string::npos;
+    for (int u = 0; !hit && u < d->getServiceUUIDCount(); ++u)
+      hit = d->getServiceUUID(u).equals(NimBLEUUID("e5560000-6a2d-436f-a43d-82eab88dcefd"));
+    s_sink += hit;
+  }));
+  report("bleadv::match (Rohbytes)", measure(N, [&](uint32_t i) {
+    const std::vector<uint8_t>& p = devs[i & 1]->getPayload();
+    const bleadv::Match m = bleadv::match(p.data(), p.size());
+    s_sink += m.name || m.uuid;
+  }));
+}
+
+// ---------- POSITION-Mode: Bahnplaner vs. ein move(350 ms) pro Eingabeänderung ----------
+// Offline mit synthetischer Uhr (1 ms). Das Gerät fährt replace-moves linear ab; gemessen
+// werden Kommandos, Geschwindigkeitssprünge an Segmentwechseln und der Nachlauf zum Ziel.
+struct FollowDev {
+  float pos = 50.0f, from = 50.0f, to = 50.0f, vel = 0.0f;
+  uint32_t t0 = 0, ms = 1;
+  uint32_t cmds = 0;
+  uint32_t minGapMs = UINT32_MAX;   // kürzester Abstand zweier moves
+  float maxDv = 0.0f;
+  void move(uint32_t nowMs, int p, int dur) {
+    const float v = ((float)p - pos) * 1000.0f / (float)dur;
+    maxDv = std::max(maxDv, fabsf(v - vel));
+    if (cmds) minGapMs = std::min(minGapMs, nowMs - t0);
+    from = pos; to = (float)p; t0 = nowMs; ms = (uint32_t)dur; vel = v; cmds++;
+  }
+  void step(uint32_t nowMs) {
+    const float t = std::min(1.0f, (float)(nowMs - t0) / (float)ms);
+    pos = from + (to - from) * t;
+    if (t >= 1.0f) vel = 0.0f;
+  }
+};
+
+// Eingabe: Drehen mit wechselnder Rate, Pause, dann Sprung per Tap
+int scriptTarget(uint32_t tMs) {
+  if (tMs < 600)  return 50 + (int)(tMs / 15);           // zügig hoch
+  if (tMs < 1200) return 90 - (int)((tMs - 600) / 40);   // langsam zurück
+  if (tMs < 1600) return 75;
+  return 20;                                             // Tap
+}
+
+void benchMotion() {
+  printf("[BENCH] POSITION-Mode 2,4 s Eingabeskript (Gerät folgt replace-moves linear)\n");
+  const uint32_t kDurMs = 2400;
+  FollowDev naive, plan;
+  double errNaive = 0, errPlan = 0;
+  int last = 50;
+  deviceStateReset();
+  motionReset(50);
+  for (uint32_t t = 0; t < kDurMs; ++t) {
+    const int target = scriptTarget(t);
+    if (target != last) {
+      last = target;
+      naive.move(t, target, g_moveTime);
+      motionSetTarget(target, t * 1000u);
+    }
+    MotionSegment seg;
+    if (motionNextSegment(t * 1000u, seg)) plan.move(t, seg.pos, seg.ms);
+    naive.step(t);
+    plan.step(t);
+    errNaive += fabsf(naive.pos - (float)target);
+    errPlan += fabsf(plan.pos - (float)target);
+  }
+  printf("  %-28s %6s %12s %12s %10s\n", "", "cmds", "max dv %/s", "Nachlauf %", "Endlage");
+  printf("  %-28s %6u %12.0f %12.2f %10.1f\n", "move pro Änderung (350 ms)", naive.cmds, naive.maxDv, errNaive / kDurMs, naive.pos);
+  printf("  %-28s %6u %12.0f %12.2f %10.1f\n", "Bahnplaner 25 Hz", plan.cmds, plan.maxDv, errPlan / kDurMs, plan.pos);
+  check(plan.cmds <= naive.cmds, "Bahnplaner sendet mehr moves als move pro Änderung");
+  check(plan.maxDv <= 100.0f, "Geschwindigkeitssprung > 100 %/s an einem Segmentwechsel");
+  check(fabsf(plan.pos - (float)scriptTarget(kDurMs - 1)) < 0.5f, "Endlage verfehlt das Ziel");
+  check(plan.minGapMs >= 40, "move-Rate über 25 Hz");
+}
+
+// ---------- Touch: Treffer-Tests + atan2f (ursprüngliches onTap/onDrag) vs. Tabelle ----------
+// Referenz = die alte Mathematik aus input.cpp; Regionen in onTap-Reihenfolge
+enum RefRegion { RNone, RMinus, RPlay, RPlus, RPill, RSens, RRange };
+
+int refRegion(int x, int y) {
+  const int cy = BUTTONS_Y;
+  if (abs(y - cy) <= 24) {
+    if ((x - (CX - CTRL_SPACING)) * (x - (CX - CTRL_SPACING)) + (y - cy) * (y - cy) <= 18 * 18) return RMinus;
+    if ((x - CX) * (x - CX) + (y - cy) * (y - cy) <= 24 * 24) return RPlay;
+    if ((x - (CX + CTRL_SPACING)) * (x - (CX + CTRL_SPACING)) + (y - cy) * (y - cy) <= 18 * 18) return RPlus;
+  }
+  if (x >= CX - 60 && x <= CX + 60 && y >= CTRL_Y - 12 && y <= CTRL_Y + 12) return RPill;
+  if (inAnnulus(x, y, R_SENS_IN, R_SENS_OUT)) {
+    const float a = relBottomDeg(x, y);
+    if (a >= -75.0f && a <= 75.0f) return RSens;
+  }
+  if (inAnnulus(x, y, R_RANGE_IN, R_RANGE_OUT)) {
+    const float a = relTopDeg(x, y);
+    if (a >= -90.0f && a <= 90.0f) return RRange;
+  }
+  return RNone;
+}
+
+int refTop(int x, int y)  { return (int)roundf((clampf(relTopDeg(x, y), -90.0f, 90.0f) + 90.0f) / 180.0f * 100.0f); }
+int refPos(int x, int y)  { return (int)roundf((clampf(relBottomDeg(x, y), -75.0f, 75.0f) + 75.0f) / 150.0f * 100.0f); }
+int refSens(int x, int y) {
+  const float t = (clampf(relBottomDeg(x, y), -75.0f, 75.0f) + 75.0f) / 150.0f;
+  return clampi((int)roundf(((0.5f - t) / 0.5f) * 100.0f), -100, 100);
+}
+
+void benchPolar() {
+  printf("[BENCH] Touch-Abtastung: Region + Reglerwert\n");
+  // Vollständiger Abgleich über alle Pixel: Tabelle muss exakt die alte Mathematik treffen
+  uint32_t badRegion = 0, badTop = 0, badPos = 0, badSens = 0;
+  for (int y = 0; y < H; ++y)
+    for (int x = 0; x < W; ++x) {
+      badRegion += (int)polar::regionAt(x, y) != refRegion(x, y);
+      badTop    += polar::topValue(x, y) != refTop(x, y);
+      badPos    += polar::posValue(x, y) != refPos(x, y);
+      badSens   += polar::sensValue(x, y) != refSens(x, y);
+    }
+  printf("  Abgleich %d Pixel: Region %u, Stroke/Depth %u, Position %u, Sensation %u Abweichungen\n",
+         W * H, badRegion, badTop, badPos, badSens);
+  check(badRegion + badTop + badPos + badSens == 0, "polar-Tabelle weicht von der Geometrie ab");
+
+  // Messung: Treffer-Test + Wert einer Abtastung, Punkte pseudozufällig über den Bildschirm
+  const uint32_t N = 400000;
+  auto px = [](uint32_t i) { return (int)((i * 2654435761u) >> 8) % W; };
+  auto py = [](uint32_t i) { return (int)((i * 40503u + 17u) >> 3) % H; };
+  report("Kreise + atan2f", measure(N, [&](uint32_t i) {
+    const int x = px(i), y = py(i);
+    const int r = refRegion(x, y);
+    s_sink += r + (r == RSens ? refSens(x, y) : refTop(x, y));
+  }));
+  report("polar-Tabelle", measure(N, [&](uint32_t i) {
+    const int x = px(i), y = py(i);
+    const polar::Region r = polar::regionAt(x, y);
+    s_sink += (int)r + (r == polar::Region::SensBand ? polar::sensValue(x, y) : polar::topValue(x, y));
+  }));
+}
+
+// ---------- Labels: String + drawString (ursprüngliches drawLabels) vs. Atlas-Blit ----------
+void benchText() {
+  LGFX_Sprite spr;
+  spr.setColorDepth(16);
+  spr.createSprite(W, H);
+  glyphsInit();
+  const uint32_t N = 20000;
+  printf("[BENCH] drawLabels (4 Labels, Font2)\n");
+  report("String + drawString", measure(N, [&](uint32_t i) {
+    const int v = (int)(i % 101);
+    spr.setTextDatum(textdatum_t::middle_center);
+    spr.setFont(&fonts::Font2);
+    spr.setTextColor(spr.color888(200,220,255));
+    spr.drawString(String("Speed ") + v + "%", CX, CY - 54);
+    spr.setTextColor(spr.color888(180,255,180));
+    spr.drawString(String(v) + "%", CX - 70, CY - 10);
+    spr.drawString(String(100 - v) + "%", CX + 70, CY - 10);
+    spr.setTextColor(TFT_WHITE);
+    spr.drawString(String("Sens ") + String(v - 50), CX, CY + 80);
+  }));
+  report("fmtInt + glyphDraw", measure(N, [&](uint32_t i) {
+    const int v = (int)(i % 101);
+    char buf[16];
+    fmtStr(fmtInt(fmtStr(buf, "Speed "), v), "%");
+    glyphDraw(spr, GlyphFont::Normal, buf, CX, CY - 54, spr.color888(200,220,255));
+    fmtStr(fmtInt(buf, v), "%");
+    glyphDraw(spr, GlyphFont::Normal, buf, CX - 70, CY - 10, spr.color888(180,255,180));
+    fmtStr(fmtInt(buf, 100 - v), "%");
+    glyphDraw(spr, GlyphFont::Normal, buf, CX + 70, CY - 10, spr.color888(180,255,180));
+    fmtInt(fmtStr(buf, "Sens "), v - 50);
+    glyphDraw(spr, GlyphFont::Normal, buf, CX, CY + 80, spr.color888(255,255,255));
+  }));
+  spr.deleteSprite();
+}
+
+// ---------- Hintergrund: fillRect + Spuren/Chrome zeichnen vs. Kopie aus der Hintergrundebene ----------
+void drawStaticRef(LGFX_Sprite& d) {
+  rasterArcBand(d, CX, CY, R_SPEED_IN, R_SPEED_OUT, TOP_START, TOP_END, d.color888(30,30,30));
+  rasterArcBand(d, CX, CY, R_RANGE_IN, R_RANGE_OUT, TOP_START, TOP_END, d.color888(28,28,28));
+  rasterArcBand(d, CX, CY, R_SPEED_IN - 8, R_SPEED_OUT - 8, SENS_START, SENS_END, d.color888(30,30,30));
+  const uint32_t colBg = d.color888(30,30,30);
+  d.fillCircle(CX - CTRL_SPACING, BUTTONS_Y, 18, colBg);
+  d.fillRect  (CX - CTRL_SPACING - 10, BUTTONS_Y - 3, 20, 6, TFT_WHITE);
+  d.fillCircle(CX, BUTTONS_Y, 22, colBg);
+  d.fillCircle(CX + CTRL_SPACING, BUTTONS_Y, 18, colBg);
+  d.fillRect  (CX + CTRL_SPACING - 10, BUTTONS_Y - 3, 20, 6, TFT_WHITE);
+  d.fillRect  (CX + CTRL_SPACING - 3,  BUTTONS_Y - 10, 6, 20, TFT_WHITE);
+  d.fillRoundRect(CX - 60, CTRL_Y - 12, 120, 24, 12, d.color888(40,40,40));
+}
+
+void benchBackground() {
+  LGFX_Sprite spr;
+  spr.setColorDepth(16);
+  spr.createSprite(W, H);
+  spr.fillSprite(TFT_BLACK);
+  drawStaticRef(spr);
+  if (!bgLayerCapture(spr)) { printf("[BENCH] Hintergrundebene: kein Cache\n"); return; }
+  const BgLayerStats bs = bgLayerStats();
+  printf("[BENCH] Hintergrund (Cache %u B, %u Farben, %u px genähert)\n",
+         (unsigned)bs.bytes, (unsigned)bs.colors, (unsigned)bs.approxPixels);
+
+  // Kopie muss bitgleich zum direkt gezeichneten Bild sein
+  std::vector<uint16_t> ref((const uint16_t*)spr.getBuffer(), (const uint16_t*)spr.getBuffer() + W * H);
+  spr.fillSprite(TFT_RED);
+  bgLayerBlit(spr, makeRect(0, 0, W, H));
+  uint32_t bad = 0;
+  for (int i = 0; i < W * H; ++i) bad += ((const uint16_t*)spr.getBuffer())[i] != ref[i];
+  printf("  Abgleich %d Pixel: %u Abweichungen\n", W * H, bad);
+  check(bad == 0, "Hintergrund-Blit nicht bitgleich");
+
+  const Rect full = makeRect(0, 0, W, H);
+  const Rect part = makeRect(CX - 61, CY - 113, CX - 21, CY - 91);   // typischer Speed-Sektor
+  const uint32_t N = 2000;
+  report("Vollbild fillRect + Zeichnen", measure(N, [&](uint32_t) {
+    spr.fillRect(0, 0, W, H, TFT_BLACK);
+    drawStaticRef(spr);
+  }));
+  report("Vollbild Blit", measure(N, [&](uint32_t) { bgLayerBlit(spr, full); }));
+  report("Sektor fillRect + Zeichnen", measure(N, [&](uint32_t) {
+    spr.setClipRect(part.x, part.y, part.w, part.h);
+    spr.fillRect(part.x, part.y, part.w, part.h, TFT_BLACK);
+    drawStaticRef(spr);
+    spr.clearClipRect();
+  }));
+  report("Sektor Blit", measure(N * 10, [&](uint32_t) { bgLayerBlit(spr, part); }));
+  spr.deleteSprite();
+}
+
+// ---------- 8-bit-Palette: Zeichnen in Indizes + Expandieren beim Push vs. RGB565 direkt ----------
+void benchPalette() {
+  if (!UI_PALETTE_8BIT) { printf("[BENCH] 8-bit-Palette: nur mit -DUI_PALETTE_8BIT=1\n"); return; }
+  palInit();
+  std::vector<uint16_t> px16(W * H);
+  std::vector<uint8_t>  px8(W * H);
+  std::vector<uint16_t> out(W * 16);
+  LGFX_Sprite s16, s8;
+  s16.setBuffer(px16.data(), W, H, lgfx::color_depth_t::rgb565_2Byte);
+  s8.setBuffer(px8.data(), W, H, lgfx::color_depth_t::palette_8bit);
+  const uint32_t N = 2000;
+  printf("[BENCH] Backbuffer 16 bpp (%u B) vs. 8-bit-Palette (%u B)\n", (unsigned)(W * H * 2), (unsigned)(W * H));
+  report("Ringe 16 bpp", measure(N, [&](uint32_t i) {
+    rasterArcBand(s16, CX, CY, R_RANGE_IN, R_RANGE_OUT, TOP_START, TOP_END - (float)(i % 90), s16.color888(120,255,120));
+    rasterArcBand(s16, CX, CY, R_SPEED_IN, R_SPEED_OUT, TOP_START, TOP_END - (float)(i % 90), s16.color888(0,180,255));
+  }));
+  report("Ringe 8 bpp (Mischindex)", measure(N, [&](uint32_t i) {
+    rasterArcBand(s8, CX, CY, R_RANGE_IN, R_RANGE_OUT, TOP_START, TOP_END - (float)(i % 90), (uint32_t)Pal::Range);
+    rasterArcBand(s8, CX, CY, R_SPEED_IN, R_SPEED_OUT, TOP_START, TOP_END - (float)(i % 90), (uint32_t)Pal::Accent);
+  }));
+  report("Expandieren Vollbild", measure(N, [&](uint32_t) {
+    for (int y = 0; y < H; ++y) palExpand(px8.data() + y * W, out.data() + (y & 15) * W, W);
+  }));
+  const PaletteStats ps = paletteStats();
+  printf("  Palette: %u Einträge, %u Mischfarben genähert\n", (unsigned)ps.used, (unsigned)ps.approx);
+}
+
+// ---------- Energiestufen: Übergänge und Tastverhältnis mit simulierter Uhr ----------
+uint32_t s_fakeMs = 0;
+struct { uint32_t mhz, bright, sampler, calls; bool sleep; } s_hw;
+
+void benchPower() {
+  printf("[CHECK] PowerManager (simulierte Uhr, loop() = 1 ms Arbeit + erlaubte Pause)\n");
+  const PowerHooks hooks{
+    [](uint32_t mhz, bool sl) { s_hw.mhz = mhz; s_hw.sleep = sl; s_hw.calls++; },
+    [](uint8_t b) { s_hw.bright = b; },
+    [](uint32_t ms) { s_hw.sampler = ms; },
+  };
+  const PowerConfig cfg;
+  s_fakeMs = 0;
+  PowerManager pm(cfg, hooks, [] { return s_fakeMs; });
+  pm.begin();
+
+  auto expect = [&](PowerLevel l, const char* what) {
+    const PowerLevelCfg& c = cfg.level[(int)l];
+    if (!check(pm.level() == l && s_hw.mhz == c.cpuMhz && s_hw.bright == c.brightness && s_hw.sampler == c.samplerMs &&
+               s_hw.sleep == (l != PowerLevel::Active), what))
+      printf("    bei %u ms\n", s_fakeMs);
+  };
+  expect(PowerLevel::Active, "Start");
+
+  // Leerlauf: Übergangszeitpunkte und Wach-Anteil je Stufe
+  uint32_t enterMs[(int)PowerLevel::Count] = {};
+  uint64_t awake[(int)PowerLevel::Count] = {}, total[(int)PowerLevel::Count] = {};
+  uint32_t loops = 0;
+  PowerLevel last = pm.level();
+  while (s_fakeMs < 200000) {
+    s_fakeMs += 1;
+    pm.tick();
+    if (pm.level() != last) { last = pm.level(); enterMs[(int)last] = s_fakeMs; }
+    const uint32_t w = pm.waitMs();
+    awake[(int)last] += 1;
+    total[(int)last] += 1 + w;
+    s_fakeMs += w;
+    ++loops;
+  }
+  const uint32_t step = cfg.level[(int)PowerLevel::Dimmed].waitMs + 1;   // Auflösung in Dimmed
+  check(enterMs[(int)PowerLevel::Dimmed] >= cfg.dimAfterMs && enterMs[(int)PowerLevel::Dimmed] <= cfg.dimAfterMs + 1,
+        "Dimmed nicht nach dimAfterMs");
+  check(enterMs[(int)PowerLevel::DeepIdle] >= cfg.deepAfterMs && enterMs[(int)PowerLevel::DeepIdle] <= cfg.deepAfterMs + step,
+        "DeepIdle nicht nach deepAfterMs");
+  expect(PowerLevel::DeepIdle, "Leerlauf");
+
+  // Bedienung: sofort Active mit allen Hooks, danach wieder derselbe Ablauf
+  pm.activity();
+  expect(PowerLevel::Active, "Wecken");
+  s_fakeMs += cfg.dimAfterMs - 1;
+  pm.tick();
+  expect(PowerLevel::Active, "kurz vor Dimmen");
+  s_fakeMs += 1;
+  pm.tick();
+  expect(PowerLevel::Dimmed, "Dimmen");
+
+  const PowerStats st = pm.stats();
+  uint64_t sum = 0;
+  for (uint32_t v : st.msIn) sum += v;
+  check(sum == s_fakeMs, "Zeit je Stufe ergibt nicht die Laufzeit");
+  printf("  Dimmed ab %u ms, DeepIdle ab %u ms, %u Übergänge, %u loop()-Runden in 200 s\n",
+         enterMs[(int)PowerLevel::Dimmed], enterMs[(int)PowerLevel::DeepIdle], st.transitions, loops);
+  static const char* const kName[] = { "Active", "Dimmed", "DeepIdle" };
+  for (int i = 0; i < (int)PowerLevel::Count; ++i) {
+    printf("  %-9s wach %5.1f %%  (%u MHz, Helligkeit %u, Sampler %u ms)\n", kName[i],
+           total[i] ? 100.0 * awake[i] / total[i] : 0.0, cfg.level[i].cpuMhz, cfg.level[i].brightness, cfg.level[i].samplerMs);
+    // Tastverhältnis: 1 ms Arbeit je erlaubter Pause
+    const double share = total[i] ? (double)awake[i] / total[i] : 0.0;
+    check(fabs(share - 1.0 / (1 + cfg.level[i].waitMs)) < 0.005, "Wach-Anteil passt nicht zur Pause der Stufe");
+  }
+}
+
+// ---------- Pattern-Wiedergabe: Zeitgenauigkeit über eine Funkstrecke mit Jitter ----------
+// Link: Laufzeit 20..50 ms (FIFO), Schätzung 35 ms; loop() alle 2 ms, alle 700 ms 60 ms Stau.
+// Gerät folgt jedem move linear (replace). Nach 3 s ändern sich Speed und Stroke.
+// loopMs/wakeOnDue: Leerlauf-Pause von powerIdleWait(), mit bzw. ohne Weckung zum nächsten Segment.
+struct LinkRun { uint32_t segs, skipped, late; float rms, maxDt; };
+
+LinkRun runPlayback(PatternGen gen, uint32_t jitterMs, uint32_t stallMs, uint32_t& bad,
+                    uint32_t loopMs = 2, bool wakeOnDue = false) {
+  const uint32_t kDurMs = 6000, kBaseMs = 20, kLatMs = kBaseMs + jitterMs / 2;
+  PlayParams p{ gen, 20, 80, 2000 };
+  PatternStream ps;
+  ps.start(p, 0, 50);
+  FollowDev dev;
+  struct InFlight { uint32_t atMs, endMs; int pos, ms; };
+  std::vector<InFlight> air;
+  uint32_t rng = 12345, lastAt = 0, nextLoop = 0;
+  float phase = 0.0f, maxDt = 0.0f;
+  double err2 = 0;
+  uint32_t nErr = 0;
+  for (uint32_t t = 0; t < kDurMs; ++t) {
+    if (t == 3000) { p.cycleMs = 1400; p.lo = 35; ps.setParams(p); }
+    if (t >= 400) phase = fmodf(phase + 1.0f / (float)p.cycleMs, 1.0f);   // Musteruhr nach dem Einlauf
+    if (t >= nextLoop) {
+      MotionSegment seg;
+      while (ps.next(t, kLatMs, seg)) {
+        rng = rng * 1103515245u + 12345u;
+        const uint32_t at = std::max(lastAt, t + kBaseMs + (jitterMs ? (rng >> 16) % (jitterMs + 1) : 0));
+        lastAt = at;
+        air.push_back(InFlight{ at, t + kLatMs + (uint32_t)seg.ms, seg.pos, seg.ms });
+      }
+      uint32_t wait = loopMs;
+      const int32_t due = ps.dueInMs(t, kLatMs);
+      if (wakeOnDue && due >= 0) wait = std::min<uint32_t>(wait, (uint32_t)std::max<int32_t>(due, 1));
+      nextLoop = t + ((t % 700) < 2 ? wait + stallMs : wait);
+    }
+    while (!air.empty() && air.front().atMs <= t) {
+      const InFlight f = air.front();
+      air.erase(air.begin());
+      dev.move(t, f.pos, f.ms);
+      const float dt = fabsf((float)(int32_t)(t + f.ms - f.endMs));   // Ankunft am Ziel vs. Plan
+      maxDt = std::max(maxDt, dt);
+      if (dt > jitterMs / 2 + 1) ++bad;
+    }
+    dev.step(t);
+    // Lagefehler bis zum Wechsel (danach greift die neue Phase erst am Ende des laufenden Segments)
+    if (t >= 600 && t < 3000) {
+      const float ideal = (float)p.lo + clampf(gen(phase), 0.0f, 1.0f) * (float)(p.hi - p.lo);
+      err2 += (dev.pos - ideal) * (dev.pos - ideal);
+      ++nErr;
+    }
+  }
+  const PlayStats st = ps.stats(kDurMs);
+  return LinkRun{ st.segments, st.skipped, st.maxLateMs, (float)sqrt(err2 / std::max<uint32_t>(nErr, 1)), maxDt };
+}
+
+void benchPlayback() {
+  printf("[CHECK] Pattern-Wiedergabe 6 s (Link 20..50 ms, loop()-Stau 60 ms alle 700 ms)\n");
+  printf("  %-20s %6s %5s %7s %9s %9s %9s\n", "", "seg/s", "skip", "late ms", "|dt| max", "rms %", "ideal %");
+  for (int i = 0; i < patternCount(); ++i) {
+    const PatternDesc& pd = patternAt(i);
+    uint32_t bad = 0, dummy = 0;
+    const LinkRun ideal = runPlayback(pd.gen, 0, 0, dummy);   // ohne Jitter/Stau: nur Segmentierung
+    const LinkRun r = runPlayback(pd.gen, 30, 60, bad);
+    printf("  %-20s %6.1f %5u %7u %9.0f %9.2f %9.2f\n", pd.name, r.segs / 6.0f, r.skipped, r.late,
+           r.maxDt, r.rms, ideal.rms);
+    check(ideal.maxDt <= 1.0f, "Segmente ohne Jitter nicht auf die Musterzeit");
+    if (!check(bad == 0, "Ziel später/früher als halber Jitter")) printf("    %u Segmente\n", bad);
+  }
+
+  // DeepIdle: loop() pausiert bis 40 ms; powerIdleWait() weckt zum nächsten Segment (playDueInMs)
+  printf("[CHECK] Pattern-Wiedergabe mit loop()-Pause 40 ms (Link 20..50 ms)\n");
+  printf("  %-20s %11s %11s\n", "", "skip fest", "skip Weckung");
+  for (int i = 0; i < patternCount(); ++i) {
+    const PatternDesc& pd = patternAt(i);
+    uint32_t dummy = 0, bad = 0;
+    const LinkRun fixed = runPlayback(pd.gen, 30, 0, dummy, 40, false);
+    const LinkRun woken = runPlayback(pd.gen, 30, 0, bad, 40, true);
+    printf("  %-20s %11u %11u\n", pd.name, fixed.skipped, woken.skipped);
+    check(woken.skipped == 0, "Segment in der Leerlauf-Pause verpasst");
+    check(bad == 0, "Ziel später/früher als halber Jitter (Leerlauf-Pause)");
+  }
+}
+
+}  // namespace
+
+int simMicroBench() {
+  printf("\n");
+  benchJson();
+  benchArcs();
+  benchAdv();
+  benchMotion();
+  benchPolar();
+  benchText();
+  benchBackground();
+  benchPalette();
+  benchPower();
+  benchPlayback();
+  (void)s_sink;
+  printf("\n[CHECK] %d Prüfung(en) verletzt\n", s_fails);
+  return s_fails;
+}
+#endif
@@ -0,0 +1,255 @@
+// Host-Runner für [env:native]: setup()/loop() gegen simuliertes M5Dial + OSSM,
+// skriptbare Szenarien, Kennzahlen pro Szenario. Aufruf:
+//   .pio/build/native/program [sekunden_pro_szenario] [--micro]
+// --micro: Benchmarks + Prüfungen (sim_bench.cpp), Exit-Code 1 bei verletzter Prüfung
+#if defined(NATIVE_SIM)
+#include <Arduino.h>
+#include <sim_hal.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include "../geometry.h"
+#include "../ble.h"
+#include "../ui.h"
+#include "../frame_sched.h"
+#include "../pattern_catalog.h"
+
+void setup();
+void loop();
+int  simMicroBench();   // sim_bench.cpp: Anzahl verletzter Prüfungen
+void simOssmInstall();  // sim_ossm.cpp
+
+namespace {
+
+// ---------- Skript-Helfer ----------
+// Punkt auf dem Kreis um (CX,CY); 0° = rechts, 90° = unten (wie die Ringe)
+void polar(float deg, float r, int16_t& x, int16_t& y) {
+  const float a = deg * (float)M_PI / 180.0f;
+  x = (int16_t)lroundf(CX + r * cosf(a));
+  y = (int16_t)lroundf(CY + r * sinf(a));
+}
+
+void tap(int16_t x, int16_t y) {
+  sim::touch(true, x, y);
+  delay(30);
+  sim::touch(false);
+  delay(30);
+}
+
+// ---------- Szenarien ----------
+// tick(t, dur): einmal pro loop(); t = ms seit Szenariostart
+struct Scenario {
+  const char* name;
+  void (*enter)();
+  void (*tick)(uint32_t t, uint32_t dur);
+  void (*leave)();
+};
+
+uint32_t s_nextMs = 0;
+bool due(uint32_t t, uint32_t periodMs) {
+  if (t < s_nextMs) return false;
+  s_nextMs = t + periodMs;
+  return true;
+}
+
+void noop() {}
+void idleTick(uint32_t, uint32_t) {}
+
+// zügiges Drehen (50 Counts/s, mit Beschleunigung), Richtungswechsel alle 500 ms –
+// bleibt so im Wertebereich statt am Anschlag zu kleben
+void spinTick(uint32_t t, uint32_t) {
+  if (due(t, 20)) sim::encoderAdd((t / 500) % 2 ? -1 : 1);
+}
+
+// Wackeln an einer Rastung (±2 Counts im Wechsel, schneller als das Sendeintervall) – Werte pendeln um den gemeldeten Stand
+void jitterTick(uint32_t t, uint32_t) {
+  static int dir = 1;
+  if (due(t, 12)) { sim::encoderAdd(2 * dir); dir = -dir; }
+}
+
+// Stroke-Griff über den oberen Halbring ziehen (Wischbewegung hin und her, 60 Hz Touch)
+void dragEnter() {
+  int16_t x, y;
+  polar(180.0f + 5.0f, (R_RANGE_IN + R_RANGE_OUT) / 2.0f, x, y);
+  sim::touch(true, x, y);
+}
+void dragTick(uint32_t t, uint32_t) {
+  if (!due(t, 16)) return;
+  const float ph = fmodf(t / 1500.0f, 1.0f);
+  const float tri = ph < 0.5f ? ph * 2.0f : 2.0f - ph * 2.0f;
+  int16_t x, y;
+  polar(180.0f + 5.0f + tri * 80.0f, (R_RANGE_IN + R_RANGE_OUT) / 2.0f, x, y);
+  sim::touch(true, x, y);
+}
+void dragLeave() { sim::touch(false); delay(30); }
+
+// POSITION-Mode: Play tippt den Mode um, dann Position mit dem Encoder fahren
+void posEnter() { tap(CX, BUTTONS_Y); }
+void posTick(uint32_t t, uint32_t dur) { spinTick(t, dur); }
+void posLeave() { tap(CX, BUTTONS_Y); }
+
+// Pattern-Picker: Pill antippen, durchscrollen, mit Klick bestätigen
+void pickEnter() { tap(CX, CTRL_Y); }
+void pickTick(uint32_t t, uint32_t dur) {
+  if (due(t, 120)) sim::encoderAdd((t / 1000) % 2 ? -4 : 4);
+  (void)dur;
+}
+void pickLeave() { sim::button(true); delay(40); sim::button(false); delay(40); }
+
+const Scenario kScenarios[] = {
+  { "idle",        noop,      idleTick, noop      },
+  { "speed-spin",  noop,      spinTick, noop      },
+  { "enc-jitter",  noop,      jitterTick, noop    },
+  { "stroke-drag", dragEnter, dragTick, dragLeave },
+  { "pos-encoder", posEnter,  posTick,  posLeave  },
+  { "picker",      pickEnter, pickTick, pickLeave },
+};
+
+// ---------- Messung ----------
+void runScenario(const Scenario& sc, uint32_t durMs, std::vector<uint32_t>& frameUs) {
+  frameUs.clear();
+  sc.enter();
+  for (int i = 0; i < 5; ++i) loop();      // Eingang der enter()-Aktion verarbeiten
+
+  const UiFrameStats f0 = uiFrameStats();
+  const FrameSchedStats s0 = frameSchedStats();
+  const BleTxStats   b0 = ble_tx_stats();
+  const sim::WireStats w0 = sim::wireStats();
+  const sim::AllocStats a0 = sim::allocStats();
+  uint32_t lastFrames = f0.frames;
+  uint64_t spiBytes = 0;
+
+  s_nextMs = 0;
+  const uint32_t t0 = millis();
+  for (uint32_t t = 0; t < durMs; t = millis() - t0) {
+    sc.tick(t, durMs);
+    loop();
+    const UiFrameStats f = uiFrameStats();
+    if (f.frames != lastFrames) {
+      lastFrames = f.frames;
+      if (frameUs.size() < frameUs.capacity()) frameUs.push_back(f.frameUs);   // ohne Realloc
+      spiBytes += f.spiBytes;
+    }
+  }
+  const float secs = (millis() - t0) / 1000.0f;
+
+  const UiFrameStats f1 = uiFrameStats();
+  const FrameSchedStats s1 = frameSchedStats();
+  const BleTxStats   b1 = ble_tx_stats();
+  const sim::WireStats w1 = sim::wireStats();
+  const sim::AllocStats a1 = sim::allocStats();
+  sc.leave();
+  for (int i = 0; i < 5; ++i) loop();
+
+  const uint32_t frames = f1.frames - f0.frames;
+  std::sort(frameUs.begin(), frameUs.end());
+  uint64_t sum = 0;
+  for (uint32_t v : frameUs) sum += v;
+  const uint32_t n = (uint32_t)frameUs.size();
+  const uint32_t avg = n ? (uint32_t)(sum / n) : 0;
+  const uint32_t p99 = n ? frameUs[std::min<uint32_t>(n - 1, n * 99 / 100)] : 0;
+  const uint32_t mx  = n ? frameUs.back() : 0;
+  const uint64_t allocs = a1.allocs - a0.allocs;
+
+  printf("%-12s %6.1f %6u %6u %6u %8.1f %7.1f %7.1f %6.1f %6u %6.0f %6.0f %4u %8.2f %4u %4u %5.1f %5.1f %5.1f\n",
+         sc.name, frames / secs, avg, p99, mx,
+         frames ? spiBytes / 1024.0f / frames : 0.0f,
+         (b1.cmds - b0.cmds) / secs, (w1.writes - w0.writes) / secs, (b1.skipped - b0.skipped) / secs,
+         w1.rejected - w0.rejected, b1.rateHz, b1.rttMs, b1.queueHigh,
+         frames ? (double)allocs / frames : 0.0,
+         s1.missed - s0.missed, s1.intervalMs, s1.renderPm / 10.0f, s1.inputPm / 10.0f, s1.blePm / 10.0f);
+}
+
+// ---------- Verbindungsaufbau: Boot (leerer Cache) und Linkverlust ----------
+// längster loop()-Durchlauf während des Aufbaus: zeigt, ob Eingabe/Zeichnen blockiert sind
+uint32_t loopTimed(uint32_t& maxUs) {
+  const uint32_t t0 = micros();
+  loop();
+  const uint32_t dt = micros() - t0;
+  if (dt > maxUs) maxUs = dt;
+  return dt;
+}
+
+void linkRow(const char* name, const BleLinkStats& l0, uint32_t maxUs = 0) {
+  const uint32_t tc = millis();
+  while (!ble_is_connected() && millis() - tc < 8000) loopTimed(maxUs);
+  bleSendConnected();
+  while (ble_is_connected() && ble_link_stats().firstCmdMs == 0 && millis() - tc < 9000) loopTimed(maxUs);
+  const BleLinkStats l = ble_link_stats();
+  printf("%-14s %8u %8u %8s %6u %9.1f\n", name, l.readyMs, l.firstCmdMs, l.cached ? "cache" : "scan",
+         l.cacheMisses - l0.cacheMisses, maxUs / 1000.0f);
+}
+
+void linkScenarios() {
+  printf("\n[SIM] Verbindungsaufbau bis zum ersten Kommando\n");
+  printf("%-14s %8s %8s %8s %6s %9s\n", "fall", "readyMs", "1.cmdMs", "weg", "miss", "maxLoopMs");
+  BleLinkStats l0 = ble_link_stats();
+  linkRow("boot", l0);
+  for (uint32_t t = millis(); millis() - t < 300;) loop();
+
+  l0 = ble_link_stats();
+  sim::peerDisconnect();
+  linkRow("link-loss", l0);
+
+  // Firmware-Update auf dem OSSM: Handles verschoben → CCCD-Write scheitert, Discovery
+  l0 = ble_link_stats();
+  sim::peer().ctrlHandle = 0x0030;
+  sim::peerDisconnect();
+  linkRow("stale-handles", l0);
+
+  // OSSM kurz aus: Direkt-Connect läuft in den Timeout, dann Scan bis er wieder sendet
+  l0 = ble_link_stats();
+  sim::peer().advertise = false;
+  sim::peerDisconnect();
+  uint32_t maxUs = 0;
+  for (uint32_t t = millis(); millis() - t < 2000;) loopTimed(maxUs);
+  sim::peer().advertise = true;
+  linkRow("peer-away-2s", l0, maxUs);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  uint32_t durMs = 2000;
+  bool micro = false;
+  for (int i = 1; i < argc; ++i) {
+    if (!strcmp(argv[i], "--micro")) micro = true;
+    else if (atof(argv[i]) > 0) durMs = (uint32_t)(atof(argv[i]) * 1000.0);
+  }
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+
+  sim::allocCountThisThread();   // alloc/f: nur loop(), nicht OSSM-Simulation und NimBLE-Shim
+  simOssmInstall();
+  setup();
+
+  // auf Verbindung mit dem simulierten OSSM warten
+  linkScenarios();
+  if (!ble_is_connected()) { printf("[SIM] keine Verbindung zum simulierten OSSM\n"); fflush(stdout); _exit(1); }
+  for (uint32_t t = millis(); millis() - t < 300;) loop();   // Start-Kommandos + erster Vollframe
+
+  std::vector<uint32_t> frameUs;
+  frameUs.reserve(4096);
+
+  printf("\n[SIM] MTU %u, %.1f s pro Szenario\n", (unsigned)ble_tx_stats().mtu, durMs / 1000.0f);
+  printf("%-12s %6s %6s %6s %6s %8s %7s %7s %6s %6s %6s %6s %4s %8s %4s %4s %5s %5s %5s\n",
+         "scenario", "fps", "avgUs", "p99Us", "maxUs", "KiB/frm", "cmd/s", "wr/s", "skip/s", "rej", "txHz", "rttMs", "qHi", "alloc/f",
+         "miss", "ivMs", "rnd%", "inp%", "ble%");
+  for (const Scenario& sc : kScenarios) runScenario(sc, durMs, frameUs);
+
+  const CatalogStats cat = catalogStats();
+  printf("\n[SIM] Musterkatalog: %u Muster, Hash %08x, %u Abruf(e), %u Verbindung(en) ohne Abruf, "
+         "%u NVS-Schreibvorgang, Pool %u B, %u Namen geladen (%u Pool-Lesezugriffe)\n",
+         (unsigned)cat.count, (unsigned)cat.hash, (unsigned)cat.fetches, (unsigned)cat.skips, (unsigned)cat.stores,
+         (unsigned)cat.poolBytes, (unsigned)cat.nameLoads, (unsigned)cat.poolReads);
+
+  const int fails = micro ? simMicroBench() : 0;
+
+  // Tasks laufen als abgelöste Threads weiter – ohne Destruktoren beenden
+  fflush(stdout);
+  _exit(fails ? 1 : 0);
+}
+#endif
@@ -0,0 +1,145 @@
+// Simulierte OSSM-Firmware für [env:native]: nimmt die JSON-Kommandos der Control-Char
+// entgegen, bewegt eine virtuelle Position und meldet den Zustand per Notification –
+// absichtlich in 20-Byte-Stücken (MTU 23), damit der Parser geteilte Pakete sieht.
+#if defined(NATIVE_SIM)
+#include <Arduino.h>
+#include <sim_hal.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+struct Ossm {
+  int speed = 0, stroke = 50, depth = 50, sensation = 0, pattern = 0;
+  bool streaming = false;
+  float pos = 0.0f;                  // 0..100
+  float moveFrom = 0.0f, moveTo = 0.0f;
+  uint32_t moveT0 = 0, moveMs = 0;
+  bool moving = false;
+  float phase = 0.0f;
+  bool catalogReq = false;           // getPatterns: Antwort im nächsten Takt
+};
+
+// Katalog der simulierten Firmware: Registry-Namen in eigener Reihenfolge plus ein Muster,
+// das die Fernbedienung nicht kennt (Name nur im NVS-Pool, keine Vorschau)
+const char* const kCatalog[] = {
+  "Simple Stroke", "Teasing or Pounding", "Robo Stroke", "Half'n'Half", "Deeper",
+  "Stop'n'Go", "Insist", "Sim Sweep", "Jack Hammer", "Stroke Nibbler",
+};
+constexpr uint32_t kCatalogHash = 3141592653u;
+
+std::mutex s_m;
+Ossm s_o;
+
+constexpr uint32_t kTickMs   = 20;
+constexpr uint32_t kNotifyMs = 100;
+constexpr size_t   kChunk    = 20;
+
+// Zahl hinter "key": innerhalb [p, end)
+bool intAfter(const char* p, const char* end, const char* key, int& out) {
+  const size_t kl = strlen(key);
+  for (const char* q = p; q + kl < end; ++q) {
+    if (memcmp(q, key, kl) != 0) continue;
+    out = atoi(q + kl);
+    return true;
+  }
+  return false;
+}
+
+void applyCommand(const char* p, const char* end) {
+  static const char kAct[] = "\"action\":\"";
+  const char* a = nullptr;
+  for (const char* q = p; q + sizeof(kAct) - 1 < end; ++q)
+    if (memcmp(q, kAct, sizeof(kAct) - 1) == 0) { a = q + sizeof(kAct) - 1; break; }
+  if (!a) return;
+  auto is = [&](const char* name) { const size_t n = strlen(name); return (size_t)(end - a) > n && memcmp(a, name, n) == 0 && a[n] == '"'; };
+  int v;
+  Ossm& o = s_o;
+  if (is("setSpeed") && intAfter(a, end, "\"speed\":", v))              o.speed = v;
+  else if (is("stop"))                                                  o.speed = 0;
+  else if (is("setStroke") && intAfter(a, end, "\"stroke\":", v))       o.stroke = v;
+  else if (is("setDepth") && intAfter(a, end, "\"depth\":", v))         o.depth = v;
+  else if (is("setSensation") && intAfter(a, end, "\"sensation\":", v)) o.sensation = v;
+  else if (is("setPattern") && intAfter(a, end, "\"pattern\":", v))     o.pattern = v;
+  else if (is("startStreaming"))                                        o.streaming = true;
+  else if (is("getPatterns"))                                           o.catalogReq = true;
+  else if (is("home") || is("disable"))                                 { o.speed = 0; o.streaming = false; o.moving = false; }
+  else if (is("move") && intAfter(a, end, "\"position\":", v)) {
+    int ms = 0;
+    intAfter(a, end, "\"time\":", ms);
+    o.moveFrom = o.pos; o.moveTo = (float)v; o.moveT0 = millis(); o.moveMs = ms > 0 ? (uint32_t)ms : 1; o.moving = true;
+  }
+}
+
+// Writes: "[{..},{..}]\n" oder freie Objekte – jedes {...} ist ein Kommando
+void onWrite(const uint8_t* data, size_t len, bool) {
+  std::lock_guard<std::mutex> lk(s_m);
+  const char* s = (const char*)data;
+  const char* end = s + len;
+  for (const char* p = s; p < end; ++p) {
+    if (*p != '{') continue;
+    const char* q = p;
+    while (q < end && *q != '}') ++q;
+    applyCommand(p, q);
+    p = q;
+  }
+}
+
+void firmware() {
+  uint32_t lastNotify = 0;
+  for (;;) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(kTickMs));
+    char msg[512];
+    int n = 0;
+    {
+      std::lock_guard<std::mutex> lk(s_m);
+      Ossm& o = s_o;
+      if (o.catalogReq) {
+        o.catalogReq = false;
+        n = snprintf(msg, sizeof msg, "{\"patterns\":[");
+        for (size_t i = 0; i < sizeof(kCatalog) / sizeof(kCatalog[0]); ++i)
+          n += snprintf(msg + n, sizeof msg - n, "%s{\"idx\":%u,\"name\":\"%s\"}", i ? "," : "", (unsigned)i, kCatalog[i]);
+        n += snprintf(msg + n, sizeof msg - n, "],\"patternsHash\":%u}", (unsigned)kCatalogHash);
+      }
+    }
+    for (int i = 0; i < n; i += (int)kChunk)
+      sim::peerNotify((const uint8_t*)msg + i, std::min<size_t>(kChunk, (size_t)(n - i)));
+    n = 0;
+    {
+      std::lock_guard<std::mutex> lk(s_m);
+      Ossm& o = s_o;
+      const uint32_t now = millis();
+      if (o.moving) {
+        const float t = std::min(1.0f, (now - o.moveT0) / (float)o.moveMs);
+        o.pos = o.moveFrom + (o.moveTo - o.moveFrom) * t;
+        if (t >= 1.0f) o.moving = false;
+      } else if (o.speed > 0) {
+        // Stroke-Engine: Sinus zwischen stroke und depth, bis ~2 Hz bei speed 100
+        o.phase += 2.0f * (float)M_PI * (o.speed / 50.0f) * (kTickMs / 1000.0f);
+        const float lo = (float)std::min(o.stroke, o.depth), hi = (float)std::max(o.stroke, o.depth);
+        o.pos = lo + (hi - lo) * 0.5f * (1.0f - cosf(o.phase));
+      }
+      if (now - lastNotify < kNotifyMs) continue;
+      lastNotify = now;
+      const char* st = o.moving || o.streaming ? "streaming" : (o.speed > 0 ? "strokeEngine.pattern" : "strokeEngine.idle");
+      n = snprintf(msg, sizeof msg,
+                   "{\"state\":\"%s\",\"speed\":%d,\"stroke\":%d,\"sensation\":%d,\"depth\":%d,\"pattern\":%d,\"position\":%d,"
+                   "\"patternsHash\":%u}",
+                   st, o.speed, o.stroke, o.sensation, o.depth, o.pattern, (int)lroundf(o.pos), (unsigned)kCatalogHash);
+    }
+    for (int i = 0; i < n; i += (int)kChunk)
+      sim::peerNotify((const uint8_t*)msg + i, std::min<size_t>(kChunk, (size_t)(n - i)));
+  }
+}
+
+}  // namespace
+
+void simOssmInstall() {
+  sim::peer().onWrite = onWrite;
+  std::thread(firmware).detach();
+}
+#endif
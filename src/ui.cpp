@@ -6,42 +6,34 @@
 #include "app_state.h"   // extern g_spr, g_mode, g_running, g_speed, ...
 #include "geometry.h"    // W,H,CX,CY, R_SPEED_IN/OUT, R_RANGE_IN/OUT, SENS/TOP, CTRL_Y, CTRL_SPACING
 #include "utils.h"       // clampi/clampf, map01/invMap01/lerp, etc.
+#include "raster.h"
+#include "patterns.h"
+#include "pattern_catalog.h"
+#include "display.h"
+#include "perf.h"
+#include "device_state.h"
+#include "glyphs.h"
+#include "bglayer.h"
+#include "palette.h"
+#include "frame_sched.h"
 
 // -------------------- lokale Zeichen-Helper --------------------
+// Ringsegment mit geglätteten Kanten (Scanline-Rasterizer, siehe raster.cpp)
 static void drawArcBandAA(int cx,int cy,int r_in,int r_out,float a0,float a1,uint32_t col){
-  // robust gegen vertauschte Winkel:
-  if (a1 < a0) std::swap(a0, a1);
-  int steps = std::max(12, (int)ceilf(fabs(a1 - a0) / 3.0f));
-  for (int i=0;i<steps;i++) {
-    float t0 = lerp(a0, a1, (float)i/steps);
-    float t1 = lerp(a0, a1, (float)(i+1)/steps);
-    float r0 = t0 * (float)M_PI / 180.0f;
-    float r1 = t1 * (float)M_PI / 180.0f;
-
-    int x0i = cx + (int)roundf(r_in * cosf(r0));
-    int y0i = cy + (int)roundf(r_in * sinf(r0));
-    int x0o = cx + (int)roundf(r_out* cosf(r0));
-    int y0o = cy + (int)roundf(r_out* sinf(r0));
-    int x1o = cx + (int)roundf(r_out* cosf(r1));
-    int y1o = cy + (int)roundf(r_out* sinf(r1));
-    int x1i = cx + (int)roundf(r_in * cosf(r1));
-    int y1i = cy + (int)roundf(r_in * sinf(r1));
-
-    g_spr.fillTriangle(x0i,y0i,x0o,y0o,x1o,y1o,col);
-    g_spr.fillTriangle(x0i,y0i,x1o,y1o,x1i,y1i,col);
-  }
+  PERF_SCOPE(PerfStage::Arcs);
+  rasterArcBand(g_spr, cx, cy, r_in, r_out, a0, a1, col);
 }
 
 
 void drawBattery(int cx,int cy,int pct){
   int w=26,h=12; int x0=cx-w/2,y0=cy-h/2;
-  g_spr.drawRect(x0,y0,w,h,TFT_SILVER);
-  g_spr.fillRect(x0+w, y0+3, 3, h-6, TFT_SILVER);
+  g_spr.drawRect(x0,y0,w,h,uiCol(Pal::Silver));
+  g_spr.fillRect(x0+w, y0+3, 3, h-6, uiCol(Pal::Silver));
   int bars = (pct+12)/25; // 0..4
   int bar_w = (w-6)/4; int by=y0+2; int bh=h-4;
   for(int i=0;i<4;i++){
     int bx = x0+3+i*bar_w;
-    uint32_t col = (i<bars)? TFT_GREEN : g_spr.color888(50,50,50);
+    uint32_t col = (i<bars)? uiCol(Pal::Green) : uiCol(Pal::Dim);
     g_spr.fillRect(bx,by,bar_w-2,bh,col);
   }
 }
@@ -54,209 +46,433 @@ static void drawHandle(int cx,int cy,int r,float ang,uint32_t col,int rad=6){
 }
 
 // -------------------- UI-Teilbereiche --------------------
+// Labels: in Stack-Puffer formatiert, Glyphen aus dem Atlas (glyphs.h)
 static void drawLabels(){
+  PERF_SCOPE(PerfStage::Text);
   auto& d = g_spr;
-  d.setTextDatum(textdatum_t::middle_center);
-  d.setFont(&fonts::Font2);
+  char buf[16];
 
   // Speed-Label
-  d.setTextColor(d.color888(200,220,255));
-  d.drawString(String("Speed ")+g_speed+"%", CX, CY - 54);
+  fmtStr(fmtInt(fmtStr(buf, "Speed "), g_speed), "%");
+  glyphDraw(d, GlyphFont::Normal, buf, CX, CY - 54, uiCol(Pal::SpeedLabel));
 
   // Stroke/Depth %-Werte an den ENDEN des Gesamt-Sliders (nicht mitlaufend)
-  d.setTextColor(d.color888(180,255,180));
-  d.drawString(String(g_stroke)+"%", CX - 70, CY - 10);
-  d.drawString(String(g_depth) +"%", CX + 70, CY - 10);
+  fmtStr(fmtInt(buf, g_stroke), "%");
+  glyphDraw(d, GlyphFont::Normal, buf, CX - 70, CY - 10, uiCol(Pal::RangeLabel));
+  fmtStr(fmtInt(buf, g_depth), "%");
+  glyphDraw(d, GlyphFont::Normal, buf, CX + 70, CY - 10, uiCol(Pal::RangeLabel));
 
   // Sensation/Position Anzeige
-  d.setTextColor(TFT_WHITE);
   const int sv = (g_mode==Mode::POSITION) ? g_position : g_sensation;
-  d.drawString(String((g_mode==Mode::POSITION) ? "Pos " : "Sens ") + String(sv), CX, CY + 80);
+  fmtInt(fmtStr(buf, (g_mode==Mode::POSITION) ? "Pos " : "Sens "), sv);
+  glyphDraw(d, GlyphFont::Normal, buf, CX, CY + 80, uiCol(Pal::White));
 }
 
+// Kreise und −/+ liegen in der Hintergrundebene, hier nur das Play/Pause-Symbol
 static void drawControls(){
   auto& d = g_spr;
-  //int y = CTRL_Y;
   int y = BUTTONS_Y;
+  int cx_play = CX;
 
-  int cx_play  = CX;
-  int cx_minus = CX - CTRL_SPACING;
-  int cx_plus  = CX + CTRL_SPACING;
-
-  uint32_t colBg = d.color888(30,30,30);
-
-  // minus
-  d.fillCircle(cx_minus, y, 18, colBg);
-  d.fillRect  (cx_minus - 10, y - 3, 20, 6, TFT_WHITE);
-
-  // play/pause
-  d.fillCircle(cx_play, y, 22, colBg);
   if (g_running) {
-    d.fillRect(cx_play - 8, y - 12, 6, 24, TFT_WHITE);
-    d.fillRect(cx_play + 2, y - 12, 6, 24, TFT_WHITE);
+    d.fillRect(cx_play - 8, y - 12, 6, 24, uiCol(Pal::White));
+    d.fillRect(cx_play + 2, y - 12, 6, 24, uiCol(Pal::White));
   } else {
-    d.fillTriangle(cx_play - 8, y - 14, cx_play - 8, y + 14, cx_play + 14, y, TFT_WHITE);
+    d.fillTriangle(cx_play - 8, y - 14, cx_play - 8, y + 14, cx_play + 14, y, uiCol(Pal::White));
   }
-
-  // plus
-  d.fillCircle(cx_plus, y, 18, colBg);
-  d.fillRect  (cx_plus - 10, y - 3, 20, 6, TFT_WHITE);
-  d.fillRect  (cx_plus - 3,  y - 10, 6, 20, TFT_WHITE);
 }
 
 static void drawPatternPill(){
   auto& d = g_spr;
-  // d.fillRoundRect(CX - 60, CY - 36, 120, 22, 10, d.color888(40,40,40)); // oben-ish
-  // d.drawString(g_patterns[g_patternIndex], CX, CY - 25);
-
-  d.fillRoundRect(CX - 60, CTRL_Y - 12, 120, 24, 12, d.color888(40,40,40)); // unten
-  d.setTextDatum(textdatum_t::middle_center);
-  d.setFont(&fonts::Font2);
-  d.setTextColor(TFT_WHITE);
-  d.drawString(g_patterns[g_patternIndex], CX, CTRL_Y);                      // unten
+  // d.fillRoundRect(CX - 60, CY - 36, 120, 22, 10, uiCol(Pal::Pill)); // oben-ish
+  // d.drawString(patternName(g_patternIndex), CX, CY - 25);
+
+  PERF_SCOPE(PerfStage::Text);
+  glyphDraw(d, GlyphFont::Normal, catalogName(g_patternIndex), CX, CTRL_Y, uiCol(Pal::White));   // unten
+}
+
+// Verbindungsaufbau: Phase als Text + Schrittpunkte unter der Pattern-Pill (verbunden: leer)
+static void drawLinkStatus(BleLinkPhase ph){
+  if (ph == BLE_LINK_READY) return;
+  auto& d = g_spr;
+  static const char* const kText[] = { "getrennt", "suche OSSM", "verbinde", "Dienste", "Notify", "" };
+  const int step = (int)ph - (int)BLE_LINK_SCANNING;   // 0..3
+  PERF_SCOPE(PerfStage::Text);
+  glyphDraw(d, GlyphFont::Small, kText[ph], CX - 14, CY + 58, uiCol(Pal::LinkText));
+  for (int i=0;i<4;i++){
+    const uint32_t col = (i <= step) ? uiCol(Pal::Accent) : uiCol(Pal::Dim);
+    d.fillCircle(CX + 26 + i*7, CY + 58, 2, col);
+  }
 }
 
 // Sichtbarkeitsflags & Scroll kommen aus app_state.h:
 // extern bool g_showSettings, g_showPatternPicker;
 // extern int  g_pickerScroll; // px-Scrolloffset
-// extern std::vector<String> g_patterns;
 // extern int g_patternIndex;
 
 static void drawSettingsOverlay(){
   if (!g_showSettings) return;
   auto& d=g_spr;
-  d.fillRoundRect(CX-86, CY-64, 172, 128, 16, d.color888(25,25,25));
-  d.drawRoundRect(CX-86, CY-64, 172, 128, 16, d.color888(80,80,80));
-  d.setTextDatum(textdatum_t::middle_center); d.setFont(&fonts::Font2);
+  d.fillRoundRect(CX-86, CY-64, 172, 128, 16, uiCol(Pal::Panel));
+  d.drawRoundRect(CX-86, CY-64, 172, 128, 16, uiCol(Pal::Frame));
 
   struct Btn{const char* label; uint32_t col; int y;};
-  Btn btns[4]={{ble_is_connected() ? "Connected" : "DisConnected", d.color888(0,180,255), CY-34},
-      { g_running   ? "Stop"    : "Start",     d.color888(255,120,120), CY-2},
-      { "Home",                                   d.color888(180,255,180), CY+30},
-      { "Disable",                                d.color888(220,220,220), CY+62}
+  Btn btns[4]={{ble_is_connected() ? "Connected" : "DisConnected", uiCol(Pal::Accent), CY-34},
+      { g_running   ? "Stop"    : "Start",     uiCol(Pal::Stop), CY-2},
+      { "Home",                                   uiCol(Pal::RangeLabel), CY+30},
+      { "Disable",                                uiCol(Pal::Light), CY+62}
   };
   for (auto &b:btns){
-    d.drawRoundRect(CX-70,b.y-12,140,24,10,d.color888(90,90,90));
-    d.setTextColor(b.col);
-    d.drawString(b.label, CX, b.y);
+    d.drawRoundRect(CX-70,b.y-12,140,24,10,uiCol(Pal::BtnFrame));
+    glyphDraw(d, GlyphFont::Normal, b.label, CX, b.y, b.col);
   }
 }
 
 static void drawPatternPicker(){
   if (!g_showPatternPicker) return;
   auto& d=g_spr;
-  d.fillRoundRect(CX-104, CY-78, 208, 156, 16, d.color888(25,25,25));
-  d.drawRoundRect (CX-104, CY-78, 208, 156, 16, d.color888(80,80,80));
-  d.setTextDatum(textdatum_t::middle_center);
-  d.setTextColor(TFT_WHITE);
-  d.setFont(&fonts::Font2);
+  d.fillRoundRect(CX-104, CY-78, 208, 156, 16, uiCol(Pal::Panel));
+  d.drawRoundRect (CX-104, CY-78, 208, 156, 16, uiCol(Pal::Frame));
 
   int listTop = CY-60 - g_pickerScroll;
-  for (int i=0;i<(int)g_patterns.size();++i){
+  // nur die sichtbaren Zeilen brauchen ihren Namen im RAM (pattern_catalog.h)
+  const int first = std::max(0, (CY-78 - 28 - listTop) / 34);
+  catalogSetWindow(first, 156/34 + 2);
+  for (int i=first;i<catalogCount();++i){
     int y = listTop + i*34;
-    uint32_t fill = (i==g_patternIndex)? d.color888(40,40,70) : d.color888(40,40,40);
+    if (y > CY+78) break;                // Rest liegt unterhalb des Pickers
+    if (y + 28 < CY-78) continue;        // oberhalb (Rundung von first)
+    uint32_t fill = (i==g_patternIndex)? uiCol(Pal::PillSel) : uiCol(Pal::Pill);
     d.fillRoundRect(CX-96, y, 192, 28, 8, fill);
-    d.drawRoundRect(CX-96, y, 192, 28, 8, d.color888(80,80,80));
-
-    // Mini-Preview (wie vorher)
-    int px0=CX-90, py0=y+5, px1=px0+80, py1=y+23;
-    int prevN = 60; int lastx=px0, lasty=py0+(py1-py0)/2;
-    for (int k=0;k<prevN;k++){
-      float t=(float)k/(prevN-1);
-      float v=0.5f;
-      const String &nm=g_patterns[i];
-      if      (nm.indexOf("Simple")  >=0) v = 0.5f + 0.45f * sinf(2*M_PI*t);
-      else if (nm.indexOf("Teasing") >=0) v = 0.5f + 0.45f * powf(sinf(2*M_PI*t),3);
-      else if (nm.indexOf("Robo")    >=0) v = 1.0f - fabsf(fmodf(t*2.0f,2.0f)-1.0f);
-      else if (nm.indexOf("Half")    >=0) v = 0.5f + (((int)floorf(t*2)%2)? 0.25f:0.45f) * sinf(2*M_PI*fmodf(t*2,1.0f));
-      else if (nm.indexOf("Deeper")  >=0) { float a = (floorf(t*4)+1)/4.0f; v = 0.5f + 0.45f*a*sinf(2*M_PI*fmodf(t*4,1.0f)); }
-      else if (nm.indexOf("Stop")    >=0) { float loc=fmodf(t*3,1.0f); v = (loc<0.7f)? 0.5f + 0.45f*sinf(2*M_PI*loc/0.7f) : 0.5f; }
-      else if (nm.indexOf("Insist")  >=0) v = 0.5f + 0.15f*sinf(2*M_PI*t) + 0.25f*sinf(4*M_PI*t);
-      else if (nm.indexOf("Jack")    >=0) v = (t<0.6f)? 0.5f + 0.35f*sinf(20*M_PI*t) : 1.0f - (t-0.6f)/0.4f;
-      else if (nm.indexOf("Nibbler") >=0) v = 0.5f + 0.2f*sinf(10*M_PI*t);
-      int x=px0 + (int)roundf(t*(px1-px0));
-      int yv=py1 - (int)roundf(v*(py1-py0));
-      d.drawLine(lastx,lasty,x,yv, d.color888(180,200,255));
-      lastx=x; lasty=yv;
-    }
-    d.setTextColor(TFT_WHITE);
-    d.drawString(g_patterns[i], CX-96+96, y+14);
+    d.drawRoundRect(CX-96, y, 192, 28, 8, uiCol(Pal::Frame));
+
+    // Mini-Preview: beim Start gerastert (patterns.cpp), hier nur noch Blit
+    if (const uint8_t* prev = catalogPreview(i))   // Muster ohne lokalen Generator: ohne Vorschau
+      d.drawBitmap(CX-90, y+5, prev, kPreviewW, kPreviewH, uiCol(Pal::Preview));
+    glyphDraw(d, GlyphFont::Normal, catalogName(i), CX-96+96, y+14, uiCol(Pal::White));
   }
 }
-void initUI(){
-  uint32_t now = millis();
-  s_uiNextMs  = now + s_uiIntervalMs;
-  needsRedraw;
-}
-// -------------------- Haupt-Draw --------------------
-void drawUI(){
-  uint32_t now = millis();
-  // Wenn Gate noch zu, direkt raus – egal ob needsRedraw true ist.
-  if (!needsRedraw) return;
-  if ((int32_t)(now - s_uiNextMs) < 0) return;
-  s_uiNextMs  = now + s_uiIntervalMs;
-  needsRedraw = false;
-
-  auto& d = g_spr;
+// -------------------- Widgets: Ringe --------------------
+// Sens/Pos-Bogen ist etwas nach innen gesetzt (Touch nutzt R_SENS_IN/OUT)
+static const int SENS_IN  = R_SPEED_IN  - 8;
+static const int SENS_OUT = R_SPEED_OUT - 8;
+static const float SENS_MID = 90.0f;
 
-  // Hintergrund (Sprite ist in setup bereits erstellt/konfiguriert)
-  d.fillSprite(TFT_BLACK);
+// vom Gerät gemeldete Ist-Position (−1 = unbekannt), Stand des aktuellen Frames
+static int s_devPos = -1;
+static BleLinkPhase s_link = BLE_LINK_IDLE;
 
-  // Speed (oberer Halbkreis – dünner Ring)
-  drawArcBandAA(CX, CY, R_SPEED_IN, R_SPEED_OUT, TOP_START, TOP_END, d.color888(30,30,30));
+static void drawSpeedRing(){
   float speed_end = map01(g_speed/100.0f, TOP_START, TOP_END);
   drawArcBandAA(CX, CY, R_SPEED_IN, R_SPEED_OUT, TOP_START, speed_end,
-                (g_mode==Mode::POSITION) ? d.color888(60,80,100) : d.color888(0,180,255));
+                (g_mode==Mode::POSITION) ? uiCol(Pal::SpeedPos) : uiCol(Pal::Accent));
   drawHandle(CX, CY, (R_SPEED_IN + R_SPEED_OUT)/2, speed_end,
-             (g_mode==Mode::POSITION) ? d.color888(120,140,160) : d.color888(0,180,255),
+             (g_mode==Mode::POSITION) ? uiCol(Pal::SpeedPosHandle) : uiCol(Pal::Accent),
              5);
+}
 
-  // Stroke/Depth (oberer Halbkreis – dicker Ring, direkt anschließend)
-  drawArcBandAA(CX, CY, R_RANGE_IN, R_RANGE_OUT, TOP_START, TOP_END, d.color888(28,28,28));
+static void drawRangeRing(){
   float a0 = map01(g_stroke/100.0f, TOP_START, TOP_END);
   float a1 = map01(g_depth /100.0f, TOP_START, TOP_END);
   if (a1 < a0) std::swap(a0, a1);
-  drawArcBandAA(CX, CY, R_RANGE_IN, R_RANGE_OUT, a0, a1, d.color888(120,255,120));
-  drawHandle(CX, CY, (R_RANGE_IN + R_RANGE_OUT)/2, a0, d.color888(120,255,120), 7);
-  drawHandle(CX, CY, (R_RANGE_IN + R_RANGE_OUT)/2, a1, d.color888(120,255,120), 7);
-
-  // Sensation/Position (unterer 150°-Bogen, etwas nach innen gesetzt)
-  const int SENS_IN  = R_SPEED_IN  - 8;
-  const int SENS_OUT = R_SPEED_OUT - 8;
-  drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, SENS_START, SENS_END, d.color888(30,30,30));
-  float mid = 90.0f;
+  drawArcBandAA(CX, CY, R_RANGE_IN, R_RANGE_OUT, a0, a1, uiCol(Pal::Range));
+  drawHandle(CX, CY, (R_RANGE_IN + R_RANGE_OUT)/2, a0, uiCol(Pal::Range), 7);
+  drawHandle(CX, CY, (R_RANGE_IN + R_RANGE_OUT)/2, a1, uiCol(Pal::Range), 7);
+}
+
+static float sensAngle(Mode mode, int sensation, int position){
+  if (mode==Mode::POSITION) return map01(position/100.0f, SENS_START, SENS_END);
+  if (sensation >= 0)       return map01((100 - sensation)/100.0f, SENS_START, SENS_MID);
+  return map01(fabsf(sensation)/100.0f, SENS_MID, SENS_END);
+}
+
+static void drawSensRing(){
+  const float mid = SENS_MID;
+  const float ang = sensAngle(g_mode, g_sensation, g_position);
   if (g_mode==Mode::POSITION) {
-    float ang = map01(g_position/100.0f, SENS_START, SENS_END);
-    drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, (ang>=mid? mid : ang), (ang>=mid? ang : mid), TFT_WHITE);
-    drawHandle(CX, CY, (SENS_IN + SENS_OUT)/2, ang, TFT_WHITE, 9);
+    drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, (ang>=mid? mid : ang), (ang>=mid? ang : mid), uiCol(Pal::White));
+    // Ist-Position unter den Soll-Griff: deckungsgleich = Ziel erreicht
+    if (s_devPos >= 0)
+      drawHandle(CX, CY, (SENS_IN + SENS_OUT)/2, sensAngle(Mode::POSITION, 0, s_devPos), uiCol(Pal::DevPos), 5);
+    drawHandle(CX, CY, (SENS_IN + SENS_OUT)/2, ang, uiCol(Pal::White), 9);
+  } else if (g_sensation >= 0) {
+    drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, ang, mid, uiCol(Pal::SensPos));
+    drawHandle(CX, CY, (SENS_IN + SENS_OUT)/2, ang, uiCol(Pal::SensHandle), 9);
   } else {
-    if (g_sensation >= 0) {
-      float ang = map01((100 - g_sensation)/100.0f, SENS_START, mid);
-      drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, ang, mid, d.color888(255,200,0));
-      drawHandle(CX, CY, (SENS_IN + SENS_OUT)/2, ang, d.color888(255,230,150), 9);
-    } else {
-      float ang = map01(fabsf(g_sensation)/100.0f, mid, SENS_END);
-      drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, mid, ang, d.color888(255,120,0));
-      drawHandle(CX, CY, (SENS_IN + SENS_OUT)/2, ang, d.color888(255,230,150), 9);
+    drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, mid, ang, uiCol(Pal::SensNeg));
+    drawHandle(CX, CY, (SENS_IN + SENS_OUT)/2, ang, uiCol(Pal::SensHandle), 9);
+  }
+}
+
+// -------------------- Damage-Tracking --------------------
+// Alles, wovon das Bild abhängt. Ein Widget ist "dirty", wenn sich sein Teil ändert.
+struct UiSnap {
+  Mode mode; bool running;
+  int speed, stroke, depth, sensation, position, pattern;
+  bool settings, picker; int pickerScroll; bool connected;
+  uint32_t perfVer;
+  int devPos;      // Ist-Position vom Gerät (nur im POSITION-Mode, sonst −1)
+  BleLinkPhase link;
+};
+
+static UiSnap takeSnap(){
+  const DeviceState dev = deviceStateGet();
+  const int devPos = (g_mode==Mode::POSITION && dev.has(DevPosition)) ? clampi(dev.val[DevPosition], 0, 100) : -1;
+  return UiSnap{ g_mode, g_running, g_speed, g_stroke, g_depth, g_sensation, g_position, g_patternIndex,
+                 g_showSettings, g_showPatternPicker, g_pickerScroll, ble_is_connected(),
+                 perfOverlayVersion(), devPos, ble_link_phase() };
+}
+
+// Bounding-Box eines Ringsektors [a0..a1] (Grad, 0°=rechts, 90°=unten) plus Rand
+static Rect sectorBox(int r_in, int r_out, float a0, float a1, int pad){
+  if (a1 < a0) std::swap(a0, a1);
+  float xmin=1e9f, xmax=-1e9f, ymin=1e9f, ymax=-1e9f;
+  auto add = [&](float r, float a){
+    float rad = a * (float)M_PI / 180.0f;
+    float x = CX + r*cosf(rad), y = CY + r*sinf(rad);
+    xmin = std::min(xmin, x); xmax = std::max(xmax, x);
+    ymin = std::min(ymin, y); ymax = std::max(ymax, y);
+  };
+  add(r_in, a0); add(r_out, a0); add(r_in, a1); add(r_out, a1);
+  for (float q = ceilf(a0/90.0f)*90.0f; q < a1; q += 90.0f) add(r_out, q);   // Achsen-Extrema
+  Rect r = makeRect((int)floorf(xmin)-pad, (int)floorf(ymin)-pad, (int)ceilf(xmax)+pad+1, (int)ceilf(ymax)+pad+1);
+  return rectIntersect(r, makeRect(0,0,W,H));
+}
+
+static Rect boxAt(int cx, int cy, int w, int h){ return makeRect(cx - w/2, cy - h/2, cx + (w+1)/2, cy + (h+1)/2); }
+
+// feste Bereiche der Widgets
+static Rect speedRingBox()  { return sectorBox(R_SPEED_IN, R_SPEED_OUT, TOP_START, TOP_END, 6); }
+static Rect rangeRingBox()  { return sectorBox(R_RANGE_IN, R_RANGE_OUT, TOP_START, TOP_END, 8); }
+static Rect sensRingBox()   { return sectorBox(SENS_IN, SENS_OUT, SENS_START, SENS_END, 10); }
+static Rect speedLabelBox() { return boxAt(CX, CY - 54, 100, 20); }
+static Rect strokeLabelBox(){ return boxAt(CX - 70, CY - 10, 44, 20); }
+static Rect depthLabelBox() { return boxAt(CX + 70, CY - 10, 44, 20); }
+static Rect sensLabelBox()  { return boxAt(CX, CY + 80, 90, 20); }
+static Rect controlsBox()   { return makeRect(CX - CTRL_SPACING - 19, BUTTONS_Y - 23, CX + CTRL_SPACING + 20, BUTTONS_Y + 24); }
+static Rect playBox()       { return boxAt(CX, BUTTONS_Y, 48, 48); }
+static Rect pillBox()       { return makeRect(CX - 60, CTRL_Y - 12, CX + 60, CTRL_Y + 12); }
+static Rect settingsBox()   { return makeRect(CX - 86, CY - 64, CX + 86, CY + 64); }
+static Rect pickerBox()     { return makeRect(CX - 104, CY - 78, CX + 104, CY + 78); }
+static Rect perfBox()       { return boxAt(CX, 30, 120, 16); }
+static Rect linkBox()       { return boxAt(CX, CY + 58, 110, 12); }
+
+// -------------------- Hintergrundebene --------------------
+// Alles, was sich nie ändert: Ringspuren, Button-Kreise mit −/+, Pill-Fläche. Wird einmal
+// gezeichnet und in bglayer gemerkt; die Wert-Ebene (Bögen, Griffe, Texte) blendet darüber.
+static void drawStaticLayer(const Rect& clip){
+  auto& d = g_spr;
+  if (rectOverlaps(clip, speedRingBox()))
+    drawArcBandAA(CX, CY, R_SPEED_IN, R_SPEED_OUT, TOP_START, TOP_END, uiCol(Pal::Track));
+  if (rectOverlaps(clip, rangeRingBox()))
+    drawArcBandAA(CX, CY, R_RANGE_IN, R_RANGE_OUT, TOP_START, TOP_END, uiCol(Pal::TrackRange));
+  if (rectOverlaps(clip, sensRingBox()))
+    drawArcBandAA(CX, CY, SENS_IN, SENS_OUT, SENS_START, SENS_END, uiCol(Pal::Track));
+
+  if (rectOverlaps(clip, controlsBox())) {
+    const int y = BUTTONS_Y;
+    const int cx_minus = CX - CTRL_SPACING, cx_plus = CX + CTRL_SPACING;
+    const uint32_t colBg = uiCol(Pal::Track);
+    d.fillCircle(cx_minus, y, 18, colBg);
+    d.fillRect  (cx_minus - 10, y - 3, 20, 6, uiCol(Pal::White));
+    d.fillCircle(CX, y, 22, colBg);
+    d.fillCircle(cx_plus, y, 18, colBg);
+    d.fillRect  (cx_plus - 10, y - 3, 20, 6, uiCol(Pal::White));
+    d.fillRect  (cx_plus - 3,  y - 10, 6, 20, uiCol(Pal::White));
+  }
+  if (rectOverlaps(clip, pillBox()))
+    d.fillRoundRect(CX - 60, CTRL_Y - 12, 120, 24, 12, uiCol(Pal::Pill));
+}
+
+// Vollbild der Hintergrundebene in den Backbuffer und in den Cache
+static bool s_bgStale = true;
+
+static void renderBackground(){
+  auto& d = g_spr;
+  d.clearClipRect();
+  d.fillRect(0, 0, W, H, uiCol(Pal::Black));
+  drawStaticLayer(makeRect(0, 0, W, H));
+  bgLayerCapture(d);
+  s_bgStale = false;
+}
+
+static const int kMaxDamage = 6;
+struct DamageList {
+  Rect r[kMaxDamage];
+  int  n = 0;
+  void add(const Rect& in){
+    Rect a = rectIntersect(in, makeRect(0,0,W,H));
+    if (a.empty()) return;
+    // mit überlappendem Rechteck verschmelzen (wiederholt, da Union wachsen kann)
+    for (int i=0;i<n;i++){
+      if (rectOverlaps(r[i], a)) { a = rectUnion(a, r[i]); r[i] = r[--n]; i = -1; }
+    }
+    if (n < kMaxDamage) { r[n++] = a; return; }
+    // voll: mit dem Rechteck verschmelzen, das am wenigsten wächst
+    int best = 0, bestGrow = 1<<30;
+    for (int i=0;i<n;i++){
+      int grow = rectUnion(r[i], a).area() - r[i].area();
+      if (grow < bestGrow) { bestGrow = grow; best = i; }
+    }
+    r[best] = rectUnion(r[best], a);
+  }
+  void all(){ n = 0; add(makeRect(0,0,W,H)); }
+};
+
+static void collectDamage(const UiSnap& o, const UiSnap& n, DamageList& dl){
+  const bool modeChg = o.mode != n.mode;
+
+  // Speed-Ring: nur der Sektor zwischen altem und neuem Wert (+Griff), bei Moduswechsel ganz (Farben)
+  if (modeChg) dl.add(speedRingBox());
+  else if (o.speed != n.speed)
+    dl.add(sectorBox(R_SPEED_IN, R_SPEED_OUT, map01(o.speed/100.0f, TOP_START, TOP_END),
+                     map01(n.speed/100.0f, TOP_START, TOP_END), 6));
+
+  if (o.stroke != n.stroke)
+    dl.add(sectorBox(R_RANGE_IN, R_RANGE_OUT, map01(o.stroke/100.0f, TOP_START, TOP_END),
+                     map01(n.stroke/100.0f, TOP_START, TOP_END), 8));
+  if (o.depth != n.depth)
+    dl.add(sectorBox(R_RANGE_IN, R_RANGE_OUT, map01(o.depth/100.0f, TOP_START, TOP_END),
+                     map01(n.depth/100.0f, TOP_START, TOP_END), 8));
+
+  if (modeChg) dl.add(sensRingBox());
+  else {
+    const float ao = sensAngle(o.mode, o.sensation, o.position);
+    const float an = sensAngle(n.mode, n.sensation, n.position);
+    if (ao != an) dl.add(sectorBox(SENS_IN, SENS_OUT, ao, an, 10));
+    if (o.devPos != n.devPos) {
+      // Marker verschwindet/erscheint: nur dessen Stelle, sonst alte bis neue Lage
+      const float po = sensAngle(Mode::POSITION, 0, o.devPos < 0 ? n.devPos : o.devPos);
+      const float pn = sensAngle(Mode::POSITION, 0, n.devPos < 0 ? o.devPos : n.devPos);
+      dl.add(sectorBox(SENS_IN, SENS_OUT, po, pn, 10));
     }
   }
 
+  if (o.speed != n.speed)   dl.add(speedLabelBox());
+  if (o.stroke != n.stroke) dl.add(strokeLabelBox());
+  if (o.depth != n.depth)   dl.add(depthLabelBox());
+  const int svo = (o.mode==Mode::POSITION) ? o.position : o.sensation;
+  const int svn = (n.mode==Mode::POSITION) ? n.position : n.sensation;
+  if (modeChg || svo != svn) dl.add(sensLabelBox());
+
+  if (o.running != n.running) dl.add(playBox());
+  if (o.pattern != n.pattern) dl.add(pillBox());
+
+  if (o.settings != n.settings || (n.settings && (o.connected != n.connected || o.running != n.running)))
+    dl.add(settingsBox());
+  if (o.picker != n.picker || (n.picker && (o.pickerScroll != n.pickerScroll || o.pattern != n.pattern)))
+    dl.add(pickerBox());
+  if (PERF_OVERLAY && o.perfVer != n.perfVer) dl.add(perfBox());
+  if (o.link != n.link) dl.add(linkBox());
+}
+
+// Wert-Ebene: alle Widgets, die den (bereits gesetzten) Clip-Bereich berühren
+static void drawValueLayer(const Rect& clip){
+  if (rectOverlaps(clip, speedRingBox())) drawSpeedRing();
+  if (rectOverlaps(clip, rangeRingBox())) drawRangeRing();
+  if (rectOverlaps(clip, sensRingBox()))  drawSensRing();
+
   // Labels / Controls / Pattern-Pill
-  drawLabels();
-  drawControls();
-  drawPatternPill();
-
-  // Overlays zuletzt zeichnen:
-  drawSettingsOverlay();
-  drawPatternPicker();
-
-    // 🔋 Battery rechts oben (x ≈ W-22, y ≈ 16)
-  int pct = 0;
-  #if defined(M5UNIFIED_H) || defined(ARDUINO_M5STACK_CoreS3) || defined(ARDUINO_M5STACK_DIAL)
-    pct = M5.Power.getBatteryLevel(); // 0..100 (M5Unified)
-  #endif
-  //drawBattery(W - 22, 16, pct);
-
-  // Ausgabe
-  d.pushSprite(0, 0);
+  if (rectOverlaps(clip, speedLabelBox()) || rectOverlaps(clip, strokeLabelBox()) ||
+      rectOverlaps(clip, depthLabelBox()) || rectOverlaps(clip, sensLabelBox()))
+    drawLabels();
+  if (rectOverlaps(clip, controlsBox())) drawControls();
+  if (rectOverlaps(clip, pillBox()))     drawPatternPill();
+  if (rectOverlaps(clip, linkBox()))     drawLinkStatus(s_link);
+}
+
+// Overlay-Ebene: Dialoge und Perf-Zeile über allem
+static void drawOverlayLayer(const Rect& clip){
+  if (rectOverlaps(clip, settingsBox())) drawSettingsOverlay();
+  if (rectOverlaps(clip, pickerBox())) {
+    // Listeneinträge laufen beim Scrollen über den Rahmen hinaus → auf den Picker clippen
+    const Rect c = rectIntersect(clip, pickerBox());
+    g_spr.setClipRect(c.x, c.y, c.w, c.h);
+    drawPatternPicker();
+    g_spr.setClipRect(clip.x, clip.y, clip.w, clip.h);
+  }
+
+#if PERF_OVERLAY
+  if (rectOverlaps(clip, perfBox())) {
+    char line[48];
+    perfOverlayText(line, sizeof(line));
+    glyphDraw(g_spr, GlyphFont::Small, line, CX, 30, uiCol(Pal::PerfText));
+  }
+#endif
+}
+
+static UiSnap     s_lastSnap;
+static bool       s_fullRedraw = true;
+static uint32_t   s_lastDevSeq = 0;
+static BleLinkPhase s_lastLink = BLE_LINK_IDLE;
+static UiFrameStats s_frameStats = {};
+
+void uiInvalidateAll(){ s_fullRedraw = true; needsRedraw = true; }
+void uiInvalidateBackground(){ s_bgStale = true; uiInvalidateAll(); }
+UiFrameStats uiFrameStats(){ return s_frameStats; }
+
+void initUI(){
+  patternsInit();
+  catalogInit();
+  glyphsInit();
+  uiInvalidateAll();
+}
+// -------------------- Haupt-Draw --------------------
+void drawUI(){
+  uint32_t now = millis();
+  // neue Gerätemeldung → Snapshot vergleichen (gezeichnet wird nur, was sich daran ändert)
+  const uint32_t devSeq = deviceStateSeq();
+  if (devSeq != s_lastDevSeq) { s_lastDevSeq = devSeq; needsRedraw = true; }
+  const BleLinkPhase link = ble_link_phase();
+  if (link != s_lastLink) { s_lastLink = link; needsRedraw = true; }
+  // Wenn Gate noch zu, direkt raus – egal ob needsRedraw true ist.
+  if (!needsRedraw) return;
+  if (!frameSchedDue(now)) return;   // Intervall nach Interaktion/Kosten (frame_sched.h)
+  needsRedraw = false;
+
+  const UiSnap snap = takeSnap();
+  DamageList dl;
+  if (s_fullRedraw) dl.all();
+  else collectDamage(s_lastSnap, snap, dl);
+  s_lastSnap   = snap;
+  s_fullRedraw = false;
+  s_devPos     = snap.devPos;
+  s_link       = snap.link;
+  if (dl.n == 0) { frameSchedCancel(); return; }
+
+  const uint32_t t0 = micros();
+  auto& d = g_spr;
+  uint32_t pixels = 0;
+
+  displayBeginFrame();   // Backbuffer vorbereiten – der Frontbuffer läuft ggf. noch per DMA
+  if (s_bgStale) { renderBackground(); dl.all(); }
+  const bool bgCached = bgLayerReady();
+  for (int i=0;i<dl.n;i++){
+    const Rect& r = dl.r[i];
+    // Nur das Rechteck neu aufbauen: Hintergrund kopieren, darüber Werte und Overlays (geclippt)
+    d.setClipRect(r.x, r.y, r.w, r.h);
+    if (bgCached) bgLayerBlit(d, r);
+    else {
+      d.fillRect(r.x, r.y, r.w, r.h, uiCol(Pal::Black));   // ohne Cache: statische Teile neu zeichnen
+      drawStaticLayer(r);
+    }
+    drawValueLayer(r);
+    drawOverlayLayer(r);
+    d.clearClipRect();
+    pixels += r.area();
+  }
+  displayPresent(dl.r, dl.n);
+
+  const DisplayStats ds = displayStats();
+  s_frameStats.frameUs   = micros() - t0;
+  s_frameStats.renderUs  = ds.renderUs;
+  s_frameStats.pushUs    = ds.pushUs + ds.waitUs;
+  s_frameStats.spiBytes  = pixels * 2;   // RGB565
+  s_frameStats.rects     = (uint8_t)dl.n;
+  s_frameStats.frames++;
+  frameSchedFrameDone(millis(), s_frameStats.frameUs);
+
+  perfRecord(PerfStage::Render, ds.renderUs);
+  perfRecord(PerfStage::Push, ds.pushUs + ds.waitUs);
+  perfFlushFrame();
 }
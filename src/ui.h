@@ -1,5 +1,19 @@
 #pragma once
+#include <stdint.h>
+
+// Kennzahlen des letzten gezeichneten Frames
+struct UiFrameStats {
+  uint32_t frameUs;    // Zeichnen + Push
+  uint32_t renderUs;   // nur Zeichnen in den Backbuffer
+  uint32_t pushUs;     // Push-Start + Warten auf den vorigen DMA-Transfer
+  uint32_t spiBytes;   // übertragene Pixelbytes
+  uint8_t  rects;      // Anzahl Dirty-Rects
+  uint32_t frames;     // gezeichnete Frames seit Boot
+};
 
 // Öffentliche UI-Funktionen
 void initUI();
 void drawUI();
+void uiInvalidateAll();          // nächster Frame zeichnet alles neu
+void uiInvalidateBackground();   // Hintergrundebene neu aufbauen (Geometrie/Farben geändert)
+UiFrameStats uiFrameStats();
@@ -1,5 +1,6 @@
 #pragma once
 #include <math.h>
+#include <stdint.h>
 #include "geometry.h"  // liefert CX, CY
 
 // --- clamps ---
@@ -36,3 +37,27 @@ inline bool inAnnulus(int x,int y,int r_in,int r_out){
   int r2 = dx*dx + dy*dy;
   return (r2 >= r_in*r_in) && (r2 <= r_out*r_out);
 }
+
+// --- Rechtecke (Dirty-Rects, Clipping) ---
+struct Rect {
+  int16_t x = 0, y = 0, w = 0, h = 0;
+  bool empty() const { return w <= 0 || h <= 0; }
+  int  area()  const { return empty() ? 0 : (int)w * h; }
+};
+inline Rect makeRect(int x0, int y0, int x1, int y1) {   // x1/y1 exklusiv
+  Rect r; r.x = (int16_t)x0; r.y = (int16_t)y0; r.w = (int16_t)(x1 - x0); r.h = (int16_t)(y1 - y0); return r;
+}
+inline Rect rectUnion(const Rect& a, const Rect& b) {
+  if (a.empty()) return b;
+  if (b.empty()) return a;
+  return makeRect(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y,
+                  a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w,
+                  a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h);
+}
+inline Rect rectIntersect(const Rect& a, const Rect& b) {
+  Rect r = makeRect(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y,
+                    a.x + a.w < b.x + b.w ? a.x + a.w : b.x + b.w,
+                    a.y + a.h < b.y + b.h ? a.y + a.h : b.y + b.h);
+  return r.empty() ? Rect{} : r;
+}
+inline bool rectOverlaps(const Rect& a, const Rect& b) { return !rectIntersect(a, b).empty(); }